@@ -0,0 +1,64 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "allocationcounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> gAllocCount(0);
+std::atomic<uint64_t> gAllocBytes(0);
+
+void* countedAlloc(std::size_t size)
+{
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+}
+
+void* operator new(std::size_t size)
+    {return countedAlloc(size);}
+void* operator new[](std::size_t size)
+    {return countedAlloc(size);}
+void operator delete(void* ptr) noexcept
+    {std::free(ptr);}
+void operator delete[](void* ptr) noexcept
+    {std::free(ptr);}
+
+namespace tyrex {
+namespace bench {
+
+AllocationCounter::Snapshot AllocationCounter::snapshot()
+{
+    Snapshot result;
+    result.mCount = gAllocCount.load(std::memory_order_relaxed);
+    result.mBytes = gAllocBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+}
+}
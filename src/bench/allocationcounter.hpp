@@ -0,0 +1,43 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_BENCH_ALLOCATIONCOUNTER_HPP
+#define TYREX_BENCH_ALLOCATIONCOUNTER_HPP
+
+#include <cstdint>
+
+namespace tyrex {
+namespace bench {
+
+// Counts calls to the global operator new (replaced in allocationcounter.cpp).
+class AllocationCounter
+{
+public:
+    struct Snapshot
+    {
+        uint64_t mCount;
+        uint64_t mBytes;
+    };
+
+    static Snapshot snapshot();
+};
+
+}
+}
+
+#endif // TYREX_BENCH_ALLOCATIONCOUNTER_HPP
@@ -0,0 +1,243 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "benchmark.hpp"
+
+#include "allocationcounter.hpp"
+#include "encoders.hpp"
+#include "misc/hash/hash.hpp"
+#include "misc/util.hpp"
+#include "parse/compress/bzip2.hpp"
+#include "parse/compress/deflate/deflate.hpp"
+#include "parse/compress/deflate/zlib.hpp"
+#include "parse/compress/lzma/lzma.hpp"
+#include "parse/compress/lzma/lzma2.hpp"
+#include "parse/compress/lzma/xz.hpp"
+#include "parse/compress/lzw.hpp"
+#include "parse/image/png.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace tyrex {
+namespace bench {
+
+namespace {
+
+// Keeps hash results alive so that the compiler cannot drop the computation.
+volatile uint64_t gSink = 0;
+
+template <typename ParserT>
+bool decompress(ParserT& parser, const MemChunk& in, uint64_t& bytesOut)
+{
+    std::shared_ptr<data::Compress> data;
+    bool ok = parser.parse(in, data);
+    bytesOut = data ? data->decomp().chunk().size() : 0;
+    return ok;
+}
+
+MemChunk identity(const MemChunk& raw)
+    {return raw;}
+
+std::string escape(const QString& str)
+{
+    std::string result;
+    for (char c : str.toStdString())
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            result += "\\u00" + Util::hexToString(static_cast<unsigned char>(c), 2);
+        else
+            result += c;
+    }
+    return result;
+}
+
+}
+
+
+Benchmark::Benchmark(double minSeconds, unsigned int minIterations, const QStringList& formatFilter) :
+    mMinSeconds(minSeconds),
+    mMinIterations(std::max(1u, minIterations)),
+    mFormatFilter(formatFilter)
+{
+}
+
+
+const std::vector<Format>& Benchmark::formats()
+{
+    static const std::vector<Format> result = {
+        {"deflate", &Encoders::deflate, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Deflate parser(0x8000); return decompress(parser, in, out);}},
+        {"zlib", &Encoders::zlib, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Zlib parser; return decompress(parser, in, out);}},
+        {"lzma", nullptr, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Lzma parser; return decompress(parser, in, out);}},
+        {"lzma2", nullptr, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Lzma2 parser; return decompress(parser, in, out);}},
+        {"xz", nullptr, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Xz parser; return decompress(parser, in, out);}},
+        {"bzip2", nullptr, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Bzip2 parser; return decompress(parser, in, out);}},
+        {"lzw", [](const MemChunk& raw) {return Encoders::lzw(raw, true);}, [](const MemChunk& in, uint64_t& out) -> bool
+            {parse::Lzw parser(true); return decompress(parser, in, out);}},
+        {"png", nullptr, [](const MemChunk& in, uint64_t& out) -> bool
+            {
+                parse::Png parser;
+                std::shared_ptr<data::Image> data;
+                bool ok = parser.parse(in, data);
+                out = data && data->pixmap() ? 4ull * data->pixmap()->width() * data->pixmap()->height() : 0;
+                return ok;
+            }},
+        {"adler32", &identity, [](const MemChunk& in, uint64_t& out) -> bool
+            {gSink = Hasher::getAdler32(in); out = in.size(); return true;}},
+        {"crc32", &identity, [](const MemChunk& in, uint64_t& out) -> bool
+            {gSink = Hasher::getCRC32(in); out = in.size(); return true;}},
+        {"crc64", &identity, [](const MemChunk& in, uint64_t& out) -> bool
+            {gSink = Hasher::getCRC64(in); out = in.size(); return true;}},
+        {"sha256", &identity, [](const MemChunk& in, uint64_t& out) -> bool
+            {gSink = Hasher::getSha256(in).chunk().size(); out = in.size(); return true;}}};
+    return result;
+}
+
+
+void Benchmark::run(const Input& input)
+{
+    for (const Format& format : Benchmark::formats())
+    {
+        if (!mFormatFilter.isEmpty() && !mFormatFilter.contains(format.mName))
+            continue;
+
+        if (input.mFormat.isEmpty())
+        {
+            if (format.mEncode)
+                this->measure(format, input, format.mEncode(input.mChunk));
+        }
+        else if (input.mFormat == format.mName)
+            this->measure(format, input, input.mChunk);
+    }
+}
+
+void Benchmark::measure(const Format& format, const Input& input, const MemChunk& encoded)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    Result result;
+    result.mFormat = format.mName;
+    result.mInput = input.mName;
+    result.mSource = input.mSource;
+    result.mBytesIn = encoded.size();
+    result.mBytesOut = 0;
+    result.mIterations = 0;
+    result.mAllocations = 0;
+    result.mAllocatedBytes = 0;
+
+    // warm-up run, also checks that the input decodes
+    result.mOk = format.mRun(encoded, result.mBytesOut);
+
+    std::vector<double> durations;
+    double total = 0;
+    while (result.mOk && (durations.size() < mMinIterations || total < mMinSeconds) && durations.size() < 10000)
+    {
+        uint64_t bytesOut;
+        AllocationCounter::Snapshot before = AllocationCounter::snapshot();
+        Clock::time_point start = Clock::now();
+
+        format.mRun(encoded, bytesOut);
+
+        Clock::time_point stop = Clock::now();
+        AllocationCounter::Snapshot after = AllocationCounter::snapshot();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        durations.push_back(seconds);
+        total += seconds;
+        result.mAllocations = after.mCount - before.mCount;
+        result.mAllocatedBytes = after.mBytes - before.mBytes;
+    }
+
+    result.mIterations = durations.size();
+    std::sort(durations.begin(), durations.end());
+    result.mBestSeconds = durations.empty() ? 0 : durations.front();
+    result.mMedianSeconds = durations.empty() ? 0 : durations[durations.size() / 2];
+
+    mResults.push_back(result);
+}
+
+
+// Keys and their order are part of the output format : scripts compare files from different runs.
+void Benchmark::writeJson(std::ostream& os) const
+{
+    os << "{\n";
+    os << "  \"tool\": \"tyrex-bench\",\n";
+    os << "  \"version\": 1,\n";
+    os << "  \"results\": [";
+
+    for (unsigned int i = 0 ; i < mResults.size() ; ++i)
+    {
+        const Result& r = mResults[i];
+        double mbps = r.mBestSeconds > 0 ? r.mBytesOut / r.mBestSeconds / 1e6 : 0;
+
+        os << (i ? ",\n" : "\n");
+        os << "    {"
+           << "\"format\": \"" << escape(r.mFormat) << "\", "
+           << "\"input\": \"" << escape(r.mInput) << "\", "
+           << "\"source\": \"" << escape(r.mSource) << "\", "
+           << "\"ok\": " << (r.mOk ? "true" : "false") << ", "
+           << "\"bytes_in\": " << r.mBytesIn << ", "
+           << "\"bytes_out\": " << r.mBytesOut << ", "
+           << "\"iterations\": " << r.mIterations << ", "
+           << std::fixed << std::setprecision(4)
+           << "\"best_ms\": " << r.mBestSeconds * 1e3 << ", "
+           << "\"median_ms\": " << r.mMedianSeconds * 1e3 << ", "
+           << std::setprecision(3)
+           << "\"mb_per_s\": " << mbps << ", "
+           << "\"allocations\": " << r.mAllocations << ", "
+           << "\"allocated_bytes\": " << r.mAllocatedBytes
+           << "}";
+    }
+
+    os << (mResults.empty() ? "]\n" : "\n  ]\n");
+    os << "}\n";
+}
+
+void Benchmark::writeSummary(std::ostream& os) const
+{
+    os << std::left
+       << std::setw(10) << "format" << std::setw(24) << "input"
+       << std::right
+       << std::setw(12) << "bytes in" << std::setw(12) << "bytes out"
+       << std::setw(10) << "MB/s" << std::setw(12) << "allocs" << std::endl;
+
+    for (const Result& r : mResults)
+    {
+        os << std::left
+           << std::setw(10) << r.mFormat.toStdString() << std::setw(24) << r.mInput.toStdString()
+           << std::right
+           << std::setw(12) << r.mBytesIn << std::setw(12) << r.mBytesOut;
+        if (r.mOk)
+            os << std::setw(10) << std::fixed << std::setprecision(1) << (r.mBestSeconds > 0 ? r.mBytesOut / r.mBestSeconds / 1e6 : 0)
+               << std::setw(12) << r.mAllocations;
+        else
+            os << std::setw(10) << "error";
+        os << std::endl;
+    }
+}
+
+}
+}
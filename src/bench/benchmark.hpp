@@ -0,0 +1,82 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_BENCH_BENCHMARK_HPP
+#define TYREX_BENCH_BENCHMARK_HPP
+
+#include "inputs.hpp"
+#include <functional>
+#include <ostream>
+#include <QStringList>
+
+namespace tyrex {
+namespace bench {
+
+// A decoder or hash function under test.
+struct Format
+{
+    // Runs once on the input; sets the number of decoded bytes (used for throughput).
+    typedef std::function<bool(const MemChunk& in, uint64_t& bytesOut)> Function;
+
+    QString mName;
+    // Builds the input from raw bytes; empty when the input must come from the corpus.
+    std::function<MemChunk(const MemChunk& raw)> mEncode;
+    Function mRun;
+};
+
+struct Result
+{
+    QString mFormat;
+    QString mInput;
+    QString mSource;
+    uint64_t mBytesIn;
+    uint64_t mBytesOut;
+    unsigned int mIterations;
+    double mBestSeconds;
+    double mMedianSeconds;
+    // per iteration
+    uint64_t mAllocations;
+    uint64_t mAllocatedBytes;
+    bool mOk;
+};
+
+// Runs every format on every input and collects timings and allocation counts.
+class Benchmark
+{
+public:
+    Benchmark(double minSeconds, unsigned int minIterations, const QStringList& formatFilter);
+
+    static const std::vector<Format>& formats();
+
+    void run(const Input& input);
+    void writeJson(std::ostream& os) const;
+    void writeSummary(std::ostream& os) const;
+
+private:
+    void measure(const Format& format, const Input& input, const MemChunk& encoded);
+
+    double mMinSeconds;
+    unsigned int mMinIterations;
+    QStringList mFormatFilter;
+    std::vector<Result> mResults;
+};
+
+}
+}
+
+#endif // TYREX_BENCH_BENCHMARK_HPP
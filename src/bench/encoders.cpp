@@ -0,0 +1,227 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "encoders.hpp"
+
+#include "misc/hash/hash.hpp"
+#include <QByteArray>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace tyrex {
+namespace bench {
+
+namespace {
+
+// Writes codes most significant bit first, as read by parse::ForwardStream.
+class MsbWriter
+{
+public:
+    MsbWriter(MemChunk& out) :
+        mOut(out), mBuffer(0), mCount(0) {}
+
+    void put(unsigned int value, unsigned int bits)
+    {
+        for (unsigned int i = bits ; i-- > 0 ; )
+        {
+            mBuffer = (mBuffer << 1) | ((value >> i) & 0x01);
+            if (++mCount == 8)
+            {
+                mOut.appendChar(mBuffer);
+                mBuffer = 0;
+                mCount = 0;
+            }
+        }
+    }
+
+    void flush()
+    {
+        if (mCount)
+            mOut.appendChar(mBuffer << (8 - mCount));
+        mBuffer = 0;
+        mCount = 0;
+    }
+
+private:
+    MemChunk& mOut;
+    unsigned int mBuffer;
+    unsigned int mCount;
+};
+
+}
+
+
+MemChunk Encoders::zlib(const MemChunk& raw)
+{
+    QByteArray compressed = raw.size()
+            ? qCompress(raw.data(), raw.size(), 9)
+            : qCompress(QByteArray(), 9);
+
+    // qCompress prepends the uncompressed size as a 32-bit big-endian number.
+    MemChunk result;
+    result.append(compressed.constData() + 4, compressed.size() - 4);
+    return result;
+}
+
+MemChunk Encoders::deflate(const MemChunk& raw)
+{
+    // strip zlib header and adler32
+    MemChunk stream = Encoders::zlib(raw);
+    return stream.subChunk(2, stream.size() - 6);
+}
+
+MemChunk Encoders::lzw(const MemChunk& raw, bool earlyChange)
+{
+    MemChunk result;
+    MsbWriter writer(result);
+
+    // The decoder adds one dictionary entry after each code and widens codes when the next entry would not fit.
+    const unsigned int base = earlyChange ? 0x102 : 0x101;
+    std::unordered_map<unsigned int, unsigned int> dict;
+    unsigned int entries = 0;
+    unsigned int bitcount = 9;
+
+    writer.put(0x100, bitcount);
+
+    unsigned int size = raw.size();
+    if (size)
+    {
+        unsigned int prefix = raw[0];
+        for (unsigned int i = 1 ; i <= size ; ++i)
+        {
+            unsigned int key = 0;
+            if (i < size)
+            {
+                key = (prefix << 8) | raw[i];
+                auto found = dict.find(key);
+                if (found != dict.end())
+                {
+                    prefix = found->second;
+                    continue;
+                }
+            }
+
+            writer.put(prefix, bitcount);
+            if (i < size)
+                dict[key] = 0x102 + entries;
+            ++entries;
+
+            if (entries + base == 1u << bitcount)
+                ++bitcount;
+            // reset before the decoder would need 13-bit codes
+            if (entries + base + 1 == 1u << 12)
+            {
+                writer.put(0x100, bitcount);
+                dict.clear();
+                entries = 0;
+                bitcount = 9;
+            }
+
+            if (i < size)
+                prefix = raw[i];
+        }
+    }
+
+    writer.put(0x101, bitcount);
+    writer.flush();
+    return result;
+}
+
+MemChunk Encoders::png(const MemChunk& rgb, unsigned int width, unsigned int height)
+{
+    const unsigned int bpp = 3;
+    const unsigned int linesize = width * bpp;
+
+    MemChunk filtered;
+    for (unsigned int y = 0 ; y < height ; ++y)
+    {
+        unsigned int filter = y % 5;
+        filtered.appendChar(filter);
+
+        const unsigned char* cur = rgb.data() + y * linesize;
+        const unsigned char* prev = y ? cur - linesize : 0;
+
+        for (unsigned int x = 0 ; x < linesize ; ++x)
+        {
+            int a = x >= bpp ? cur[x - bpp] : 0;
+            int b = prev ? prev[x] : 0;
+            int c = prev && x >= bpp ? prev[x - bpp] : 0;
+
+            int predictor = 0;
+            switch (filter)
+            {
+            case 1:
+                predictor = a;
+                break;
+            case 2:
+                predictor = b;
+                break;
+            case 3:
+                predictor = (a + b) >> 1;
+                break;
+            case 4:
+                {
+                    int p = a + b - c;
+                    int pa = std::abs(p - a);
+                    int pb = std::abs(p - b);
+                    int pc = std::abs(p - c);
+                    predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                }
+                break;
+            }
+
+            filtered.appendChar(cur[x] - predictor);
+        }
+    }
+
+    MemChunk ihdr;
+    Encoders::appendUint32BE(ihdr, width);
+    Encoders::appendUint32BE(ihdr, height);
+    ihdr.appendChar(8); // bit depth
+    ihdr.appendChar(2); // truecolor
+    ihdr.appendChar(0); // compression
+    ihdr.appendChar(0); // filter
+    ihdr.appendChar(0); // interlace
+
+    MemChunk result;
+    result.append(std::string("\x89PNG\r\n\x1A\n", 8));
+    Encoders::appendPngChunk(result, "IHDR", ihdr);
+    Encoders::appendPngChunk(result, "IDAT", Encoders::zlib(filtered));
+    Encoders::appendPngChunk(result, "IEND", MemChunk());
+    return result;
+}
+
+
+void Encoders::appendPngChunk(MemChunk& png, const std::string& type, const MemChunk& content)
+{
+    MemChunk crcChunk(type);
+    crcChunk.append(content);
+
+    Encoders::appendUint32BE(png, content.size());
+    png.append(crcChunk);
+    Encoders::appendUint32BE(png, Hasher::getCRC32(crcChunk));
+}
+
+void Encoders::appendUint32BE(MemChunk& chunk, unsigned int value)
+{
+    for (unsigned int i = 4 ; i-- > 0 ; )
+        chunk.appendChar(value >> (8 * i));
+}
+
+}
+}
@@ -0,0 +1,47 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_BENCH_ENCODERS_HPP
+#define TYREX_BENCH_ENCODERS_HPP
+
+#include "misc/memchunk.hpp"
+
+namespace tyrex {
+namespace bench {
+
+// Minimal encoders producing valid input for the decoders under test.
+// Formats without an encoder here (lzma, lzma2, xz, bzip2) come from the corpus.
+class Encoders
+{
+public:
+    static MemChunk zlib(const MemChunk& raw);
+    static MemChunk deflate(const MemChunk& raw);
+    // MSB-first LZW with clear and end-of-data codes, as read by parse::Lzw.
+    static MemChunk lzw(const MemChunk& raw, bool earlyChange);
+    // 8-bit RGB image, non-interlaced, cycling through the five filter types.
+    static MemChunk png(const MemChunk& rgb, unsigned int width, unsigned int height);
+
+private:
+    static void appendPngChunk(MemChunk& png, const std::string& type, const MemChunk& content);
+    static void appendUint32BE(MemChunk& chunk, unsigned int value);
+};
+
+}
+}
+
+#endif // TYREX_BENCH_ENCODERS_HPP
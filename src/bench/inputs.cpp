@@ -0,0 +1,239 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "inputs.hpp"
+
+#include "encoders.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+
+namespace tyrex {
+namespace bench {
+
+namespace {
+
+const std::vector<std::pair<QString, QString> >& extensions()
+{
+    static const std::vector<std::pair<QString, QString> > result = {
+        {"deflate", "deflate"},
+        {"zlib", "zlib"},
+        {"lzma", "lzma"},
+        {"lzma2", "lzma2"},
+        {"xz", "xz"},
+        {"bz2", "bzip2"},
+        {"lzw", "lzw"},
+        {"png", "png"}};
+    return result;
+}
+
+}
+
+
+std::vector<Input> Inputs::synthetic(unsigned int size)
+{
+    std::vector<Input> result;
+    result.push_back(Inputs::makeInput("text", "synthetic", "", Inputs::text(size)));
+    result.push_back(Inputs::makeInput("binary", "synthetic", "", Inputs::binary(size)));
+    result.push_back(Inputs::makeInput("random", "synthetic", "", Inputs::random(size)));
+    result.push_back(Inputs::makeInput("repetitive", "synthetic", "", Inputs::repetitive(size)));
+
+    unsigned int side = std::max(1u, static_cast<unsigned int>(std::sqrt(size / 3.0)));
+    result.push_back(Inputs::makeInput("image", "synthetic", "png", Encoders::png(Inputs::image(side, side), side, side)));
+
+    return result;
+}
+
+std::vector<Input> Inputs::corpus(const QString& directory)
+{
+    std::vector<Input> result;
+
+    QFileInfoList files = QDir(directory).entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo& info : files)
+    {
+        QFile file(info.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        QByteArray content = file.readAll();
+        MemChunk chunk;
+        chunk.append(content.constData(), content.size());
+
+        QString suffix = info.suffix().toLower();
+        QString format;
+        for (const auto& ext : extensions())
+            if (ext.first == suffix)
+                format = ext.second;
+
+        QString name = format.isEmpty() ? info.fileName() : info.completeBaseName();
+        result.push_back(Inputs::makeInput(name, "corpus", format, chunk));
+    }
+
+    return result;
+}
+
+bool Inputs::dump(const std::vector<Input>& inputs, const QString& directory)
+{
+    QDir dir(directory);
+    if (!dir.mkpath("."))
+        return false;
+
+    for (const Input& input : inputs)
+    {
+        QString suffix = "bin";
+        for (const auto& ext : extensions())
+            if (ext.second == input.mFormat)
+                suffix = ext.first;
+
+        QFile file(dir.filePath(input.mName + "." + suffix));
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+        if (input.mChunk.size())
+            file.write(reinterpret_cast<const char*>(input.mChunk.data()), input.mChunk.size());
+    }
+
+    return true;
+}
+
+
+// Pseudo-English : words drawn with a skewed distribution, punctuation and line breaks.
+MemChunk Inputs::text(unsigned int size)
+{
+    static const std::vector<std::string> words = {
+        "the", "of", "and", "to", "in", "a", "is", "that", "for", "it",
+        "as", "was", "with", "be", "by", "on", "not", "he", "this", "are",
+        "file", "data", "stream", "block", "header", "decoder", "format", "archive", "image", "table",
+        "compression", "dictionary", "window", "length", "distance", "symbol", "entropy", "huffman", "literal", "checksum"};
+
+    Random random(1);
+    MemChunk result;
+    unsigned int column = 0;
+
+    while (result.size() < size)
+    {
+        // squaring favors the first (shortest, most frequent) words
+        unsigned int r = random.below(words.size());
+        const std::string& word = words[r * r / words.size()];
+        result.append(word);
+        column += word.size() + 1;
+
+        unsigned int punct = random.below(16);
+        if (punct == 0)
+            result.appendChar('.');
+        else if (punct == 1)
+            result.appendChar(',');
+
+        if (column > 72)
+        {
+            result.appendChar('\n');
+            column = 0;
+        }
+        else
+            result.appendChar(' ');
+    }
+
+    return result.subChunk(0, size);
+}
+
+// Structured records, similar to tables found in executables : increasing offsets, small integers, flags and padding.
+MemChunk Inputs::binary(unsigned int size)
+{
+    Random random(2);
+    MemChunk result;
+    unsigned int offset = 0x1000;
+
+    while (result.size() < size)
+    {
+        offset += 4 * random.below(64);
+        unsigned int length = random.below(0x400);
+        unsigned int flags = 1 << random.below(4);
+
+        for (unsigned int value : {offset, length, flags})
+            for (unsigned int i = 0 ; i < 4 ; ++i)
+                result.appendChar(value >> (8 * i));
+        result.append(static_cast<unsigned char>(0), 4);
+    }
+
+    return result.subChunk(0, size);
+}
+
+MemChunk Inputs::random(unsigned int size)
+{
+    Random random(3);
+    MemChunk result;
+
+    for (unsigned int i = 0 ; i < size ; ++i)
+        result.appendChar(random.next() >> 56);
+
+    return result;
+}
+
+// A short pattern repeated with rare mutations : long matches, tiny output.
+MemChunk Inputs::repetitive(unsigned int size)
+{
+    static const std::string pattern = "tyrex-bench:0123456789ABCDEF;";
+
+    Random random(4);
+    MemChunk result;
+
+    for (unsigned int i = 0 ; i < size ; ++i)
+    {
+        if (random.below(4096) == 0)
+            result.appendChar(random.next() >> 56);
+        else
+            result.appendChar(pattern[i % pattern.size()]);
+    }
+
+    return result;
+}
+
+// RGB gradients with a little noise, so that every PNG filter has work to do.
+MemChunk Inputs::image(unsigned int width, unsigned int height)
+{
+    Random random(5);
+    MemChunk result;
+
+    for (unsigned int y = 0 ; y < height ; ++y)
+    {
+        for (unsigned int x = 0 ; x < width ; ++x)
+        {
+            unsigned int noise = random.below(8);
+            result.appendChar((x * 255 / width + noise) & 0xFF);
+            result.appendChar((y * 255 / height + noise) & 0xFF);
+            result.appendChar(((x ^ y) + noise) & 0xFF);
+        }
+    }
+
+    return result;
+}
+
+
+Input Inputs::makeInput(const QString& name, const QString& source, const QString& format, const MemChunk& chunk)
+{
+    Input result;
+    result.mName = name;
+    result.mSource = source;
+    result.mFormat = format;
+    result.mChunk = chunk;
+    return result;
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_BENCH_INPUTS_HPP
+#define TYREX_BENCH_INPUTS_HPP
+
+#include "misc/memchunk.hpp"
+#include <QString>
+
+namespace tyrex {
+namespace bench {
+
+// A benchmark input : either raw bytes, or bytes already encoded in some format.
+struct Input
+{
+    QString mName;
+    QString mSource;
+    // empty for raw inputs
+    QString mFormat;
+    MemChunk mChunk;
+};
+
+// Reproducible inputs : synthetic generators use a fixed seed, so that results are comparable between runs and machines.
+class Inputs
+{
+public:
+    static std::vector<Input> synthetic(unsigned int size);
+    // Files are classified by extension (.deflate, .zlib, .lzma, .lzma2, .xz, .bz2, .lzw, .png), other files are raw inputs.
+    static std::vector<Input> corpus(const QString& directory);
+    static bool dump(const std::vector<Input>& inputs, const QString& directory);
+
+    static MemChunk text(unsigned int size);
+    static MemChunk binary(unsigned int size);
+    static MemChunk random(unsigned int size);
+    static MemChunk repetitive(unsigned int size);
+    static MemChunk image(unsigned int width, unsigned int height);
+
+private:
+    static Input makeInput(const QString& name, const QString& source, const QString& format, const MemChunk& chunk);
+};
+
+// xorshift64* generator, fixed seed.
+class Random
+{
+public:
+    inline Random(uint64_t seed = 0x9E3779B97F4A7C15ull);
+    inline uint64_t next();
+    inline unsigned int below(unsigned int bound);
+
+private:
+    uint64_t mState;
+};
+
+inline Random::Random(uint64_t seed) :
+    mState(seed) {}
+
+inline uint64_t Random::next()
+{
+    mState ^= mState >> 12;
+    mState ^= mState << 25;
+    mState ^= mState >> 27;
+    return mState * 0x2545F4914F6CDD1Dull;
+}
+
+inline unsigned int Random::below(unsigned int bound)
+    {return (this->next() >> 32) % bound;}
+
+}
+}
+
+#endif // TYREX_BENCH_INPUTS_HPP
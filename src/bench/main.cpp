@@ -0,0 +1,128 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include <QApplication>
+#include <fstream>
+#include <iostream>
+
+#include "benchmark.hpp"
+#include "graphic/mainwindow.hpp"
+
+namespace {
+
+void usage(const char* program)
+{
+    std::cerr << "usage: " << program << " [options]" << std::endl
+              << "  --size BYTES          size of synthetic inputs (default 1048576)" << std::endl
+              << "  --corpus DIR          also run on the files of DIR" << std::endl
+              << "  --no-synthetic        skip synthetic inputs" << std::endl
+              << "  --format NAME         only run this format (repeatable)" << std::endl
+              << "  --min-time SECONDS    minimal measuring time per case (default 0.5)" << std::endl
+              << "  --min-iterations N    minimal iterations per case (default 3)" << std::endl
+              << "  --output FILE         write JSON results to FILE instead of stdout" << std::endl
+              << "  --dump-inputs DIR     write synthetic inputs to DIR and exit" << std::endl
+              << "formats:";
+    for (const tyrex::bench::Format& format : tyrex::bench::Benchmark::formats())
+        std::cerr << " " << format.mName.toStdString();
+    std::cerr << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+#if QT_VERSION >= 0x050000
+    // no window is ever shown
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+#endif
+    QApplication app(argc, argv);
+
+    // Parsers report errors to the console of the main window.
+    tyrex::graphic::MainWindow mainWindow;
+
+    unsigned int size = 1 << 20;
+    QString corpus;
+    bool synthetic = true;
+    QStringList formats;
+    double minSeconds = 0.5;
+    unsigned int minIterations = 3;
+    QString output;
+    QString dumpDir;
+
+    QStringList args = app.arguments();
+    for (int i = 1 ; i < args.size() ; ++i)
+    {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "--size" && hasValue)
+            size = args[++i].toUInt();
+        else if (arg == "--corpus" && hasValue)
+            corpus = args[++i];
+        else if (arg == "--no-synthetic")
+            synthetic = false;
+        else if (arg == "--format" && hasValue)
+            formats.append(args[++i]);
+        else if (arg == "--min-time" && hasValue)
+            minSeconds = args[++i].toDouble();
+        else if (arg == "--min-iterations" && hasValue)
+            minIterations = args[++i].toUInt();
+        else if (arg == "--output" && hasValue)
+            output = args[++i];
+        else if (arg == "--dump-inputs" && hasValue)
+            dumpDir = args[++i];
+        else
+        {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (!dumpDir.isEmpty())
+        return tyrex::bench::Inputs::dump(tyrex::bench::Inputs::synthetic(size), dumpDir) ? 0 : 1;
+
+    std::vector<tyrex::bench::Input> inputs;
+    if (synthetic)
+        inputs = tyrex::bench::Inputs::synthetic(size);
+    if (!corpus.isEmpty())
+    {
+        std::vector<tyrex::bench::Input> files = tyrex::bench::Inputs::corpus(corpus);
+        inputs.insert(inputs.end(), files.begin(), files.end());
+    }
+
+    tyrex::bench::Benchmark benchmark(minSeconds, minIterations, formats);
+    for (const tyrex::bench::Input& input : inputs)
+        benchmark.run(input);
+
+    benchmark.writeSummary(std::cerr);
+    if (output.isEmpty())
+        benchmark.writeJson(std::cout);
+    else
+    {
+        std::ofstream ofs(output.toStdString());
+        if (!ofs)
+        {
+            std::cerr << "cannot write " << output.toStdString() << std::endl;
+            return 1;
+        }
+        benchmark.writeJson(ofs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#!/bin/sh
+#   Tyrex - the versatile file decoder.
+#   Copyright (C) 2014 - 2015  G. Endignoux
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+
+# Builds a benchmark corpus : the synthetic inputs plus any extra files,
+# each compressed with the reference tools for formats that tyrex-bench cannot encode itself.
+#
+# usage: make-corpus.sh CORPUS_DIR [EXTRA_FILE...]
+
+set -e
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 CORPUS_DIR [EXTRA_FILE...]" >&2
+    exit 1
+fi
+
+BENCH="${TYREX_BENCH:-./tyrex-bench}"
+CORPUS="$1"
+shift
+
+"$BENCH" --dump-inputs "$CORPUS"
+for f in "$@"; do
+    cp "$f" "$CORPUS/"
+done
+
+for f in "$CORPUS"/*; do
+    case "$f" in
+        *.xz|*.lzma|*.lzma2|*.bz2|*.png|*.deflate|*.zlib|*.lzw) continue ;;
+    esac
+    xz -9 -k -c "$f" > "$f.xz"
+    xz -9 -k -c --format=lzma "$f" > "$f.lzma"
+    xz -9 -k -c --format=raw --lzma2 "$f" > "$f.lzma2"
+    bzip2 -9 -k -c "$f" > "$f.bz2"
+done
@@ -20,39 +20,59 @@
 
 #include "graphic/view/archiveview.hpp"
 #include "graphic/view/hexview.hpp"
+#include "misc/arena.hpp"
+#include "misc/profiler.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 namespace tyrex {
 namespace data {
 
-Archive::Archive(const MemChunk& srcChunk, const Colorizer& srcColorizer, const FileInfoFilter& fileInfoFilter, const std::vector<File>& files) :
+Archive::Archive(const MemChunk& srcChunk, const Colorizer& srcColorizer, const FileInfoFilter& fileInfoFilter, const ArchiveIndex& index, const std::vector<File>& files) :
     mSource(srcChunk, srcColorizer),
     mFileInfoFilter(fileInfoFilter),
+    mIndex(index),
     mFiles(files),
     mTreeFiles("Files")
 {
+    if (Profiler::enabled())
+        for (auto& file : mFiles)
+            Profiler::count(Profiler::bytesOut, file.mChunk.size());
+
+    Profiler::Scope scope("archive tree");
     this->makeTreeFiles();
 }
 
 
 void Archive::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", mSource.view());
-    mFirstView = this->view();
-    tree.appendLeaf("Archive", mFirstView);
+    tree.appendView("Source", [this] {return mSource.view();});
+    mFirstView = tree.appendView("Archive", [this] {return this->view();});
 
     this->doAppendToTree(tree, mTreeFiles);
 }
 
 std::shared_ptr<graphic::View> Archive::view() const
 {
-    return std::make_shared<graphic::ArchiveView>(mFileInfoFilter, mTreeFiles);
+    return std::make_shared<graphic::ArchiveView>(mFileInfoFilter, mIndex, mTreeFiles);
+}
+
+std::vector<Data::Output> Archive::outputs() const
+{
+    std::vector<Output> result;
+    result.reserve(mFiles.size());
+    for (const File& file : mFiles)
+        result.push_back({mIndex.string(file.mRow, FileInfo::fileName), file.mChunk});
+    return result;
 }
 
 
 void Archive::doAppendToTree(graphic::TreeNodeModel& tree, const TreeLeaf<File>& file) const
 {
-    std::shared_ptr<graphic::View> view = std::make_shared<graphic::HexView>(file.mContent.mChunk);
-    tree.appendLeaf(file.mTitle, view);
+    MemChunk chunk = file.mContent.mChunk;
+    tree.appendView(file.mTitle, [chunk] {return std::make_shared<graphic::HexView>(chunk);});
 }
 
 void Archive::doAppendToTree(graphic::TreeNodeModel& tree, const Tree<File>& folder) const
@@ -68,38 +88,53 @@ void Archive::doAppendToTree(graphic::TreeNodeModel& tree, const Tree<File>& fol
 }
 
 
+bool Archive::FolderKey::operator==(const FolderKey& other) const
+{
+    return mParent == other.mParent && mLength == other.mLength && std::equal(mName, mName + mLength, other.mName);
+}
+
+std::size_t Archive::FolderKeyHash::operator()(const FolderKey& key) const
+{
+    return std::hash<const void*>()(key.mParent) ^ StringPool::hash(key.mName, key.mLength);
+}
+
+
+// Names are split in place, in the string pool of the index : only the titles of the nodes are copied.
 void Archive::makeTreeFiles()
 {
-    QMap<QString, Tree<File>*> folders;
+    std::unordered_map<FolderKey, Tree<File>*, FolderKeyHash> folders;
 
     for (auto& file : mFiles)
     {
-        QString name = file.mInfo[FileInfo::fileName];
+        unsigned int length;
+        const QChar* name = mIndex.stringData(file.mRow, FileInfo::fileName, length);
+        const QChar* end = name + length;
         Tree<File>* folder = &mTreeFiles;
 
-        for (int pos = -1 ; ; )
+        for (const QChar* begin = name ; ; )
         {
-            int nextpos = name.indexOf("/", pos + 1);
+            const QChar* next = std::find(begin, end, QChar('/'));
 
-            if (nextpos >= 0)
+            if (next != end)
             {
-                QString key = name.left(nextpos + 1);
+                FolderKey key = {folder, begin, static_cast<unsigned int>(next - begin)};
+                auto found = folders.find(key);
 
-                if (folders.contains(key))
-                    folder = folders[key];
+                if (found != folders.end())
+                    folder = found->second;
                 else
                 {
-                    std::shared_ptr<Tree<File> > tmp = std::make_shared<Tree<File> >(name.mid(pos + 1, nextpos - pos - 1));
+                    std::shared_ptr<Tree<File> > tmp = std::allocate_shared<Tree<File> >(ArenaAllocator<Tree<File> >(), QString(begin, key.mLength));
                     folder->appendTree(tmp);
                     folder = tmp.get();
                     folders[key] = folder;
                 }
 
-                pos = nextpos;
+                begin = next + 1;
             }
             else
             {
-                folder->appendLeaf(name.mid(pos + 1), file);
+                folder->appendLeaf(QString(begin, end - begin), file);
                 break;
             }
         }
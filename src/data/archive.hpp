@@ -19,6 +19,7 @@
 #ifndef TYREX_DATA_ARCHIVE_HPP
 #define TYREX_DATA_ARCHIVE_HPP
 
+#include "archiveindex.hpp"
 #include "bytesequence.hpp"
 #include "file.hpp"
 #include "misc/tree.tpl"
@@ -29,11 +30,33 @@ namespace data {
 class Archive : public Data
 {
 public:
-    Archive(const MemChunk& srcChunk, const Colorizer& srcColorizer, const FileInfoFilter& fileInfoFilter, const std::vector<File>& files);
+    Archive(const MemChunk& srcChunk, const Colorizer& srcColorizer, const FileInfoFilter& fileInfoFilter, const ArchiveIndex& index, const std::vector<File>& files);
 
     std::shared_ptr<graphic::View> view() const;
 
+    inline const ByteSequence& source() const;
+    inline const FileInfoFilter& fileInfoFilter() const;
+    inline const ArchiveIndex& index() const;
+    inline const std::vector<File>& files() const;
+
+    std::vector<Output> outputs() const;
+
 private:
+    // a folder is identified by its parent and its name
+    struct FolderKey
+    {
+        const Tree<File>* mParent;
+        const QChar* mName;
+        unsigned int mLength;
+
+        bool operator==(const FolderKey& other) const;
+    };
+
+    struct FolderKeyHash
+    {
+        std::size_t operator()(const FolderKey& key) const;
+    };
+
     void makeTreeFiles();
 
     void doAppendToTree(graphic::TreeNodeModel& tree) const;
@@ -42,10 +65,20 @@ private:
 
     ByteSequence mSource;
     FileInfoFilter mFileInfoFilter;
+    ArchiveIndex mIndex;
     std::vector<File> mFiles;
     Tree<File> mTreeFiles;
 };
 
+inline const ByteSequence& Archive::source() const
+    {return mSource;}
+inline const FileInfoFilter& Archive::fileInfoFilter() const
+    {return mFileInfoFilter;}
+inline const ArchiveIndex& Archive::index() const
+    {return mIndex;}
+inline const std::vector<File>& Archive::files() const
+    {return mFiles;}
+
 }
 }
 
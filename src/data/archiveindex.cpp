@@ -0,0 +1,355 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "archiveindex.hpp"
+
+#include "misc/hash/hash.hpp"
+#include "misc/util.hpp"
+
+#include <QDateTime>
+#include <algorithm>
+
+namespace tyrex {
+namespace data {
+
+template <typename T>
+static void writeVector(QDataStream& stream, const std::vector<T>& vector)
+{
+    stream << static_cast<quint32>(vector.size());
+    stream.writeRawData(reinterpret_cast<const char*>(vector.data()), vector.size() * sizeof(T));
+}
+
+template <typename T>
+static bool readVector(QDataStream& stream, std::vector<T>& vector)
+{
+    quint32 size;
+    stream >> size;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    vector.resize(size);
+    int length = size * sizeof(T);
+    return stream.readRawData(reinterpret_cast<char*>(vector.data()), length) == length;
+}
+
+
+StringPool::StringPool() :
+    mOffsets(2, 0),
+    mHashes(1, 0)
+{
+    this->rehash(16);
+}
+
+
+unsigned int StringPool::intern(const QString& str)
+{
+    if (str.isEmpty())
+        return 0;
+
+    const QChar* data = str.constData();
+    unsigned int length = str.size();
+    unsigned int h = StringPool::hash(data, length);
+
+    unsigned int mask = mBuckets.size() - 1;
+    unsigned int i = h & mask;
+    for ( ; mBuckets[i] ; i = (i + 1) & mask)
+    {
+        unsigned int id = mBuckets[i] - 1;
+        if (mHashes[id] == h && this->equals(id, data, length))
+            return id;
+    }
+
+    unsigned int id = mHashes.size();
+    mData.append(str);
+    mOffsets.push_back(mData.size());
+    mHashes.push_back(h);
+
+    // keep the table at most half full
+    if (2 * mHashes.size() > mBuckets.size())
+        this->rehash(2 * mBuckets.size());
+    else
+        mBuckets[i] = id + 1;
+
+    return id;
+}
+
+unsigned int StringPool::hash(const QChar* str, unsigned int length)
+{
+    return Hasher::getFNV1a(reinterpret_cast<const ushort*>(str), length);
+}
+
+bool StringPool::equals(unsigned int id, const QChar* str, unsigned int length) const
+{
+    unsigned int start = mOffsets[id];
+    if (mOffsets[id + 1] - start != length)
+        return false;
+    return std::equal(str, str + length, mData.constData() + start);
+}
+
+void StringPool::write(QDataStream& stream) const
+{
+    stream << mData;
+    writeVector(stream, mOffsets);
+}
+
+bool StringPool::read(QDataStream& stream)
+{
+    stream >> mData;
+    if (!readVector(stream, mOffsets) || mOffsets.size() < 2 || mOffsets.back() != static_cast<unsigned int>(mData.size()))
+        return false;
+    for (unsigned int i = 1 ; i < mOffsets.size() ; ++i)
+        if (mOffsets[i] < mOffsets[i - 1])
+            return false;
+
+    unsigned int count = mOffsets.size() - 1;
+    mHashes.assign(1, 0);
+    for (unsigned int id = 1 ; id < count ; ++id)
+        mHashes.push_back(StringPool::hash(this->data(id), this->length(id)));
+
+    unsigned int bucketCount = 16;
+    while (bucketCount < 2 * count)
+        bucketCount <<= 1;
+    this->rehash(bucketCount);
+
+    return true;
+}
+
+void StringPool::rehash(unsigned int bucketCount)
+{
+    mBuckets.assign(bucketCount, 0);
+
+    unsigned int mask = bucketCount - 1;
+    for (unsigned int id = 1 ; id < mHashes.size() ; ++id)
+    {
+        unsigned int i = mHashes[id] & mask;
+        while (mBuckets[i])
+            i = (i + 1) & mask;
+        mBuckets[i] = id + 1;
+    }
+}
+
+
+ArchiveIndex::ArchiveIndex(TimeFormat timeFormat) :
+    mTimeFormat(timeFormat),
+    mRowCount(0)
+{
+}
+
+
+unsigned int ArchiveIndex::appendRow()
+{
+    return mRowCount++;
+}
+
+void ArchiveIndex::setNumber(unsigned int row, FileInfo::Info info, uint64_t value)
+{
+    switch (ArchiveIndex::columnType(info))
+    {
+    case column16:
+        ArchiveIndex::store(mColumns16[info], row, value);
+        break;
+    case column32:
+        ArchiveIndex::store(mColumns32[info], row, value);
+        break;
+    case column64:
+        ArchiveIndex::store(mColumns64[info], row, value);
+        break;
+    case columnString:
+        this->setString(row, info, QString::number(static_cast<qulonglong>(value)));
+        break;
+    }
+}
+
+void ArchiveIndex::setString(unsigned int row, FileInfo::Info info, const QString& value)
+{
+    if (ArchiveIndex::columnType(info) == columnString)
+        ArchiveIndex::store(mColumns32[info], row, mStrings.intern(value));
+}
+
+
+uint64_t ArchiveIndex::number(unsigned int row, FileInfo::Info info) const
+{
+    switch (ArchiveIndex::columnType(info))
+    {
+    case column16:
+        return ArchiveIndex::fetch(mColumns16[info], row);
+    case column32:
+        return ArchiveIndex::fetch(mColumns32[info], row);
+    case column64:
+        return ArchiveIndex::fetch(mColumns64[info], row);
+    case columnString:
+        break;
+    }
+    return 0;
+}
+
+QString ArchiveIndex::string(unsigned int row, FileInfo::Info info) const
+{
+    if (ArchiveIndex::columnType(info) != columnString)
+        return QString();
+    return mStrings.string(ArchiveIndex::fetch(mColumns32[info], row));
+}
+
+const QChar* ArchiveIndex::stringData(unsigned int row, FileInfo::Info info, unsigned int& length) const
+{
+    unsigned int id = 0;
+    if (ArchiveIndex::columnType(info) == columnString)
+        id = ArchiveIndex::fetch(mColumns32[info], row);
+
+    length = mStrings.length(id);
+    return mStrings.data(id);
+}
+
+QString ArchiveIndex::text(unsigned int row, FileInfo::Info info) const
+{
+    if (this->isEmpty(info))
+        return QString();
+    if (ArchiveIndex::isString(info))
+        return this->string(row, info);
+
+    uint64_t value = this->number(row, info);
+
+    switch (info)
+    {
+    case FileInfo::modDateTime:
+        {
+            QDateTime dateTime;
+            if (mTimeFormat == dosTime)
+            {
+                unsigned int date = value >> 16;
+                unsigned int time = value & 0xFFFF;
+                dateTime = QDateTime(QDate(1980 + (date >> 9), (date >> 5) & 0xF, date & 0x1F), QTime(time >> 11, (time >> 5) & 0x3F, (time & 0x1F) << 1));
+            }
+            else
+                dateTime = QDateTime(QDate(1970, 1, 1), QTime(0, 0)).addSecs(static_cast<qint64>(value));
+            return dateTime.toString("dd MMM yyyy  hh:mm:ss");
+        }
+    case FileInfo::crc32:
+        return QString::fromStdString(Util::hexToString(value, 8));
+    case FileInfo::compressionMethod:
+        switch (value)
+        {
+        case 0:
+            return "Uncompressed";
+        case 8:
+            return "Deflate";
+        default:
+            return "Unsupported";
+        }
+    case FileInfo::fileMode:
+        return QString::number(static_cast<qulonglong>(value), 8);
+    case FileInfo::devMajorMinor:
+        if (!value)
+            return QString();
+        return QString::number(static_cast<qulonglong>(value >> 32)) + "," + QString::number(static_cast<qulonglong>(value & 0xFFFFFFFF));
+    default:
+        return QString::number(static_cast<qulonglong>(value));
+    }
+}
+
+bool ArchiveIndex::lessThan(unsigned int row1, unsigned int row2, FileInfo::Info info) const
+{
+    if (ArchiveIndex::isString(info))
+        return this->string(row1, info) < this->string(row2, info);
+    return this->number(row1, info) < this->number(row2, info);
+}
+
+
+void ArchiveIndex::write(QDataStream& stream) const
+{
+    stream << static_cast<quint8>(mTimeFormat) << mRowCount;
+    for (unsigned int i = 0 ; i < FileInfo::infoCount ; ++i)
+    {
+        writeVector(stream, mColumns16[i]);
+        writeVector(stream, mColumns32[i]);
+        writeVector(stream, mColumns64[i]);
+    }
+    mStrings.write(stream);
+}
+
+bool ArchiveIndex::read(QDataStream& stream)
+{
+    quint8 timeFormat;
+    stream >> timeFormat >> mRowCount;
+    mTimeFormat = timeFormat == unixTime ? unixTime : dosTime;
+
+    for (unsigned int i = 0 ; i < FileInfo::infoCount ; ++i)
+        if (!readVector(stream, mColumns16[i]) || !readVector(stream, mColumns32[i]) || !readVector(stream, mColumns64[i]))
+            return false;
+
+    if (!mStrings.read(stream))
+        return false;
+
+    // string ids must exist in the pool
+    for (unsigned int i = 0 ; i < FileInfo::infoCount ; ++i)
+        if (ArchiveIndex::isString(static_cast<FileInfo::Info>(i)))
+            for (uint32_t id : mColumns32[i])
+                if (id >= mStrings.size())
+                    return false;
+
+    return true;
+}
+
+
+bool ArchiveIndex::isString(FileInfo::Info info)
+{
+    return ArchiveIndex::columnType(info) == columnString;
+}
+
+ArchiveIndex::ColumnType ArchiveIndex::columnType(FileInfo::Info info)
+{
+    switch (info)
+    {
+    case FileInfo::versionMadeBy:
+    case FileInfo::versionNeeded:
+    case FileInfo::compressionMethod:
+    case FileInfo::diskNumber:
+    case FileInfo::internalAttributes:
+        return column16;
+    case FileInfo::modDateTime:
+    case FileInfo::compressedSize:
+    case FileInfo::size:
+    case FileInfo::devMajorMinor:
+    case FileInfo::offset:
+        return column64;
+    case FileInfo::fileName:
+    case FileInfo::fileComment:
+    case FileInfo::userName:
+    case FileInfo::groupName:
+    case FileInfo::linkName:
+        return columnString;
+    default:
+        return column32;
+    }
+}
+
+bool ArchiveIndex::isEmpty(FileInfo::Info info) const
+{
+    switch (ArchiveIndex::columnType(info))
+    {
+    case column16:
+        return mColumns16[info].empty();
+    case column64:
+        return mColumns64[info].empty();
+    default:
+        return mColumns32[info].empty();
+    }
+}
+
+}
+}
@@ -0,0 +1,148 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_DATA_ARCHIVEINDEX_HPP
+#define TYREX_DATA_ARCHIVEINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include <QDataStream>
+#include <QString>
+#include "fileinfo.hpp"
+
+namespace tyrex {
+namespace data {
+
+// Strings stored back to back in a single buffer, each distinct string once.
+// Id 0 is the empty string.
+class StringPool
+{
+public:
+    StringPool();
+
+    unsigned int intern(const QString& str);
+    inline QString string(unsigned int id) const;
+    // view into the pool, valid until the next intern()
+    inline const QChar* data(unsigned int id) const;
+    inline unsigned int length(unsigned int id) const;
+    inline unsigned int size() const;
+
+    static unsigned int hash(const QChar* str, unsigned int length);
+
+    void write(QDataStream& stream) const;
+    bool read(QDataStream& stream);
+
+private:
+    bool equals(unsigned int id, const QChar* str, unsigned int length) const;
+    void rehash(unsigned int bucketCount);
+
+    QString mData;
+    // string i spans [mOffsets[i], mOffsets[i + 1])
+    std::vector<unsigned int> mOffsets;
+    std::vector<unsigned int> mHashes;
+    // open addressing, ids + 1 (0 is an empty bucket)
+    std::vector<unsigned int> mBuckets;
+};
+
+// Metadata of the members of an archive, one row per member and one typed column per FileInfo::Info.
+// Values are stored raw and only formatted by text(), when a view displays them.
+// A column takes no memory until a value is set in it.
+// FileInfo::devMajorMinor is stored as (major << 32) | minor.
+class ArchiveIndex
+{
+public:
+    // encoding of the FileInfo::modDateTime column
+    enum TimeFormat {
+        dosTime,    // (date << 16) | time, as in zip headers
+        unixTime    // seconds since 1970
+    };
+
+    ArchiveIndex(TimeFormat timeFormat);
+
+    unsigned int appendRow();
+    inline unsigned int rowCount() const;
+
+    void setNumber(unsigned int row, FileInfo::Info info, uint64_t value);
+    void setString(unsigned int row, FileInfo::Info info, const QString& value);
+
+    uint64_t number(unsigned int row, FileInfo::Info info) const;
+    QString string(unsigned int row, FileInfo::Info info) const;
+    // same without copy, valid while the index is not modified
+    const QChar* stringData(unsigned int row, FileInfo::Info info, unsigned int& length) const;
+    QString text(unsigned int row, FileInfo::Info info) const;
+    bool lessThan(unsigned int row1, unsigned int row2, FileInfo::Info info) const;
+
+    static bool isString(FileInfo::Info info);
+
+    // columns are saved in the byte order of the machine, for the local result cache only
+    void write(QDataStream& stream) const;
+    bool read(QDataStream& stream);
+
+private:
+    enum ColumnType {
+        column16,
+        column32,
+        column64,
+        columnString
+    };
+
+    static ColumnType columnType(FileInfo::Info info);
+    bool isEmpty(FileInfo::Info info) const;
+
+    template <typename T>
+    static inline void store(std::vector<T>& column, unsigned int row, uint64_t value);
+    template <typename T>
+    static inline uint64_t fetch(const std::vector<T>& column, unsigned int row);
+
+    TimeFormat mTimeFormat;
+    unsigned int mRowCount;
+
+    std::vector<uint16_t> mColumns16[FileInfo::infoCount];
+    std::vector<uint32_t> mColumns32[FileInfo::infoCount];
+    std::vector<uint64_t> mColumns64[FileInfo::infoCount];
+    StringPool mStrings;
+};
+
+inline QString StringPool::string(unsigned int id) const
+    {return mData.mid(mOffsets[id], mOffsets[id + 1] - mOffsets[id]);}
+inline const QChar* StringPool::data(unsigned int id) const
+    {return mData.constData() + mOffsets[id];}
+inline unsigned int StringPool::length(unsigned int id) const
+    {return mOffsets[id + 1] - mOffsets[id];}
+inline unsigned int StringPool::size() const
+    {return mHashes.size();}
+
+inline unsigned int ArchiveIndex::rowCount() const
+    {return mRowCount;}
+
+template <typename T>
+inline void ArchiveIndex::store(std::vector<T>& column, unsigned int row, uint64_t value)
+{
+    if (row >= column.size())
+        column.resize(row + 1);
+    column[row] = static_cast<T>(value);
+}
+
+template <typename T>
+inline uint64_t ArchiveIndex::fetch(const std::vector<T>& column, unsigned int row)
+    {return row < column.size() ? column[row] : 0;}
+
+}
+}
+
+#endif // TYREX_DATA_ARCHIVEINDEX_HPP
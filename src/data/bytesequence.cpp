@@ -43,7 +43,7 @@ void ByteSequence::write(std::ostream& ofs) const
 
 void ByteSequence::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", this->view());
+    tree.appendView("Source", [this] {return this->view();});
 }
 
 std::shared_ptr<graphic::View> ByteSequence::view() const
@@ -0,0 +1,67 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "carving.hpp"
+
+#include "graphic/view/hexview.hpp"
+#include "graphic/view/tableview.hpp"
+#include "misc/util.hpp"
+
+namespace tyrex {
+namespace data {
+
+Carving::Carving(const MemChunk& srcChunk, const Colorizer& srcColorizer, const std::vector<Found>& found) :
+    mSource(srcChunk, srcColorizer),
+    mFound(found)
+{
+    for (const Found& file : mFound)
+        mRows.append(QStringList() << "0x" + Util::numToHex(file.mOffset, 8) << file.mType);
+}
+
+
+std::vector<Data::Output> Carving::outputs() const
+{
+    std::vector<Output> result;
+    result.reserve(mFound.size());
+    for (const Found& file : mFound)
+        result.push_back({Carving::title(file), mSource.chunk().subChunk(file.mOffset)});
+    return result;
+}
+
+
+void Carving::doAppendToTree(graphic::TreeNodeModel& tree) const
+{
+    tree.appendView("Source", [this] {return mSource.view();});
+    mFirstView = tree.appendView("Embedded files", [this] {return std::make_shared<graphic::TableView>(QStringList() << "Offset" << "Type", mRows);});
+
+    std::shared_ptr<graphic::TreeNodeModel> node = std::make_shared<graphic::TreeNodeModel>("Files");
+    for (const Found& file : mFound)
+    {
+        MemChunk chunk = mSource.chunk().subChunk(file.mOffset);
+        node->appendView(Carving::title(file), [chunk] {return std::make_shared<graphic::HexView>(chunk);});
+    }
+    tree.appendTree(node);
+}
+
+QString Carving::title(const Found& found)
+{
+    return found.mType + " at 0x" + Util::numToHex(found.mOffset, 8);
+}
+
+}
+}
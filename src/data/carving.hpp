@@ -0,0 +1,57 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_DATA_CARVING_HPP
+#define TYREX_DATA_CARVING_HPP
+
+#include "bytesequence.hpp"
+#include <QStringList>
+
+namespace tyrex {
+namespace data {
+
+// Files found at any offset of the source by their signature (see parse::Carver).
+// Their end is unknown : each output runs until the end of the source.
+class Carving : public Data
+{
+public:
+    struct Found
+    {
+        unsigned int mOffset;
+        QString mType;
+    };
+
+    Carving(const MemChunk& srcChunk, const Colorizer& srcColorizer, const std::vector<Found>& found);
+
+    std::vector<Output> outputs() const;
+
+private:
+    void doAppendToTree(graphic::TreeNodeModel& tree) const;
+
+    static QString title(const Found& found);
+
+    ByteSequence mSource;
+    std::vector<Found> mFound;
+    // rows of the table of embedded files
+    QList<QStringList> mRows;
+};
+
+}
+}
+
+#endif // TYREX_DATA_CARVING_HPP
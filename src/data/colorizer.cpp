@@ -18,6 +18,8 @@
 
 #include "colorizer.hpp"
 
+#include "misc/profiler.hpp"
+
 namespace tyrex {
 namespace data {
 
@@ -59,11 +61,13 @@ void AbstractSeparater::lineAt(unsigned int x, unsigned int y, bool bothSides, Q
 
 void Colorizer::addHighlight(unsigned int start, unsigned int size, QColor color)
 {
+    Profiler::count(Profiler::colorizerEntries);
     mHighlighter->addHighlight(start, size, color);
 }
 
 void Colorizer::addSeparation(unsigned int pos, unsigned int size)
 {
+    Profiler::count(Profiler::colorizerEntries);
     mSeparater->addSeparation(pos, size);
 }
 
@@ -74,6 +78,44 @@ void Colorizer::colorize(QPainter& painter, unsigned int pos, unsigned int width
 }
 
 
+void Colorizer::write(QDataStream& stream) const
+{
+    const ArraySeparater* arraySeparater = dynamic_cast<const ArraySeparater*>(mSeparater.get());
+
+    stream << static_cast<bool>(dynamic_cast<const ArrayHighlighter*>(mHighlighter.get()))
+           << static_cast<bool>(arraySeparater);
+    if (arraySeparater)
+        stream << arraySeparater->bothSides();
+
+    mHighlighter->write(stream);
+    mSeparater->write(stream);
+}
+
+void Colorizer::read(QDataStream& stream)
+{
+    bool arrayHighlighter;
+    bool arraySeparater;
+    stream >> arrayHighlighter >> arraySeparater;
+
+    if (arrayHighlighter)
+        mHighlighter = std::make_shared<ArrayHighlighter>();
+    else
+        mHighlighter = std::make_shared<Highlighter>();
+
+    if (arraySeparater)
+    {
+        bool bothSides;
+        stream >> bothSides;
+        mSeparater = std::make_shared<ArraySeparater>(bothSides);
+    }
+    else
+        mSeparater = std::make_shared<Separater>();
+
+    mHighlighter->read(stream);
+    mSeparater->read(stream);
+}
+
+
 void Highlighter::addHighlight(unsigned int start, unsigned int size, QColor color)
 {
     if (size)
@@ -86,6 +128,49 @@ void Separater::addSeparation(unsigned int pos, unsigned int size)
 }
 
 
+void Highlighter::write(QDataStream& stream) const
+{
+    stream << static_cast<quint32>(mHighlights.size());
+    for (QMap<unsigned int, Highlight>::const_iterator it = mHighlights.begin() ; it != mHighlights.end() ; ++it)
+        stream << it->start << it->size << it->color;
+}
+
+void Highlighter::read(QDataStream& stream)
+{
+    mHighlights.clear();
+
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0 ; i < count && stream.status() == QDataStream::Ok ; ++i)
+    {
+        Highlight highlight;
+        stream >> highlight.start >> highlight.size >> highlight.color;
+        mHighlights.insert(highlight.start, highlight);
+    }
+}
+
+void Separater::write(QDataStream& stream) const
+{
+    stream << static_cast<quint32>(mSeparations.size());
+    for (QMap<unsigned int, Separation>::const_iterator it = mSeparations.begin() ; it != mSeparations.end() ; ++it)
+        stream << it->pos << it->size;
+}
+
+void Separater::read(QDataStream& stream)
+{
+    mSeparations.clear();
+
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0 ; i < count && stream.status() == QDataStream::Ok ; ++i)
+    {
+        Separation separation;
+        stream >> separation.pos >> separation.size;
+        mSeparations.insert(separation.pos, separation);
+    }
+}
+
+
 void Highlighter::colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const
 {
     if (mHighlights.isEmpty())
@@ -163,6 +248,37 @@ void ArraySeparater::addSeparation(unsigned int pos, unsigned int/* size*/)
 }
 
 
+void ArrayHighlighter::write(QDataStream& stream) const
+{
+    stream << static_cast<quint32>(mHighlights.size());
+    stream.writeRawData(reinterpret_cast<const char*>(mHighlights.data()), mHighlights.size());
+}
+
+void ArrayHighlighter::read(QDataStream& stream)
+{
+    quint32 size;
+    stream >> size;
+    mHighlights.assign(stream.status() == QDataStream::Ok ? size : 0, 0);
+    if (stream.readRawData(reinterpret_cast<char*>(mHighlights.data()), mHighlights.size()) != static_cast<int>(mHighlights.size()))
+        stream.setStatus(QDataStream::ReadPastEnd);
+}
+
+void ArraySeparater::write(QDataStream& stream) const
+{
+    stream << static_cast<quint32>(mSeparations.size());
+    stream.writeRawData(reinterpret_cast<const char*>(mSeparations.data()), mSeparations.size());
+}
+
+void ArraySeparater::read(QDataStream& stream)
+{
+    quint32 size;
+    stream >> size;
+    mSeparations.assign(stream.status() == QDataStream::Ok ? size : 0, 0);
+    if (stream.readRawData(reinterpret_cast<char*>(mSeparations.data()), mSeparations.size()) != static_cast<int>(mSeparations.size()))
+        stream.setStatus(QDataStream::ReadPastEnd);
+}
+
+
 void ArrayHighlighter::colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const
 {
     for (unsigned int y = 0 ; y < countVert ; ++y)
@@ -21,6 +21,7 @@
 
 #include <QMap>
 #include <QColor>
+#include <QDataStream>
 #include <QPainter>
 #include <memory>
 
@@ -34,6 +35,10 @@ public:
 
     virtual void addHighlight(unsigned int start, unsigned int size, QColor color) = 0;
 
+    // contents only : the Colorizer records which implementation it is
+    virtual void write(QDataStream& stream) const = 0;
+    virtual void read(QDataStream& stream) = 0;
+
     virtual void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const = 0;
 
 protected:
@@ -46,6 +51,9 @@ class Highlighter : public AbstractHighlighter
 public:
     void addHighlight(unsigned int start, unsigned int size, QColor color);
 
+    void write(QDataStream& stream) const;
+    void read(QDataStream& stream);
+
     void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const;
 
 private:
@@ -73,6 +81,9 @@ class ArrayHighlighter : public AbstractHighlighter
 public:
     void addHighlight(unsigned int start, unsigned int size, QColor color);
 
+    void write(QDataStream& stream) const;
+    void read(QDataStream& stream);
+
     void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const;
 
 private:
@@ -87,6 +98,9 @@ public:
 
     virtual void addSeparation(unsigned int pos, unsigned int size) = 0;
 
+    virtual void write(QDataStream& stream) const = 0;
+    virtual void read(QDataStream& stream) = 0;
+
     virtual void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const = 0;
 
 protected:
@@ -99,6 +113,9 @@ class Separater : public AbstractSeparater
 public:
     void addSeparation(unsigned int pos, unsigned int size);
 
+    void write(QDataStream& stream) const;
+    void read(QDataStream& stream);
+
     void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const;
 
 private:
@@ -125,6 +142,10 @@ class ArraySeparater : public AbstractSeparater
 public:
     inline ArraySeparater(bool bothSides = true);
     void addSeparation(unsigned int pos, unsigned int size);
+    inline bool bothSides() const;
+
+    void write(QDataStream& stream) const;
+    void read(QDataStream& stream);
 
     void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const;
 
@@ -138,6 +159,8 @@ private:
 
 inline ArraySeparater::ArraySeparater(bool bothSides) :
     mBothSides(bothSides) {}
+inline bool ArraySeparater::bothSides() const
+    {return mBothSides;}
 
 
 class Colorizer
@@ -151,6 +174,10 @@ public:
 
     void colorize(QPainter& painter, unsigned int pos, unsigned int width, unsigned int height, unsigned int lineSpacing, unsigned int descent, unsigned int countPlaces, unsigned int countHoriz, unsigned int countVert, unsigned int leftmargin) const;
 
+    // saves and restores the highlights and separations, e.g. in the result cache
+    void write(QDataStream& stream) const;
+    void read(QDataStream& stream);
+
 private:
     std::shared_ptr<AbstractHighlighter> mHighlighter;
     std::shared_ptr<AbstractSeparater> mSeparater;
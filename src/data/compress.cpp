@@ -19,6 +19,7 @@
 #include "compress.hpp"
 
 #include "graphic/view/hexview.hpp"
+#include "misc/profiler.hpp"
 
 namespace tyrex {
 namespace data {
@@ -27,20 +28,27 @@ Compress::Compress(const MemChunk& srcChunk, const MemChunk& decompChunk) :
     mSource(srcChunk),
     mDecomp(decompChunk)
 {
+    Profiler::count(Profiler::bytesOut, decompChunk.size());
 }
 
 Compress::Compress(const MemChunk& srcChunk, const MemChunk& decompChunk, const Colorizer& srcColorizer, const Colorizer& decompColorizer) :
     mSource(srcChunk, srcColorizer),
     mDecomp(decompChunk, decompColorizer)
 {
+    Profiler::count(Profiler::bytesOut, decompChunk.size());
+}
+
+
+std::vector<Data::Output> Compress::outputs() const
+{
+    return {{"Unpacked", mDecomp.chunk()}};
 }
 
 
 void Compress::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", mSource.view());
-    mFirstView = mDecomp.view();
-    tree.appendLeaf("Unpacked", mFirstView);
+    tree.appendView("Source", [this] {return mSource.view();});
+    mFirstView = tree.appendView("Unpacked", [this] {return mDecomp.view();});
 }
 
 }
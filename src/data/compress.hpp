@@ -30,8 +30,11 @@ public:
     Compress(const MemChunk& srcChunk, const MemChunk& decompChunk);
     Compress(const MemChunk& srcChunk, const MemChunk& decompChunk, const Colorizer& srcColorizer, const Colorizer& decompColorizer);
 
+    inline const ByteSequence& source() const;
     inline const ByteSequence& decomp() const;
 
+    std::vector<Output> outputs() const;
+
 private:
     void doAppendToTree(graphic::TreeNodeModel& tree) const;
 
@@ -39,6 +42,8 @@ private:
     ByteSequence mDecomp;
 };
 
+inline const ByteSequence& Compress::source() const
+    {return mSource;}
 inline const ByteSequence& Compress::decomp() const
     {return mDecomp;}
 
@@ -20,6 +20,8 @@
 
 #include "graphic/treemodel.hpp"
 
+#include <algorithm>
+
 namespace tyrex {
 namespace data {
 
@@ -39,6 +41,22 @@ void Data::appendToTree(graphic::TreeNodeModel& tree) const
 {
     this->doAppendToTree(tree);
 
+    if (std::any_of(mNested.begin(), mNested.end(), [](const std::shared_ptr<Data>& data) {return (bool)data;}))
+    {
+        std::vector<Output> outputs = this->outputs();
+        std::shared_ptr<graphic::TreeNodeModel> node = std::make_shared<graphic::TreeNodeModel>("Nested");
+        for (unsigned int i = 0 ; i < mNested.size() && i < outputs.size() ; ++i)
+        {
+            if (mNested[i])
+            {
+                std::shared_ptr<graphic::TreeNodeModel> tmp = std::make_shared<graphic::TreeNodeModel>(outputs[i].mName);
+                mNested[i]->appendToTree(*tmp);
+                node->appendTree(tmp);
+            }
+        }
+        tree.appendTree(node);
+    }
+
     if (!mErrors.empty())
     {
         std::shared_ptr<graphic::TreeNodeModel> node = std::make_shared<graphic::TreeNodeModel>("Errors");
@@ -52,9 +70,20 @@ void Data::appendToTree(graphic::TreeNodeModel& tree) const
     }
 }
 
-std::shared_ptr<graphic::View> Data::firstView() const
+std::vector<Data::Output> Data::outputs() const
+{
+    return std::vector<Output>();
+}
+
+void Data::resizeNested(unsigned int count)
+{
+    mNested.assign(count, std::shared_ptr<Data>());
+}
+
+
+std::shared_ptr<graphic::ViewFactory> Data::firstView() const
 {
-    std::shared_ptr<graphic::View> result(mFirstView);
+    std::shared_ptr<graphic::ViewFactory> result(mFirstView);
     mFirstView.reset();
     return result;
 }
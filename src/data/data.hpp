@@ -21,6 +21,7 @@
 
 #include "graphic/view/view.hpp"
 #include "graphic/treemodel.hpp"
+#include "misc/memchunk.hpp"
 #include <QString>
 #include <memory>
 
@@ -30,26 +31,42 @@ namespace data {
 class Data
 {
 public:
+    // decoded bytes that may hold another document, e.g. an archive member
+    struct Output
+    {
+        QString mName;
+        MemChunk mChunk;
+    };
+
     virtual ~Data();
 
     void appendToTree(graphic::TreeNodeModel& tree) const;
     std::shared_ptr<graphic::TreeNodeModel> treeModel(QString title) const;
 
-    std::shared_ptr<graphic::View> firstView() const;
+    std::shared_ptr<graphic::ViewFactory> firstView() const;
 
     inline void addError(const std::shared_ptr<Data>& data);
 
+    virtual std::vector<Output> outputs() const;
+    // documents found in outputs(), by index (see parse::NestedParser)
+    // Slots are set independently, so that nested parses may run in parallel once resizeNested() was called.
+    void resizeNested(unsigned int count);
+    inline void setNested(unsigned int index, const std::shared_ptr<Data>& data);
+
 protected:
     virtual void doAppendToTree(graphic::TreeNodeModel& tree) const = 0;
 
-    mutable std::shared_ptr<graphic::View> mFirstView;
+    mutable std::shared_ptr<graphic::ViewFactory> mFirstView;
 
 private:
     std::vector<std::shared_ptr<Data> > mErrors;
+    std::vector<std::shared_ptr<Data> > mNested;
 };
 
 inline void Data::addError(const std::shared_ptr<Data>& data)
     {mErrors.push_back(data);}
+inline void Data::setNested(unsigned int index, const std::shared_ptr<Data>& data)
+    {mNested[index] = data;}
 
 }
 }
@@ -32,7 +32,7 @@ DataTree::DataTree(const QString& title, const Tree<void>& tree) :
 
 void DataTree::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf(mTitle, std::make_shared<graphic::TreeView>(mTree));
+    tree.appendView(mTitle, [this] {return std::make_shared<graphic::TreeView>(mTree);});
 }
 
 }
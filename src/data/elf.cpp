@@ -17,28 +17,35 @@
 */
 
 #include "elf.hpp"
+#include "graphic/view/elfsymbolview.hpp"
 #include "graphic/view/tableview.hpp"
 
 namespace tyrex {
 namespace data {
 
-Elf::Elf(const MemChunk& srcChunk, const Colorizer& srcColorizer, const QList<QStringList>& segmentsHeader, const QList<QStringList>& sectionsHeader, const Table& properties) :
+Elf::Elf(const MemChunk& srcChunk, const Colorizer& srcColorizer, const QList<QStringList>& segmentsHeader, const QList<QStringList>& sectionsHeader, const Table& properties, const Table& dynamic, const std::vector<std::shared_ptr<ElfSymbols> >& symbols) :
     mSource(srcChunk, srcColorizer),
     mSegmentsHeader("Segments", QStringList() << "Mode" << "Type", segmentsHeader),
     mSectionsHeader("Sections", QStringList() << "Mode" << "Type", sectionsHeader),
-    mProperties(properties)
+    mProperties(properties),
+    mDynamic(dynamic),
+    mSymbols(symbols)
 {
 }
 
 
 void Elf::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", mSource.view());
+    tree.appendView("Source", [this] {return mSource.view();});
     mProperties.appendToTree(tree);
 
     std::shared_ptr<graphic::TreeNodeModel> node = std::make_shared<graphic::TreeNodeModel>("Elf");
     mSegmentsHeader.appendToTree(*node);
     mSectionsHeader.appendToTree(*node);
+    if (!mDynamic.isEmpty())
+        mDynamic.appendToTree(*node);
+    for (const std::shared_ptr<ElfSymbols>& symbols : mSymbols)
+        node->appendView(symbols->title(), [symbols] {return std::make_shared<graphic::ElfSymbolView>(symbols);});
     tree.appendTree(node);
 }
 
@@ -20,7 +20,10 @@
 #define TYREX_DATA_ELF_HPP
 
 #include "bytesequence.hpp"
+#include "elfsymbols.hpp"
 #include "table.hpp"
+#include <memory>
+#include <vector>
 
 namespace tyrex {
 namespace data {
@@ -28,7 +31,7 @@ namespace data {
 class Elf : public Data
 {
 public:
-    Elf(const MemChunk& srcChunk, const Colorizer& srcColorizer, const QList<QStringList>& segmentsHeader, const QList<QStringList>& sectionsHeader, const Table& properties);
+    Elf(const MemChunk& srcChunk, const Colorizer& srcColorizer, const QList<QStringList>& segmentsHeader, const QList<QStringList>& sectionsHeader, const Table& properties, const Table& dynamic, const std::vector<std::shared_ptr<ElfSymbols> >& symbols);
 
 private:
     void doAppendToTree(graphic::TreeNodeModel& tree) const;
@@ -37,6 +40,8 @@ private:
     Table mSegmentsHeader;
     Table mSectionsHeader;
     Table mProperties;
+    Table mDynamic;
+    std::vector<std::shared_ptr<ElfSymbols> > mSymbols;
 };
 
 }
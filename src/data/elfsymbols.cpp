@@ -0,0 +1,244 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "elfsymbols.hpp"
+
+#include "external/elf.h"
+#include "misc/hash/hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tyrex {
+namespace data {
+
+ElfSymbols::ElfSymbols(const QString& title, const MemChunk& strings, unsigned int addressDigits) :
+    mTitle(title),
+    mStrings(strings),
+    mAddressDigits(addressDigits)
+{
+}
+
+
+void ElfSymbols::reserve(unsigned int count)
+{
+    mNames.reserve(count);
+    mValues.reserve(count);
+    mSizes.reserve(count);
+    mInfos.reserve(count);
+    mSections.reserve(count);
+}
+
+void ElfSymbols::appendRow(uint32_t name, uint64_t value, uint64_t size, unsigned char info, uint16_t section)
+{
+    mNames.push_back(name);
+    mValues.push_back(value);
+    mSizes.push_back(size);
+    mInfos.push_back(info);
+    mSections.push_back(section);
+}
+
+void ElfSymbols::buildIndexes()
+{
+    unsigned int count = this->rowCount();
+
+    // addresses : section and file symbols would shadow the functions and objects they contain
+    mByAddress.clear();
+    for (unsigned int row = 0 ; row < count ; ++row)
+    {
+        unsigned char type = this->type(row);
+        if (mSections[row] != SHN_UNDEF && type != STT_SECTION && type != STT_FILE && type != STT_TLS)
+            mByAddress.push_back(row);
+    }
+    std::stable_sort(mByAddress.begin(), mByAddress.end(), [this](uint32_t row1, uint32_t row2) {return mValues[row1] < mValues[row2];});
+
+    // names : at most half full, only the first row of each name (repeated names would make long clusters)
+    unsigned int bucketCount = 16;
+    while (bucketCount < 2 * count)
+        bucketCount *= 2;
+    mBuckets.assign(bucketCount, 0);
+
+    unsigned int mask = bucketCount - 1;
+    for (unsigned int row = 0 ; row < count ; ++row)
+    {
+        unsigned int length;
+        const char* str = this->nameData(row, length);
+        if (!length)
+            continue;
+
+        unsigned int i = Hasher::getFNV1a(reinterpret_cast<const unsigned char*>(str), length) & mask;
+        for ( ; mBuckets[i] ; i = (i + 1) & mask)
+        {
+            unsigned int otherLength;
+            const char* other = this->nameData(mBuckets[i] - 1, otherLength);
+            if (otherLength == length && !std::memcmp(other, str, length))
+                break;
+        }
+        if (!mBuckets[i])
+            mBuckets[i] = row + 1;
+    }
+}
+
+
+QString ElfSymbols::name(unsigned int row) const
+{
+    unsigned int length;
+    const char* str = this->nameData(row, length);
+    return QString::fromUtf8(str, length);
+}
+
+const char* ElfSymbols::nameData(unsigned int row, unsigned int& length) const
+{
+    return ElfSymbols::tableString(mStrings, mNames[row], length);
+}
+
+const char* ElfSymbols::tableString(const MemChunk& strings, uint64_t offset, unsigned int& length)
+{
+    unsigned int size = strings.size();
+    if (offset >= size)
+    {
+        length = 0;
+        return "";
+    }
+
+    // an unterminated string ends with the table
+    const char* str = reinterpret_cast<const char*>(strings.data()) + offset;
+    const void* end = std::memchr(str, 0, size - offset);
+    length = end ? static_cast<const char*>(end) - str : size - offset;
+    return str;
+}
+
+
+QString ElfSymbols::text(unsigned int row, Column column) const
+{
+    switch (column)
+    {
+    case nameColumn:
+        return this->name(row);
+    case valueColumn:
+        return "0x" + QString("%1").arg(static_cast<qulonglong>(mValues[row]), mAddressDigits, 16, QChar('0'));
+    case sizeColumn:
+        return QString::number(static_cast<qulonglong>(mSizes[row]));
+    case typeColumn:
+        switch (this->type(row))
+        {
+        case STT_NOTYPE:
+            return "NOTYPE";
+        case STT_OBJECT:
+            return "OBJECT";
+        case STT_FUNC:
+            return "FUNC";
+        case STT_SECTION:
+            return "SECTION";
+        case STT_FILE:
+            return "FILE";
+        case STT_COMMON:
+            return "COMMON";
+        case STT_TLS:
+            return "TLS";
+        case STT_GNU_IFUNC:
+            return "IFUNC";
+        default:
+            return QString::number(this->type(row));
+        }
+    case bindingColumn:
+        switch (this->binding(row))
+        {
+        case STB_LOCAL:
+            return "LOCAL";
+        case STB_GLOBAL:
+            return "GLOBAL";
+        case STB_WEAK:
+            return "WEAK";
+        case STB_GNU_UNIQUE:
+            return "UNIQUE";
+        default:
+            return QString::number(this->binding(row));
+        }
+    case sectionColumn:
+        switch (mSections[row])
+        {
+        case SHN_UNDEF:
+            return "UNDEF";
+        case SHN_ABS:
+            return "ABS";
+        case SHN_COMMON:
+            return "COMMON";
+        default:
+            return QString::number(mSections[row]);
+        }
+    default:
+        return QString();
+    }
+}
+
+QString ElfSymbols::columnName(Column column)
+{
+    switch (column)
+    {
+    case nameColumn:
+        return "Name";
+    case valueColumn:
+        return "Value";
+    case sizeColumn:
+        return "Size";
+    case typeColumn:
+        return "Type";
+    case bindingColumn:
+        return "Binding";
+    case sectionColumn:
+        return "Section";
+    default:
+        return QString();
+    }
+}
+
+
+int ElfSymbols::findAddress(uint64_t address) const
+{
+    auto it = std::upper_bound(mByAddress.begin(), mByAddress.end(), address, [this](uint64_t value, uint32_t row) {return value < mValues[row];});
+    if (it == mByAddress.begin())
+        return -1;
+
+    // among the symbols at the highest value, one whose range holds the address
+    uint64_t value = mValues[*(it - 1)];
+    for (auto i = it ; i != mByAddress.begin() && mValues[*(i - 1)] == value ; --i)
+        if (address - value < mSizes[*(i - 1)])
+            return *(i - 1);
+    return *(it - 1);
+}
+
+int ElfSymbols::findName(const QByteArray& name) const
+{
+    if (name.isEmpty() || mBuckets.empty())
+        return -1;
+
+    unsigned int mask = mBuckets.size() - 1;
+    for (unsigned int i = Hasher::getFNV1a(reinterpret_cast<const unsigned char*>(name.constData()), name.size()) & mask ; mBuckets[i] ; i = (i + 1) & mask)
+    {
+        unsigned int row = mBuckets[i] - 1;
+        unsigned int length;
+        const char* str = this->nameData(row, length);
+        if (length == static_cast<unsigned int>(name.size()) && !std::memcmp(str, name.constData(), length))
+            return row;
+    }
+    return -1;
+}
+
+}
+}
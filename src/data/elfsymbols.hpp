@@ -0,0 +1,112 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_DATA_ELFSYMBOLS_HPP
+#define TYREX_DATA_ELFSYMBOLS_HPP
+
+#include <cstdint>
+#include <vector>
+#include <QByteArray>
+#include <QString>
+#include "misc/memchunk.hpp"
+
+namespace tyrex {
+namespace data {
+
+// Symbol table of an elf file (.symtab or .dynsym), one row per symbol and one array per field.
+// Names are kept as offsets into the string table of the file, and only decoded when displayed.
+// Once all rows are appended, buildIndexes() sorts the defined symbols by address and hashes all names,
+// so that both lookups stay fast with millions of symbols.
+class ElfSymbols
+{
+public:
+    enum Column {
+        nameColumn,
+        valueColumn,
+        sizeColumn,
+        typeColumn,
+        bindingColumn,
+        sectionColumn,
+        columnCount
+    };
+
+    ElfSymbols(const QString& title, const MemChunk& strings, unsigned int addressDigits);
+
+    void reserve(unsigned int count);
+    void appendRow(uint32_t name, uint64_t value, uint64_t size, unsigned char info, uint16_t section);
+    void buildIndexes();
+
+    inline const QString& title() const;
+    inline unsigned int rowCount() const;
+
+    QString name(unsigned int row) const;
+    // same without copy, valid while the string table is alive
+    const char* nameData(unsigned int row, unsigned int& length) const;
+    inline uint64_t value(unsigned int row) const;
+    inline uint64_t size(unsigned int row) const;
+    inline unsigned char type(unsigned int row) const;
+    inline unsigned char binding(unsigned int row) const;
+    inline uint16_t section(unsigned int row) const;
+
+    QString text(unsigned int row, Column column) const;
+    static QString columnName(Column column);
+
+    // string at offset in a string table, as for names ; empty if out of it
+    static const char* tableString(const MemChunk& strings, uint64_t offset, unsigned int& length);
+
+    // the defined symbol with the highest value not above address, preferring one whose range holds address ; -1 if none
+    int findAddress(uint64_t address) const;
+    // the first symbol named name ; -1 if none
+    int findName(const QByteArray& name) const;
+
+private:
+    QString mTitle;
+    MemChunk mStrings;
+    unsigned int mAddressDigits;
+
+    std::vector<uint32_t> mNames;
+    std::vector<uint64_t> mValues;
+    std::vector<uint64_t> mSizes;
+    std::vector<unsigned char> mInfos;
+    std::vector<uint16_t> mSections;
+
+    // defined symbols sorted by value
+    std::vector<uint32_t> mByAddress;
+    // open addressing, rows + 1 (0 is an empty bucket)
+    std::vector<uint32_t> mBuckets;
+};
+
+inline const QString& ElfSymbols::title() const
+    {return mTitle;}
+inline unsigned int ElfSymbols::rowCount() const
+    {return mNames.size();}
+inline uint64_t ElfSymbols::value(unsigned int row) const
+    {return mValues[row];}
+inline uint64_t ElfSymbols::size(unsigned int row) const
+    {return mSizes[row];}
+inline unsigned char ElfSymbols::type(unsigned int row) const
+    {return mInfos[row] & 0xF;}
+inline unsigned char ElfSymbols::binding(unsigned int row) const
+    {return mInfos[row] >> 4;}
+inline uint16_t ElfSymbols::section(unsigned int row) const
+    {return mSections[row];}
+
+}
+}
+
+#endif // TYREX_DATA_ELFSYMBOLS_HPP
@@ -20,7 +20,6 @@
 #define TYREX_DATA_FILE_HPP
 
 #include "misc/memchunk.hpp"
-#include "fileinfo.hpp"
 
 namespace tyrex {
 namespace data {
@@ -29,7 +28,8 @@ class File
 {
 public:
     MemChunk mChunk;
-    FileInfo mInfo;
+    // row of the archive's ArchiveIndex
+    unsigned int mRow;
 };
 
 }
@@ -21,14 +21,6 @@
 namespace tyrex {
 namespace data {
 
-QString FileInfo::operator[](Info key) const
-{
-    std::map<Info, QString>::const_iterator found = mInfos.find(key);
-    if (found != mInfos.end())
-        return found->second;
-    return QString();
-}
-
 QString FileInfo::infoToString(Info info)
 {
     switch (info)
@@ -71,6 +63,10 @@ QString FileInfo::infoToString(Info info)
         return "device";
     case linkName:
         return "link";
+    case offset:
+        return "offset";
+    case infoCount:
+        break;
     }
 
     return QString();
@@ -89,7 +85,8 @@ const FileInfoFilter FileInfoFilter::mZipFilter {{
     {FileInfo::versionMadeBy, false},
     {FileInfo::versionNeeded, false},
     {FileInfo::internalAttributes, false},
-    {FileInfo::externalAttributes, false}
+    {FileInfo::externalAttributes, false},
+    {FileInfo::offset, false}
 }};
 
 const FileInfoFilter FileInfoFilter::mTarFilter {{
@@ -102,7 +99,8 @@ const FileInfoFilter FileInfoFilter::mTarFilter {{
     {FileInfo::userName, true},
     {FileInfo::groupName, true},
     {FileInfo::devMajorMinor, true},
-    {FileInfo::linkName, false}
+    {FileInfo::linkName, false},
+    {FileInfo::offset, false}
 }};
 
 }
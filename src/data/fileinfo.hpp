@@ -19,7 +19,6 @@
 #ifndef TYREX_DATA_FILEINFO_HPP
 #define TYREX_DATA_FILEINFO_HPP
 
-#include <map>
 #include <vector>
 #include <QString>
 
@@ -33,14 +32,13 @@ public:
         // zip
         versionMadeBy, versionNeeded, compressionMethod, modDateTime, crc32, compressedSize, size, fileName, fileComment, diskNumber, internalAttributes, externalAttributes,
         // tar
-        fileMode, userId, groupId, userName, groupName, devMajorMinor, linkName
+        fileMode, userId, groupId, userName, groupName, devMajorMinor, linkName,
+        // both
+        offset,
+        infoCount
     };
 
-    QString operator[](Info key) const;
-
     static QString infoToString(Info info);
-
-    std::map<Info, QString> mInfos;
 };
 
 class FileInfoFilter
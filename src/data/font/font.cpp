@@ -32,9 +32,9 @@ Font::Font(const MemChunk& srcChunk, const Colorizer& srcColorizer, const QList<
 
 void Font::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", mSource.view());
+    tree.appendView("Source", [this] {return mSource.view();});
     mProperties.appendToTree(tree);
-    tree.appendLeaf("Glyphs", std::make_shared<graphic::FontView>(mGlyphs));
+    tree.appendView("Glyphs", [this] {return std::make_shared<graphic::FontView>(mGlyphs);});
 }
 
 }
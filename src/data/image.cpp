@@ -23,25 +23,32 @@
 namespace tyrex {
 namespace data {
 
-Image::Image(const MemChunk& srcChunk, const Colorizer& srcColorizer, const std::shared_ptr<Pixmap>& pixmap, const Table& properties) :
+Image::Image(const MemChunk& srcChunk, const Colorizer& srcColorizer, const std::shared_ptr<Pixmap>& pixmap, const Table& properties, const std::shared_ptr<PixmapProgress>& progress) :
     mSource(srcChunk, srcColorizer),
     mPixmap(pixmap),
+    mProgress(progress),
     mProperties(properties)
 {
 }
 
+// Nobody is left to see the rest of the pixmap.
+Image::~Image()
+{
+    if (mProgress)
+        mProgress->cancel();
+}
+
 
 void Image::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", mSource.view());
+    tree.appendView("Source", [this] {return mSource.view();});
     mProperties.appendToTree(tree);
-    mFirstView = this->view();
-    tree.appendLeaf("Image", mFirstView);
+    mFirstView = tree.appendView("Image", [this] {return this->view();});
 }
 
 std::shared_ptr<graphic::View> Image::view() const
 {
-    return std::make_shared<graphic::ImageView>(mPixmap);
+    return std::make_shared<graphic::ImageView>(mPixmap, mProgress);
 }
 
 }
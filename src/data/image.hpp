@@ -21,6 +21,7 @@
 
 #include "bytesequence.hpp"
 #include "data/image/pixmap.hpp"
+#include "data/image/pixmapprogress.hpp"
 #include "table.hpp"
 
 namespace tyrex {
@@ -29,18 +30,28 @@ namespace data {
 class Image : public Data
 {
 public:
-    Image(const MemChunk& srcChunk, const Colorizer& srcColorizer, const std::shared_ptr<Pixmap>& pixmap, const Table& properties);
+    // With a progress, the pixmap is still being decoded in the background.
+    Image(const MemChunk& srcChunk, const Colorizer& srcColorizer, const std::shared_ptr<Pixmap>& pixmap, const Table& properties, const std::shared_ptr<PixmapProgress>& progress = nullptr);
+    ~Image();
 
     std::shared_ptr<graphic::View> view() const;
+    inline const std::shared_ptr<Pixmap>& pixmap() const;
+    inline const std::shared_ptr<PixmapProgress>& progress() const;
 
 private:
     void doAppendToTree(graphic::TreeNodeModel& tree) const;
 
     ByteSequence mSource;
     std::shared_ptr<Pixmap> mPixmap;
+    std::shared_ptr<PixmapProgress> mProgress;
     Table mProperties;
 };
 
+inline const std::shared_ptr<Pixmap>& Image::pixmap() const
+    {return mPixmap;}
+inline const std::shared_ptr<PixmapProgress>& Image::progress() const
+    {return mProgress;}
+
 }
 }
 
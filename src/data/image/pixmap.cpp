@@ -18,9 +18,164 @@
 
 #include "pixmap.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TYREX_PIXMAP_SSE2
+#endif
+
 namespace tyrex {
 namespace data {
 
+// Row kernels : each one converts a whole row of a given format, from the bytes of the pixmap to 0xAARRGGBB values.
+
+// 16-bit samples are big-endian : keep their most significant byte.
+static void narrow16(const unsigned char* src, unsigned char* dst, unsigned int count)
+{
+    unsigned int i = 0;
+
+#ifdef TYREX_PIXMAP_SSE2
+    const __m128i low = _mm_set1_epi16(0xFF);
+    for ( ; i + 16 <= count ; i += 16)
+    {
+        __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i)), low);
+        __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i + 16)), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+#endif
+
+    for ( ; i < count ; ++i)
+        dst[i] = src[2 * i];
+}
+
+static void greyToARGB32(const unsigned char* src, uint32_t* dst, unsigned int width)
+{
+    unsigned int x = 0;
+
+#ifdef TYREX_PIXMAP_SSE2
+    const __m128i opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+    for ( ; x + 16 <= width ; x += 16)
+    {
+        __m128i grey = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        // bytes grey, grey, grey, alpha
+        __m128i gg = _mm_unpacklo_epi8(grey, grey);
+        __m128i ga = _mm_unpacklo_epi8(grey, opaque);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_unpacklo_epi16(gg, ga));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 4), _mm_unpackhi_epi16(gg, ga));
+        gg = _mm_unpackhi_epi8(grey, grey);
+        ga = _mm_unpackhi_epi8(grey, opaque);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 8), _mm_unpacklo_epi16(gg, ga));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 12), _mm_unpackhi_epi16(gg, ga));
+    }
+#endif
+
+    for ( ; x < width ; ++x)
+        dst[x] = 0xFF000000 ^ (src[x] * 0x010101);
+}
+
+static void greyAlphaToARGB32(const unsigned char* src, uint32_t* dst, unsigned int width)
+{
+    unsigned int x = 0;
+
+#ifdef TYREX_PIXMAP_SSE2
+    const __m128i low = _mm_set1_epi16(0xFF);
+    for ( ; x + 8 <= width ; x += 8)
+    {
+        __m128i ga = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * x));
+        __m128i grey = _mm_and_si128(ga, low);
+        __m128i gg = _mm_or_si128(grey, _mm_slli_epi16(grey, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_unpacklo_epi16(gg, ga));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 4), _mm_unpackhi_epi16(gg, ga));
+    }
+#endif
+
+    for ( ; x < width ; ++x)
+        dst[x] = (src[2 * x + 1] << 24) ^ (src[2 * x] * 0x010101);
+}
+
+static void rgbToARGB32(const unsigned char* src, uint32_t* dst, unsigned int width)
+{
+    for (unsigned int x = 0 ; x < width ; ++x, src += 3)
+        dst[x] = 0xFF000000 ^ (src[0] << 16) ^ (src[1] << 8) ^ src[2];
+}
+
+static void argbToARGB32(const unsigned char* src, uint32_t* dst, unsigned int width)
+{
+    unsigned int x = 0;
+
+#ifdef TYREX_PIXMAP_SSE2
+    // byte swap of each 32-bit value
+    for ( ; x + 4 <= width ; x += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), v);
+    }
+#endif
+
+    for ( ; x < width ; ++x)
+        dst[x] = (src[4 * x] << 24) ^ (src[4 * x + 1] << 16) ^ (src[4 * x + 2] << 8) ^ src[4 * x + 3];
+}
+
+static void rgbaToARGB32(const unsigned char* src, uint32_t* dst, unsigned int width)
+{
+    unsigned int x = 0;
+
+#ifdef TYREX_PIXMAP_SSE2
+    // swap red and blue
+    const __m128i greenAlpha = _mm_set1_epi32(0xFF00FF00);
+    for ( ; x + 4 <= width ; x += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x));
+        __m128i rb = _mm_andnot_si128(greenAlpha, v);
+        rb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, 0xB1), 0xB1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_or_si128(_mm_and_si128(v, greenAlpha), rb));
+    }
+#endif
+
+    for ( ; x < width ; ++x)
+        dst[x] = (src[4 * x + 3] << 24) ^ (src[4 * x] << 16) ^ (src[4 * x + 1] << 8) ^ src[4 * x + 2];
+}
+
+// Copies the palette entry of each index ; false if an index is out of the palette.
+template <unsigned int bytesPerPixel>
+static bool expandPalette(const unsigned char* indices, unsigned char* dst, unsigned int width, const unsigned char* palette, unsigned int entries)
+{
+    bool ok = true;
+    for (unsigned int x = 0 ; x < width ; ++x, dst += bytesPerPixel)
+    {
+        if (indices[x] < entries)
+            std::memcpy(dst, palette + indices[x] * bytesPerPixel, bytesPerPixel);
+        else
+            ok = false;
+    }
+    return ok;
+}
+
+// Type with the same channels, on 8-bit samples.
+static Pixmap::Type narrowType(Pixmap::Type type)
+{
+    switch (type)
+    {
+    case Pixmap::grey16:
+        return Pixmap::grey8;
+    case Pixmap::greyalpha32:
+        return Pixmap::greyalpha16;
+    case Pixmap::rgb48:
+        return Pixmap::rgb24;
+    case Pixmap::argb64:
+        return Pixmap::argb32;
+    case Pixmap::rgba64:
+        return Pixmap::rgba32;
+    default:
+        return type;
+    }
+}
+
+
 Pixmap::Pixmap(Type type, unsigned int width, unsigned int height) :
     mType(type),
     mWidth(width),
@@ -46,8 +201,8 @@ Pixmap Pixmap::convert(Type type) const
 {
     Pixmap result(type, mWidth, mHeight);
 
-    for (unsigned int x = 0 ; x < mWidth ; ++x)
-        for (unsigned int y = 0 ; y < mHeight ; ++y)
+    for (unsigned int y = 0 ; y < mHeight ; ++y)
+        for (unsigned int x = 0 ; x < mWidth ; ++x)
             result.set(x, y, this->get(x, y));
     return result;
 }
@@ -55,21 +210,69 @@ Pixmap Pixmap::convert(Type type) const
 Pixmap Pixmap::unindex(const Pixmap& palette, bool& ok) const
 {
     Pixmap result(palette.mType, mWidth, mHeight);
-    ok = true;
+    ok = this->unindex(palette, result, 0, mHeight);
+    return result;
+}
+
+bool Pixmap::unindex(const Pixmap& palette, Pixmap& dst, unsigned int y, unsigned int count) const
+{
+    bool ok = true;
+
+    unsigned int entries = palette.mWidth * palette.mHeight;
+    unsigned int bitsPerPixel = Pixmap::bitdepth(palette.mType);
+
+    // indices of more than 8 bits, or palettes of packed pixels : one pixel at a time
+    if (Pixmap::bitdepth(mType) > 8 || (bitsPerPixel & 7))
+    {
+        for (unsigned int j = y ; j < y + count ; ++j)
+        {
+            for (unsigned int x = 0 ; x < mWidth ; ++x)
+            {
+                unsigned int index = this->greyAt(x, j);
+                if (index < entries)
+                    dst.set(x, j, palette.get(index, 0));
+                else
+                    ok = false;
+            }
+        }
+        return ok;
+    }
+
+    if (!mWidth)
+        return ok;
 
-    for (unsigned int x = 0 ; x < mWidth ; ++x)
+    std::vector<unsigned char> indices(mWidth);
+    const unsigned char* colors = palette.mPixels.data();
+
+    for (unsigned int j = y ; j < y + count ; ++j)
     {
-        for (unsigned int y = 0 ; y < mHeight ; ++y)
+        this->rowGrey8(j, 0, mWidth, indices.data(), 1);
+        unsigned char* row = &dst.mPixels[j * dst.mLinesize];
+
+        switch (bitsPerPixel >> 3)
         {
-            unsigned int index = this->greyAt(x, y);
-            if (index < palette.mWidth * palette.mHeight)
-                result.set(x, y, palette.get(index, 0));
-            else
-                ok = false;
+        case 1:
+            ok &= expandPalette<1>(indices.data(), row, mWidth, colors, entries);
+            break;
+        case 2:
+            ok &= expandPalette<2>(indices.data(), row, mWidth, colors, entries);
+            break;
+        case 3:
+            ok &= expandPalette<3>(indices.data(), row, mWidth, colors, entries);
+            break;
+        case 4:
+            ok &= expandPalette<4>(indices.data(), row, mWidth, colors, entries);
+            break;
+        case 6:
+            ok &= expandPalette<6>(indices.data(), row, mWidth, colors, entries);
+            break;
+        case 8:
+            ok &= expandPalette<8>(indices.data(), row, mWidth, colors, entries);
+            break;
         }
     }
 
-    return result;
+    return ok;
 }
 
 unsigned int Pixmap::bitdepth(Type type)
@@ -174,6 +377,71 @@ unsigned int Pixmap::greyAt(unsigned int x, unsigned int y) const
     }
 }
 
+// grey values of count pixels of row y from column x, for depths up to 8 bits
+void Pixmap::rowGrey8(unsigned int y, unsigned int x, unsigned int count, unsigned char* dst, unsigned int scale) const
+{
+    const unsigned char* row = mPixels.data() + y * mLinesize;
+    unsigned int depth = Pixmap::bitdepth(mType);
+
+    if (depth == 8)
+    {
+        for (unsigned int i = 0 ; i < count ; ++i)
+            dst[i] = row[x + i] * scale;
+        return;
+    }
+
+    unsigned int mask = (1 << depth) - 1;
+    for (unsigned int i = 0, bit = x * depth ; i < count ; ++i, bit += depth)
+        dst[i] = ((row[bit >> 3] >> (8 - depth - (bit & 7))) & mask) * scale;
+}
+
+void Pixmap::rowARGB32(unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) const
+{
+    if (!count)
+        return;
+
+    unsigned int depth = Pixmap::bitdepth(mType);
+    const unsigned char* row = mPixels.data() + y * mLinesize + ((x * depth) >> 3);
+    Type type = narrowType(mType);
+    std::vector<unsigned char> buffer;
+
+    if (type != mType)
+    {
+        buffer.resize((count * depth) >> 4);
+        narrow16(row, buffer.data(), buffer.size());
+        row = buffer.data();
+    }
+    else if (depth < 8)
+    {
+        // packed greys, scaled to 8 bits
+        buffer.resize(count);
+        this->rowGrey8(y, x, count, buffer.data(), 0xFF / ((1 << depth) - 1));
+        row = buffer.data();
+        type = grey8;
+    }
+
+    switch (type)
+    {
+    case grey8:
+        greyToARGB32(row, dst, count);
+        break;
+    case greyalpha16:
+        greyAlphaToARGB32(row, dst, count);
+        break;
+    case rgb24:
+        rgbToARGB32(row, dst, count);
+        break;
+    case argb32:
+        argbToARGB32(row, dst, count);
+        break;
+    case rgba32:
+        rgbaToARGB32(row, dst, count);
+        break;
+    default:
+        std::fill(dst, dst + count, 0);
+    }
+}
+
 unsigned int Pixmap::getARGB32(unsigned int x, unsigned int y) const
 {
     unsigned int yoff = y * mLinesize;
@@ -21,6 +21,7 @@
 
 #include "misc/memchunk.hpp"
 #include "color.hpp"
+#include <cstdint>
 
 namespace tyrex {
 namespace data {
@@ -35,13 +36,23 @@ public:
     Pixmap(Type type, unsigned int width, unsigned int height);
     Pixmap(Type type, unsigned int width, unsigned int height, MemChunk pixels);
 
+    inline Type type() const;
     inline unsigned int width() const;
     inline unsigned int height() const;
+    inline unsigned int linesize() const;
+    inline const unsigned char* pixels() const;
 
     Pixmap convert(Type type) const;
     Pixmap unindex(const Pixmap& palette, bool& ok) const;
+    // Rows [y, y + count) of dst, a pixmap of this size in the type of the palette, from the palette entries at the indices of this pixmap.
+    // Returns false if an index is out of the palette.
+    bool unindex(const Pixmap& palette, Pixmap& dst, unsigned int y, unsigned int count) const;
 
     unsigned int getARGB32(unsigned int x, unsigned int y) const;
+    // Whole row y as 0xAARRGGBB values (the layout of QImage::Format_ARGB32), width() of them.
+    inline void rowARGB32(unsigned int y, uint32_t* dst) const;
+    // count pixels of row y, from column x
+    void rowARGB32(unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) const;
 
 private:
     static unsigned int bitdepth(Type type);
@@ -50,6 +61,8 @@ private:
     void set(unsigned int x, unsigned int y, const ColorARGB& color);
     // return grey value (grey mode only)
     unsigned int greyAt(unsigned int x, unsigned int y) const;
+    // grey values of count pixels of row y from column x, for depths up to 8 bits
+    void rowGrey8(unsigned int y, unsigned int x, unsigned int count, unsigned char* dst, unsigned int scale) const;
 
     static inline unsigned int upscale8(unsigned int x);
     static inline unsigned int upscale6(unsigned int x);
@@ -65,10 +78,18 @@ private:
     MemChunk mPixels;
 };
 
+inline Pixmap::Type Pixmap::type() const
+    {return mType;}
 inline unsigned int Pixmap::width() const
     {return mWidth;}
 inline unsigned int Pixmap::height() const
     {return mHeight;}
+inline unsigned int Pixmap::linesize() const
+    {return mLinesize;}
+inline const unsigned char* Pixmap::pixels() const
+    {return mPixels.data();}
+inline void Pixmap::rowARGB32(unsigned int y, uint32_t* dst) const
+    {this->rowARGB32(y, 0, mWidth, dst);}
 
 inline unsigned int Pixmap::upscale8(unsigned int x)
     {return (x << 8) ^ x;}
@@ -0,0 +1,76 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "pixmapprogress.hpp"
+
+namespace tyrex {
+namespace data {
+
+PixmapProgress::PixmapProgress() :
+    mRows(0),
+    mFinished(false),
+    mCancelled(false),
+    mPreviewCount(0),
+    mPreviewShift(0)
+{
+}
+
+
+std::shared_ptr<Pixmap> PixmapProgress::preview(unsigned int& shift) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    shift = mPreviewShift;
+    return mPreview;
+}
+
+bool PixmapProgress::wait(unsigned int count, std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mCondition.wait_for(lock, timeout, [this, count] {return mRows >= count || mFinished;});
+}
+
+
+// Stores are made under the mutex, so that no waiter misses a notification.
+void PixmapProgress::setRows(unsigned int rows)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRows.store(rows, std::memory_order_release);
+    }
+    mCondition.notify_all();
+}
+
+void PixmapProgress::setPreview(const std::shared_ptr<Pixmap>& preview, unsigned int shift)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPreview = preview;
+    mPreviewShift = shift;
+    ++mPreviewCount;
+}
+
+void PixmapProgress::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished.store(true, std::memory_order_release);
+    }
+    mCondition.notify_all();
+}
+
+}
+}
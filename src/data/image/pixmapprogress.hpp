@@ -0,0 +1,86 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_DATA_PIXMAPPROGRESS_HPP
+#define TYREX_DATA_PIXMAPPROGRESS_HPP
+
+#include "pixmap.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace tyrex {
+namespace data {
+
+// Progress of a pixmap decoded in the background, shared by the decoder and the views.
+// Rows [0, rows()) of the pixmap are final, the others may still be written ; once finished(), all of them are final.
+// Until then, a coarse preview of the whole pixmap may stand in (e.g. the first passes of an interlaced image).
+class PixmapProgress
+{
+public:
+    PixmapProgress();
+
+    inline unsigned int rows() const;
+    // the decoder stopped, with or without an error
+    inline bool finished() const;
+    inline bool cancelled() const;
+    // incremented with each new preview
+    inline unsigned int previewCount() const;
+    // Each pixel of the preview stands for a block of 2^shift x 2^shift pixels of the pixmap ; null if there is none.
+    std::shared_ptr<Pixmap> preview(unsigned int& shift) const;
+
+    // Waits at most timeout for count rows to be final, or for the decoder to stop. Returns whether it is so.
+    bool wait(unsigned int count, std::chrono::milliseconds timeout) const;
+
+    // for the decoder
+    void setRows(unsigned int rows);
+    void setPreview(const std::shared_ptr<Pixmap>& preview, unsigned int shift);
+    void finish();
+    // for the owner of the pixmap : the decoder stops as soon as it can
+    inline void cancel();
+
+private:
+    std::atomic<unsigned int> mRows;
+    std::atomic<bool> mFinished;
+    std::atomic<bool> mCancelled;
+    std::atomic<unsigned int> mPreviewCount;
+
+    // guards the preview, and the waits on rows
+    mutable std::mutex mMutex;
+    mutable std::condition_variable mCondition;
+    std::shared_ptr<Pixmap> mPreview;
+    unsigned int mPreviewShift;
+};
+
+inline unsigned int PixmapProgress::rows() const
+    {return mRows.load(std::memory_order_acquire);}
+inline bool PixmapProgress::finished() const
+    {return mFinished.load(std::memory_order_acquire);}
+inline bool PixmapProgress::cancelled() const
+    {return mCancelled;}
+inline unsigned int PixmapProgress::previewCount() const
+    {return mPreviewCount;}
+inline void PixmapProgress::cancel()
+    {mCancelled = true;}
+
+}
+}
+
+#endif // TYREX_DATA_PIXMAPPROGRESS_HPP
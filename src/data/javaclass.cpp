@@ -31,7 +31,7 @@ JavaClass::JavaClass(const MemChunk& srcChunk, const Colorizer& srcColorizer, co
 
 void JavaClass::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf("Source", mSource.view());
+    tree.appendView("Source", [this] {return mSource.view();});
     mProperties.appendToTree(tree);
     mConstantPool.appendToTree(tree);
 }
@@ -43,7 +43,7 @@ Table::Table(const QString& title, const QStringList& header, const QList<QStrin
 
 void Table::doAppendToTree(graphic::TreeNodeModel& tree) const
 {
-    tree.appendLeaf(mTitle, std::make_shared<graphic::TableView>(mHeader, mContent));
+    tree.appendView(mTitle, [this] {return std::make_shared<graphic::TableView>(mHeader, mContent);});
 }
 
 void Table::push(const QString& str1, const QString& str2)
@@ -34,6 +34,7 @@ public:
     inline void setTitle(const QString& title);
     inline void setHeader(const QStringList& header);
     inline void setContent(const QList<QStringList>& content);
+    inline bool isEmpty() const;
 
     void push(const QString& str1, const QString& str2);
     void push(const QString& str1, const QString& str2, const QString& str3);
@@ -53,6 +54,8 @@ inline void Table::setHeader(const QStringList& header)
     {mHeader = header;}
 inline void Table::setContent(const QList<QStringList>& content)
     {mContent = content;}
+inline bool Table::isEmpty() const
+    {return mContent.isEmpty();}
 
 }
 }
@@ -19,6 +19,7 @@
 #include "area.hpp"
 
 #include <QPainter>
+#include <algorithm>
 #include "graphic/view/scrollview.hpp"
 #include "platform-specific/platform-specific.hpp"
 
@@ -32,19 +33,14 @@ Area::Area(ScrollView* parent) :
 }
 
 
-void Area::changeScroll(int linecount, int pagestep, int value)
+void Area::changeScroll(uint64_t lineCount, uint64_t pageStep, uint64_t line)
 {
-    mScrollView->changeScroll(linecount, pagestep, value);
+    mScrollView->changeScroll(lineCount, pageStep, line);
 }
 
-void Area::setScroll(int value)
+void Area::setScroll(int64_t line)
 {
-    if (value < 0)
-        value = 0;
-    else if (value > mScrollView->maxScroll())
-        value = mScrollView->maxScroll();
-    mScrollView->setScroll(value);
-    this->scroll(value);
+    mScrollView->setScroll(std::max<int64_t>(line, 0));
 }
 
 
@@ -57,39 +53,56 @@ TextArea::TextArea(ScrollView* parent) :
 }
 
 
-void TextArea::drawHex(QPainter& painter, unsigned int x, unsigned int y, unsigned int value)
+qreal TextArea::pixelRatio() const
 {
-    QChar c('?');
+#if QT_VERSION >= 0x050600
+    return this->devicePixelRatioF();
+#elif QT_VERSION >= 0x050000
+    return this->devicePixelRatio();
+#else
+    return 1;
+#endif
+}
+
+std::shared_ptr<const GlyphAtlas> TextArea::atlas() const
+{
+    return GlyphAtlas::get(mFont, this->pixelRatio(), this->palette().color(QPalette::Text));
+}
+
+
+void TextArea::drawHex(GlyphAtlas::Batch& batch, GlyphAtlas::Style style, qreal x, qreal y, unsigned int value) const
+{
+    unsigned char c = '?';
     if (value < 10)
         c = '0' + value;
     else if (value < 16)
         c = 'A' + value - 10;
 
-    painter.drawText(x, y, c);
+    batch.add(style, x, y, c);
 }
 
-void TextArea::drawHexByte(QPainter& painter, unsigned int width, unsigned int x, unsigned int y, unsigned int value)
+void TextArea::drawHexByte(GlyphAtlas::Batch& batch, GlyphAtlas::Style style, qreal width, qreal x, qreal y, unsigned int value) const
 {
     if (mTextInHex &&
             ((value >= 'A' && value <= 'Z') || (value >= 'a' && value <= 'z') || (value >= '0' && value <= '9') || value == '_'))
     {
-        this->drawASCII(painter, x, y, 0);
-        this->drawASCII(painter, x + width, y, value);
+        this->drawASCII(batch, style, x, y, 0);
+        this->drawASCII(batch, style, x + width, y, value);
     }
     else
     {
-        this->drawHex(painter, x, y, value >> 4);
-        this->drawHex(painter, x + width, y, value & 0xF);
+        this->drawHex(batch, style, x, y, value >> 4);
+        this->drawHex(batch, style, x + width, y, value & 0xF);
     }
 }
 
-void TextArea::drawASCII(QPainter& painter, unsigned int x, unsigned int y, unsigned char value)
+void TextArea::drawASCII(GlyphAtlas::Batch& batch, GlyphAtlas::Style style, qreal x, qreal y, unsigned char value) const
 {
-    QChar c('.');
+    unsigned char c = '.';
     if (value >= 0x20 && value < 0x7F)
         c = value;
 
-    painter.drawText(x, y, c);
+    batch.add(style, x, y, c);
 }
 
 void TextArea::drawUnicode(QPainter& painter, unsigned int x, unsigned int y, unsigned int value)
@@ -20,6 +20,8 @@
 #define TYREX_AREA_HPP
 
 #include <QWidget>
+#include <cstdint>
+#include "graphic/util/glyphatlas.hpp"
 
 namespace tyrex {
 namespace graphic {
@@ -34,12 +36,13 @@ class Area : public QWidget
 public:
     explicit Area(ScrollView* parent);
 
-protected slots:
-    virtual void scroll(int value) = 0;
+    // shows the lines from this one
+    virtual void scroll(uint64_t line) = 0;
 
 protected:
-    void changeScroll(int linecount, int pagestep, int value);
-    void setScroll(int value);
+    void changeScroll(uint64_t lineCount, uint64_t pageStep, uint64_t line);
+    // clamped to the lines of the area
+    void setScroll(int64_t line);
 
 private:
     ScrollView* mScrollView;
@@ -52,9 +55,14 @@ public:
     explicit TextArea(ScrollView* parent);
 
 protected:
-    void drawHex(QPainter& painter, unsigned int x, unsigned int y, unsigned int value);
-    void drawHexByte(QPainter& painter, unsigned int width, unsigned int x, unsigned int y, unsigned int value);
-    void drawASCII(QPainter& painter, unsigned int x, unsigned int y, unsigned char value);
+    // device pixels per logical pixel on the current screen
+    qreal pixelRatio() const;
+    // atlas of mFont for the current screen and palette
+    std::shared_ptr<const GlyphAtlas> atlas() const;
+
+    void drawHex(GlyphAtlas::Batch& batch, GlyphAtlas::Style style, qreal x, qreal y, unsigned int value) const;
+    void drawHexByte(GlyphAtlas::Batch& batch, GlyphAtlas::Style style, qreal width, qreal x, qreal y, unsigned int value) const;
+    void drawASCII(GlyphAtlas::Batch& batch, GlyphAtlas::Style style, qreal x, qreal y, unsigned char value) const;
     void drawUnicode(QPainter& painter, unsigned int x, unsigned int y, unsigned int value);
 
     QFont mFont;
@@ -19,8 +19,10 @@
 #include "hexarea.hpp"
 
 #include <QPainter>
+#include <QPaintEvent>
 #include <QTimerEvent>
 #include <QMouseEvent>
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include "graphic/mainwindow.hpp"
@@ -28,6 +30,13 @@
 namespace tyrex {
 namespace graphic {
 
+// opacity of two shades drawn over each other
+static unsigned int overlay(unsigned int alpha, unsigned int added)
+{
+    return 0xFF - (0xFF - alpha) * (0xFF - added) / 0xFF;
+}
+
+
 HexArea::~HexArea()
 {
     if (mSearching)
@@ -46,6 +55,7 @@ unsigned int HexArea::setSearch(MemChunk search)
                 mFound.append(i);
     }
 
+    mRows.clear();
     this->update();
     return mFound.size();
 }
@@ -54,6 +64,7 @@ void HexArea::clearSearch()
 {
     mSearchLength = 0;
     mFound.clear();
+    mRows.clear();
     this->update();
 }
 
@@ -61,8 +72,8 @@ void HexArea::previousSearch()
 {
     if (mFound.size())
     {
-        QList<unsigned int>::const_iterator it = qLowerBound(mFound, mCursor);
-        unsigned int pos;
+        QList<uint64_t>::const_iterator it = qLowerBound(mFound, mCursor);
+        uint64_t pos;
 
         if (it != mFound.begin())
         {
@@ -80,8 +91,8 @@ void HexArea::nextSearch()
 {
     if (mFound.size())
     {
-        QList<unsigned int>::const_iterator it = qUpperBound(mFound, mCursor);
-        unsigned int pos;
+        QList<uint64_t>::const_iterator it = qUpperBound(mFound, mCursor);
+        uint64_t pos;
 
         if (it != mFound.end())
             pos = *it;
@@ -93,7 +104,7 @@ void HexArea::nextSearch()
 }
 
 
-void HexArea::setCursor(unsigned int pos, bool checkScroll)
+void HexArea::setCursor(uint64_t pos, bool checkScroll)
 {
     unsigned int height = mMetrics.height();
     unsigned int lineSpacing = mMetrics.lineSpacing();
@@ -112,26 +123,24 @@ void HexArea::setCursor(unsigned int pos, bool checkScroll)
     this->setTimer();
 }
 
-void HexArea::setSelection(unsigned int pos, unsigned int length, bool cursor)
+void HexArea::setSelection(uint64_t pos, uint64_t length, bool cursor)
 {
-    mSelectStart = pos;
-    mSelectLength = length;
+    this->changeSelection(pos, length);
     if (cursor)
         this->setCursor(pos);
 }
 
-void HexArea::setSelectAndCursor(unsigned int pos, unsigned int length, unsigned int cursor)
+void HexArea::setSelectAndCursor(uint64_t pos, uint64_t length, uint64_t cursor)
 {
-    mSelectStart = pos;
-    mSelectLength = length;
+    this->changeSelection(pos, length);
     this->setCursor(cursor);
 }
 
-void HexArea::extendSelection(unsigned int pos, bool extend)
+void HexArea::extendSelection(uint64_t pos, bool extend)
 {
     if (extend)
     {
-        unsigned int end = mSelectStart + mSelectLength - 1;
+        uint64_t end = mSelectStart + mSelectLength - 1;
         if (mSelectLength == 0)
         {
             if (pos < mSelectStart)
@@ -160,14 +169,35 @@ void HexArea::extendSelection(unsigned int pos, bool extend)
 
 void HexArea::clearSelection()
 {
-    mSelectStart = 0;
-    mSelectLength = 0;
+    this->changeSelection(0, 0);
     this->update();
 }
 
+void HexArea::changeSelection(uint64_t pos, uint64_t length)
+{
+    uint64_t end = pos + length;
+    uint64_t oldEnd = mSelectStart + mSelectLength;
+
+    // only the bytes entering or leaving the selection change
+    if (!length || !mSelectLength)
+    {
+        this->invalidateRows(mSelectStart, oldEnd);
+        this->invalidateRows(pos, end);
+    }
+    else
+    {
+        this->invalidateRows(std::min(pos, mSelectStart), std::max(pos, mSelectStart));
+        this->invalidateRows(std::min(end, oldEnd), std::max(end, oldEnd));
+    }
+
+    mSelectStart = pos;
+    mSelectLength = length;
+}
+
 void HexArea::toggleTextInHex()
 {
     mTextInHex = !mTextInHex;
+    mRows.clear();
     this->update();
 }
 
@@ -188,7 +218,8 @@ void HexArea::clearTimer()
 
 void HexArea::selectionForMouse(const QPoint& mousePos, bool checkTimer)
 {
-    int dx, dy, pos;
+    int dx, dy;
+    int64_t pos;
     this->mouseToPos(mousePos, dx, dy, pos);
 
     if (checkTimer)
@@ -199,7 +230,7 @@ void HexArea::selectionForMouse(const QPoint& mousePos, bool checkTimer)
             mScrollTimer.stop();
     }
 
-    if (pos >= 0 && pos < mChunk.size())
+    if (pos >= 0 && uint64_t(pos) < mChunk.size())
     {
         if (pos < mPosClick)
             this->setSelection(pos, mPosClick - pos + 1, false);
@@ -210,14 +241,24 @@ void HexArea::selectionForMouse(const QPoint& mousePos, bool checkTimer)
 }
 
 
-void HexArea::scroll(int value)
+void HexArea::scroll(uint64_t line)
 {
-    mPos = this->charsPerLine() * value;
+    mPos = this->charsPerLine() * line;
     if (mPosClick >= 0)
         this->selectionForMouse(mLastPos, false);
+    this->emitVisibleRange();
     this->update();
 }
 
+void HexArea::emitVisibleRange()
+{
+    unsigned int height = mMetrics.height();
+    unsigned int lineSpacing = mMetrics.lineSpacing();
+    unsigned int countVert = (this->height() + lineSpacing - height) / lineSpacing;
+
+    emit visibleRangeChanged(mPos, countVert * this->charsPerLine());
+}
+
 void HexArea::showEvent(QShowEvent*)
 {
     MainWindow::attachFindDialog(this);
@@ -239,15 +280,16 @@ void HexArea::timerEvent(QTimerEvent* event)
     if (this->isVisible() && event->timerId() == mCursorTimer.timerId())
     {
         mCursorVisible = !mCursorVisible;
-        this->update();
+        this->update(this->cursorRegion());
     }
     else if (event->timerId() == mScrollTimer.timerId())
     {
-        int dx, dy, pos;
+        int dx, dy;
+        int64_t pos;
         this->mouseToPos(mLastPos, dx, dy, pos);
 
         if (dy != 0)
-            this->setScroll(mPos / this->charsPerLine() + dy);
+            this->setScroll(int64_t(mPos / this->charsPerLine()) + dy);
     }
 }
 
@@ -314,7 +356,7 @@ void HexArea::keyPressEvent(QKeyEvent* event)
     }
     else if (event->key() == Qt::Key_Down)
     {
-        unsigned int pos = mCursor + this->charsPerLine();
+        uint64_t pos = mCursor + this->charsPerLine();
         if (pos >= mChunk.size())
             pos = mChunk.size() - 1;
         if (mChunk.size())
@@ -322,7 +364,7 @@ void HexArea::keyPressEvent(QKeyEvent* event)
     }
     else if (event->key() == Qt::Key_Up)
     {
-        int pos = mCursor - this->charsPerLine();
+        int64_t pos = int64_t(mCursor) - this->charsPerLine();
         if (pos < 0)
             pos = 0;
         if (mChunk.size())
@@ -334,7 +376,7 @@ void HexArea::keyPressEvent(QKeyEvent* event)
         unsigned int lineSpacing = mMetrics.lineSpacing();
         unsigned int countVert = (this->height() + lineSpacing - height) / lineSpacing;
 
-        int pos = mCursor + countVert * this->charsPerLine();
+        uint64_t pos = mCursor + countVert * this->charsPerLine();
         if (pos >= mChunk.size())
             pos = mChunk.size() - 1;
         if (mChunk.size())
@@ -346,7 +388,7 @@ void HexArea::keyPressEvent(QKeyEvent* event)
         unsigned int lineSpacing = mMetrics.lineSpacing();
         unsigned int countVert = (this->height() + lineSpacing - height) / lineSpacing;
 
-        int pos = mCursor - countVert * this->charsPerLine();
+        int64_t pos = int64_t(mCursor) - int64_t(countVert) * this->charsPerLine();
         if (pos < 0)
             pos = 0;
         if (mChunk.size())
@@ -366,17 +408,79 @@ void HexArea::resizeEvent(QResizeEvent*/* event*/)
 
     if (countHoriz)
     {
-        unsigned int linecount = (mChunk.size() + countHoriz - 1) / countHoriz;
-        unsigned int pagestep = countVert;
-        unsigned int value = mPos / countHoriz;
-
-        this->changeScroll(linecount, pagestep, value);
+        uint64_t lineCount = (uint64_t(mChunk.size()) + countHoriz - 1) / countHoriz;
+        this->changeScroll(lineCount, countVert, mPos / countHoriz);
     }
 
+    mRows.clear();
+    this->emitVisibleRange();
     this->update();
 }
 
-void HexArea::paintEvent(QPaintEvent*/* event*/)
+// rows and glyphs are drawn in the colours of the palette
+void HexArea::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::PaletteChange)
+    {
+        mRows.clear();
+        this->update();
+    }
+    TextArea::changeEvent(event);
+}
+
+void HexArea::paintEvent(QPaintEvent* event)
+{
+    unsigned int height = mMetrics.height();
+    unsigned int lineSpacing = mMetrics.lineSpacing();
+    unsigned int descent = mMetrics.descent();
+
+    unsigned int countHoriz = this->charsPerLine();
+    unsigned int countVert = (this->height() + lineSpacing - height) / lineSpacing;
+
+    QPainter painter(this);
+    painter.fillRect(event->rect(), this->palette().color(QPalette::Base));
+    if (!countHoriz)
+        return;
+
+    // rows are rendered on a cache miss only : when scrolling, or when the cursor blinks, most of them are blitted as is
+    int firstLine = std::max(0, (event->rect().top() - int(descent)) / int(lineSpacing));
+    int lastLine = std::min(int(countVert) - 1, (event->rect().bottom() - int(descent)) / int(lineSpacing));
+    for (int y = firstLine ; y <= lastLine ; ++y)
+    {
+        uint64_t pos = mPos + uint64_t(y) * countHoriz;
+        if (pos >= mChunk.size())
+            break;
+
+        int cursor = -1;
+        if (mCursorVisible && mCursor >= pos && mCursor < pos + countHoriz)
+            cursor = mCursor - pos;
+
+        Row& row = mRows[pos];
+        if (row.mPixmap.isNull() || row.mCursor != cursor)
+        {
+            row.mPixmap = this->renderRow(pos, cursor);
+            row.mCursor = cursor;
+        }
+        painter.drawPixmap(0, descent + y * lineSpacing, row.mPixmap);
+    }
+
+    // keep the rows of a screen above and below, for scrolling
+    if (mRows.size() > 4 * countVert)
+    {
+        uint64_t span = uint64_t(countVert) * countHoriz;
+        uint64_t first = mPos > span ? mPos - span : 0;
+        uint64_t last = mPos + 2 * span;
+        for (QHash<quint64, Row>::iterator it = mRows.begin() ; it != mRows.end() ; )
+        {
+            if (it.key() < first || it.key() >= last)
+                it = mRows.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+QPixmap HexArea::renderRow(uint64_t pos, int cursor) const
 {
     unsigned int width = mMetrics.width("0");
     unsigned int height = mMetrics.height();
@@ -384,81 +488,132 @@ void HexArea::paintEvent(QPaintEvent*/* event*/)
     unsigned int descent = mMetrics.descent();
 
     unsigned int countPlaces = this->width() / width;
-    unsigned int countHoriz;
-    if (countPlaces >= 27)
-        countHoriz = (countPlaces - 11) / 4;
-    else
-        countHoriz = (countPlaces - 2) / 4;
+    unsigned int countHoriz = this->charsPerLine();
+    unsigned int leftmargin = countPlaces >= 27 ? 9 : 0;
+    unsigned int asciiStart = countPlaces - countHoriz - 1;
 
-    unsigned int countVert = (this->height() + lineSpacing - height) / lineSpacing;
+    qreal pixelRatio = this->pixelRatio();
+    QPixmap pixmap(std::ceil(this->width() * pixelRatio), std::ceil(lineSpacing * pixelRatio));
+#if QT_VERSION >= 0x050000
+    pixmap.setDevicePixelRatio(pixelRatio);
+#endif
+    pixmap.fill(this->palette().color(QPalette::Base));
 
-    QPainter painter(this);
-    painter.fillRect(0, 0, this->width(), this->height(), Qt::white);
+    QPainter painter(&pixmap);
     painter.setFont(mFont);
-    painter.setPen(Qt::black);
+    painter.setPen(this->palette().color(QPalette::Text));
+
+    // The row is drawn as line y = 1 of the area, with its neighbours for the separators on its edges.
+    // Everything out of the row is clipped by the pixmap.
+    unsigned int y = pos >= countHoriz ? 1 : 0;
+    painter.translate(0, -int(descent + y * lineSpacing));
+    mColorizer.colorize(painter, pos - y * countHoriz, width, height, lineSpacing, descent, countPlaces, countHoriz, y + 2, leftmargin);
+
+    unsigned int baseline = height + y * lineSpacing;
+    unsigned int top = descent + y * lineSpacing;
 
-    unsigned int leftmargin = 0;
+    GlyphAtlas::Batch batch(this->atlas());
     if (countPlaces >= 27)
-        leftmargin = 9;
-    mColorizer.colorize(painter, mPos, width, height, lineSpacing, descent, countPlaces, countHoriz, countVert, leftmargin);
+    {
+        for (unsigned int i = 0 ; i < 8 ; ++i)
+            this->drawHex(batch, GlyphAtlas::normal, (i + 0.5) * width, baseline, (pos >> ((7 - i) << 2)) & 0x0F);
+        painter.drawLine(leftmargin * width, top + lineSpacing, leftmargin * width, top);
+    }
 
-    QFont boldFont = mFont;
-    boldFont.setBold(true);
+    // first search result which may cover pos
+    int posSearch = std::lower_bound(mFound.begin(), mFound.end(), pos + 1 > mSearchLength ? pos + 1 - mSearchLength : 0) - mFound.begin();
 
-    unsigned int posSearch = 0;
-    unsigned int pos = mPos;
-    for (unsigned int y = 0 ; y < countVert ; ++y)
+    // shades are filled by runs of equal bytes
+    unsigned int runStart = 0;
+    unsigned int runShade = 0;
+    for (unsigned int x = 0 ; x <= countHoriz ; ++x, ++pos)
     {
-        if (pos < mChunk.size() && countPlaces >= 27)
+        unsigned int shade = 0;
+        GlyphAtlas::Style style = GlyphAtlas::normal;
+        bool inChunk = x < countHoriz && pos < mChunk.size();
+
+        if (inChunk)
         {
-            for (unsigned int i = 0 ; i < 8 ; ++i)
-                this->drawHex(painter, (i + 0.5) * width, height + y * lineSpacing, (pos >> ((7 - i) << 2)) & 0x0F);
+            while (posSearch < mFound.size() && pos >= mFound[posSearch] + mSearchLength)
+                ++posSearch;
+
+            if (posSearch < mFound.size() && pos >= mFound[posSearch] && pos < mFound[posSearch] + mSearchLength)
+            {
+                shade = overlay(shade, 0x80);
+                style = GlyphAtlas::found;
+            }
 
-            painter.drawLine(leftmargin * width, (y + 1) * lineSpacing + descent,
-                             leftmargin * width, y * lineSpacing + descent);
+            if (int(x) == cursor)
+            {
+                shade = overlay(shade, 0x80);
+                style = GlyphAtlas::cursor;
+            }
+            else if (pos >= mSelectStart && pos < mSelectStart + mSelectLength)
+                shade = overlay(shade, 0x40);
         }
 
-        for (unsigned int x = 0 ; x < countHoriz ; ++x)
+        if (!inChunk || shade != runShade)
         {
-            if (pos < mChunk.size())
+            if (runShade && x > runStart)
             {
-                while (posSearch < mFound.size() && pos >= mFound[posSearch] + mSearchLength)
-                    ++posSearch;
-
-                painter.save();
-
-                if (posSearch < mFound.size() && pos >= mFound[posSearch] && pos < mFound[posSearch] + mSearchLength)
-                {
-                    painter.setFont(boldFont);
-                    painter.fillRect((3 * x + 0.5 + leftmargin) * width, descent + y * lineSpacing, 3 * width, height, QColor(0, 0, 0, 0x80));
-                    painter.fillRect((countPlaces + x - countHoriz - 1) * width, descent + y * lineSpacing, width, height, QColor(0, 0, 0, 0x80));
-                    painter.setPen(Qt::yellow);
-                }
-
-                if (mCursorVisible && pos == mCursor)
-                {
-                    painter.setFont(boldFont);
-                    painter.fillRect((3 * x + 0.5 + leftmargin) * width, descent + y * lineSpacing, 3 * width, height, QColor(0, 0, 0, 0x80));
-                    painter.fillRect((countPlaces + x - countHoriz - 1) * width, descent + y * lineSpacing, width, height, QColor(0, 0, 0, 0x80));
-                    painter.setPen(Qt::white);
-                }
-                else if (pos >= mSelectStart && pos < mSelectStart + mSelectLength)
-                {
-                    painter.fillRect((3 * x + 0.5 + leftmargin) * width, descent + y * lineSpacing, 3 * width, height, QColor(0, 0, 0, 0x40));
-                    painter.fillRect((countPlaces + x - countHoriz - 1) * width, descent + y * lineSpacing, width, height, QColor(0, 0, 0, 0x40));
-                }
-
-                this->drawHexByte(painter, width, (3 * x + 1 + leftmargin) * width, height + y * lineSpacing, mChunk[pos]);
-                this->drawASCII(painter, (countPlaces + x - countHoriz - 1) * width, height + y * lineSpacing, mChunk[pos]);
-
-                painter.restore();
+                QColor color(0, 0, 0, runShade);
+                painter.fillRect((3 * runStart + 0.5 + leftmargin) * width, top, 3 * (x - runStart) * width, height, color);
+                painter.fillRect((asciiStart + runStart) * width, top, (x - runStart) * width, height, color);
             }
-
-            ++pos;
+            runStart = x;
+            runShade = shade;
         }
+
+        if (!inChunk)
+            break;
+
+        this->drawHexByte(batch, style, width, (3 * x + 1 + leftmargin) * width, baseline, mChunk[pos]);
+        this->drawASCII(batch, style, (asciiStart + x) * width, baseline, mChunk[pos]);
+    }
+
+    batch.draw(painter);
+    return pixmap;
+}
+
+void HexArea::invalidateRows(uint64_t start, uint64_t end)
+{
+    unsigned int countHoriz = this->charsPerLine();
+    if (start >= end || !countHoriz)
+        return;
+
+    for (QHash<quint64, Row>::iterator it = mRows.begin() ; it != mRows.end() ; )
+    {
+        if (it.key() < end && it.key() + countHoriz > start)
+            it = mRows.erase(it);
+        else
+            ++it;
     }
 }
 
+// cells of the cursor, in the hex and text columns
+QRegion HexArea::cursorRegion() const
+{
+    unsigned int width = mMetrics.width("0");
+    unsigned int height = mMetrics.height();
+    unsigned int lineSpacing = mMetrics.lineSpacing();
+    unsigned int descent = mMetrics.descent();
+
+    unsigned int countPlaces = this->width() / width;
+    unsigned int countHoriz = this->charsPerLine();
+    unsigned int leftmargin = countPlaces >= 27 ? 9 : 0;
+
+    if (!countHoriz || mCursor < mPos)
+        return QRegion();
+
+    unsigned int x = (mCursor - mPos) % countHoriz;
+    unsigned int y = (mCursor - mPos) / countHoriz;
+    int top = descent + y * lineSpacing;
+
+    QRegion region(int((3 * x + 0.5 + leftmargin) * width), top, 3 * width + 1, height);
+    region += QRect((countPlaces + x - countHoriz - 1) * width, top, width + 1, height);
+    return region;
+}
+
 
 int HexArea::charsPerLine(int availableWidth) const
 {
@@ -471,13 +626,14 @@ int HexArea::charsPerLine(int availableWidth) const
         return (countPlaces - 2) / 4;
 }
 
-int HexArea::mouseToPos(const QPoint& mousePos) const
+int64_t HexArea::mouseToPos(const QPoint& mousePos) const
 {
-    int dx, dy, result;
+    int dx, dy;
+    int64_t result;
     return this->mouseToPos(mousePos, dx, dy, result);
 }
 
-int HexArea::mouseToPos(const QPoint& mousePos, int& dx, int& dy, int& result) const
+int64_t HexArea::mouseToPos(const QPoint& mousePos, int& dx, int& dy, int64_t& result) const
 {
     int width = mMetrics.width("0");
     int height = mMetrics.height();
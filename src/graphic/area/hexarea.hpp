@@ -22,7 +22,10 @@
 #include "area.hpp"
 #include "data/bytesequence.hpp"
 #include <QBasicTimer>
+#include <QHash>
+#include <QPixmap>
 #include <QPoint>
+#include <QRegion>
 
 namespace tyrex {
 namespace graphic {
@@ -44,10 +47,10 @@ public:
     void previousSearch();
     void nextSearch();
 
-    void setCursor(unsigned int pos, bool checkScroll = true);
-    void setSelection(unsigned int pos, unsigned int length = 0, bool cursor = true);
-    void setSelectAndCursor(unsigned int pos, unsigned int length, unsigned int cursor);
-    void extendSelection(unsigned int pos, bool extend = false);
+    void setCursor(uint64_t pos, bool checkScroll = true);
+    void setSelection(uint64_t pos, uint64_t length = 0, bool cursor = true);
+    void setSelectAndCursor(uint64_t pos, uint64_t length, uint64_t cursor);
+    void extendSelection(uint64_t pos, bool extend = false);
     void clearSelection();
 
     inline bool textInHex() const;
@@ -55,10 +58,13 @@ public:
 public slots:
     void toggleTextInHex();
 
-private slots:
-    void scroll(int value);
+signals:
+    // range of bytes on screen
+    void visibleRangeChanged(quint64 start, quint64 size);
 
 private:
+    void scroll(uint64_t line);
+
     void setTimer();
     void clearTimer();
     void selectionForMouse(const QPoint& mousePos, bool checkTimer = true);
@@ -73,30 +79,51 @@ private:
     void keyPressEvent(QKeyEvent* event);
     void keyReleaseEvent(QKeyEvent* event);
     void resizeEvent(QResizeEvent* event);
+    void changeEvent(QEvent* event);
     void paintEvent(QPaintEvent* event);
 
+    void emitVisibleRange();
+    void changeSelection(uint64_t pos, uint64_t length);
+
+    // a line of the area, as drawn from offset pos
+    QPixmap renderRow(uint64_t pos, int cursor) const;
+    // drops the cached rows showing bytes in [start, end)
+    void invalidateRows(uint64_t start, uint64_t end);
+    QRegion cursorRegion() const;
+
     inline int charsPerLine() const;
     int charsPerLine(int availableWidth) const;
-    int mouseToPos(const QPoint& mousePos) const;
-    int mouseToPos(const QPoint& mousePos, int& dx, int& dy, int& result) const;
+    // offsets under the mouse, or -1
+    int64_t mouseToPos(const QPoint& mousePos) const;
+    int64_t mouseToPos(const QPoint& mousePos, int& dx, int& dy, int64_t& result) const;
 
     MemChunk mChunk;
     data::Colorizer mColorizer;
-    int mPos;
+    // offsets are on 64 bits, as well as lines (see ScrollView)
+    uint64_t mPos;
 
     bool mSearching;
     unsigned int mSearchLength;
-    QList<unsigned int> mFound;
-    unsigned int mCursor;
-    unsigned int mSelectStart;
-    unsigned int mSelectLength;
+    QList<uint64_t> mFound;
+    uint64_t mCursor;
+    uint64_t mSelectStart;
+    uint64_t mSelectLength;
     bool mShift;
 
     QBasicTimer mCursorTimer;
     bool mCursorVisible;
     QBasicTimer mScrollTimer;
-    int mPosClick;
+    int64_t mPosClick;
     QPoint mLastPos;
+
+    struct Row
+    {
+        QPixmap mPixmap;
+        // column of the cursor drawn in the row, or -1
+        int mCursor;
+    };
+    // rendered rows by offset, valid for the current width and state
+    QHash<quint64, Row> mRows;
 };
 
 inline HexArea::HexArea(const MemChunk& chunk, const data::Colorizer& colorizer, ScrollView* parent) :
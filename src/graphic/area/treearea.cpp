@@ -23,9 +23,9 @@
 namespace tyrex {
 namespace graphic {
 
-void TreeArea::scroll(int value)
+void TreeArea::scroll(uint64_t line)
 {
-    mPos = value;
+    mPos = line;
     this->update();
 }
 
@@ -32,10 +32,9 @@ class TreeArea : public TextArea
 public:
     inline TreeArea(const Tree<void>& tree, ScrollView* parent);
 
-private slots:
-    void scroll(int value);
-
 private:
+    void scroll(uint64_t line);
+
     void resizeEvent(QResizeEvent* event);
     void paintEvent(QPaintEvent* event);
 
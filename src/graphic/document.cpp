@@ -20,6 +20,7 @@
 
 #include <QFileDialog>
 #include <QMessageBox>
+#include "misc/profiler.hpp"
 #include "parse/parsedocument.hpp"
 #include "mainwindow.hpp"
 
@@ -29,10 +30,16 @@ namespace graphic {
 Document::Document(const MemChunk& chunk, bool& success, QWidget* parent) :
     QWidget(parent),
     mUntitled(true),
-    mData(parse::Document::parse(chunk, parent)),
+    mArena(std::make_shared<Arena>()),
     mLayout(new QVBoxLayout(this))
 {
     this->setAttribute(Qt::WA_DeleteOnClose);
+
+    {
+        // small objects built by parsers are freed at once with the document
+        Arena::Scope arenaScope(mArena);
+        mData = parse::Document::parse(chunk, parent);
+    }
     success = (bool)mData;
 
     if (success)
@@ -70,7 +77,13 @@ void Document::setFocus(SideTree* sideTree)
 
 void Document::split()
 {
-    std::shared_ptr<TreeNodeModel> treeModel = mData->treeModel("");
+    std::shared_ptr<TreeNodeModel> treeModel;
+    {
+        Profiler::Scope scope("tree model");
+        treeModel = mData->treeModel("");
+    }
+
+    Profiler::Scope scope("side tree");
     SideTree* sideTree = new SideTree(treeModel, mData->firstView());
     mSplitter->addWidget(sideTree);
 
@@ -26,6 +26,7 @@
 #include "sidetree.hpp"
 #include "console.hpp"
 #include "data/data.hpp"
+#include "misc/arena.hpp"
 #include "misc/memchunk.hpp"
 
 namespace tyrex {
@@ -64,6 +65,8 @@ private:
 
     QString mPath;
     bool mUntitled;
+    // declared before the data, which is destroyed first
+    std::shared_ptr<Arena> mArena;
     std::shared_ptr<data::Data> mData;
 
     QVBoxLayout* mLayout;
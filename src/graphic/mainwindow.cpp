@@ -23,13 +23,22 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QThread>
+#include <fstream>
+#include <limits>
 #include "document.hpp"
 #include "dialog/hexfinddialog.hpp"
+#include "misc/diskcache.hpp"
 #include "misc/memchunk.hpp"
+#include "misc/profiler.hpp"
+#include "parse/parsedocument.hpp"
 
 namespace tyrex {
 namespace graphic {
 
+// files from this size on are mapped rather than read (see readFile)
+static const qint64 minMappedSize = 64 * 1024 * 1024;
+
 MainWindow* MainWindow::mMainWindow = nullptr;
 HexFindDialog* MainWindow::mHexFindDialog = nullptr;
 
@@ -83,6 +92,10 @@ MainWindow::MainWindow() :
     QObject::connect(mSplitAction, SIGNAL(triggered()), this, SLOT(split()));
     QObject::connect(mUnsplitAction, SIGNAL(triggered()), this, SLOT(unsplit()));
     QObject::connect(mClearConsoleAction, SIGNAL(triggered()), this, SLOT(clearConsole()));
+    QObject::connect(mProfileAction, SIGNAL(toggled(bool)), this, SLOT(setProfiling(bool)));
+    QObject::connect(mExportTraceAction, SIGNAL(triggered()), this, SLOT(exportTrace()));
+    QObject::connect(mNestedParsingAction, SIGNAL(toggled(bool)), this, SLOT(setNestedParsing(bool)));
+    QObject::connect(mDiskCacheAction, SIGNAL(toggled(bool)), this, SLOT(setDiskCache(bool)));
 
     QObject::connect(mTileAction, SIGNAL(triggered()), this, SLOT(tileSubwin()));
     QObject::connect(mCascadeAction, SIGNAL(triggered()), this, SLOT(cascadeSubwin()));
@@ -111,6 +124,21 @@ Console* MainWindow::console()
 }
 
 
+void MainWindow::reportError(QString text)
+{
+    // widgets belong to the main thread
+    if (QThread::currentThread() == mMainWindow->thread())
+        mMainWindow->consoleError(text);
+    else
+        QMetaObject::invokeMethod(mMainWindow, "consoleError", Qt::QueuedConnection, Q_ARG(QString, text));
+}
+
+void MainWindow::consoleError(QString text)
+{
+    MainWindow::console()->error(text);
+}
+
+
 void MainWindow::addFileFromMemChunk(const MemChunk& chunk)
 {
     MainWindow::mMainWindow->openFromMemChunk(chunk);
@@ -150,6 +178,19 @@ void MainWindow::createActions()
     mSplitAction = mViewMenu->addAction(QIcon(folder + "split.png"), "&Split");
     mUnsplitAction = mViewMenu->addAction(QIcon(folder + "unsplit.png"), "&Unsplit");
     mClearConsoleAction = mViewMenu->addAction(QIcon(folder + "clear.png"), "&Clear console");
+    mViewMenu->addSeparator();
+    mProfileAction = mViewMenu->addAction("&Profile parsing");
+    mProfileAction->setCheckable(true);
+    mProfileAction->setChecked(Profiler::enabled());
+    mExportTraceAction = mViewMenu->addAction("&Export profile...");
+    mExportTraceAction->setEnabled(Profiler::enabled());
+    mViewMenu->addSeparator();
+    mNestedParsingAction = mViewMenu->addAction("Decode &nested files");
+    mNestedParsingAction->setCheckable(true);
+    mNestedParsingAction->setChecked(parse::Document::nestedParsing());
+    mDiskCacheAction = mViewMenu->addAction("Cache &decoded results on disk");
+    mDiskCacheAction->setCheckable(true);
+    mDiskCacheAction->setChecked(DiskCache::enabled());
 
     mWindowMenu = this->menuBar()->addMenu("&Window");
     mTileAction = new QAction("Ti&le", this);
@@ -203,6 +244,39 @@ void MainWindow::clearConsole()
     mSplitter->setSizes(QList<int>() << 1 << 0);
 }
 
+void MainWindow::setProfiling(bool enabled)
+{
+    Profiler::setEnabled(enabled);
+    mExportTraceAction->setEnabled(enabled || Profiler::hasEvents());
+}
+
+void MainWindow::setNestedParsing(bool enabled)
+{
+    parse::Document::setNestedParsing(enabled);
+}
+
+void MainWindow::setDiskCache(bool enabled)
+{
+    DiskCache::setEnabled(enabled);
+}
+
+void MainWindow::exportTrace()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Export profile", "tyrex-trace.json", "Chrome trace (*.json)");
+    if (path.isEmpty())
+        return;
+
+    std::ofstream ofs(QFile::encodeName(path).constData());
+    if (!ofs.good())
+    {
+        QMessageBox::critical(this, "Export profile", "Unable to write file : " + path);
+        return;
+    }
+
+    Profiler::writeTrace(ofs);
+    statusBar()->showMessage("Profile exported", 2000);
+}
+
 
 void MainWindow::statusText(QString text)
 {
@@ -213,7 +287,14 @@ void MainWindow::statusText(QString text)
 Document* MainWindow::createDocument(const MemChunk& chunk)
 {
     bool success;
-    Document* document = new Document(chunk, success, MainWindow::mMainWindow);
+    Document* document;
+    {
+        Profiler::Scope scope("open document");
+        document = new Document(chunk, success, MainWindow::mMainWindow);
+    }
+
+    if (Profiler::enabled())
+        MainWindow::console()->info("Profile :\n" + QString::fromStdString(Profiler::takeReport()));
 
     if (success)
     {
@@ -250,6 +331,38 @@ bool MainWindow::openFromMemChunk(const MemChunk& chunk, const QString& path)
     return true;
 }
 
+// Maps big files when possible : pages are read on access rather than up front,
+// and being private they are only copied if a chunk writes to them.
+// A mapped file truncated on disk while it is shown makes the next access to the lost pages crash (SIGBUS) :
+// this risk is accepted for big files only, where reading everything up front would be too slow ; smaller ones are read.
+bool MainWindow::readFile(const QString& path, MemChunk& chunk)
+{
+    Profiler::Scope scope("read file");
+
+#if QT_VERSION >= 0x050400
+    std::shared_ptr<QFile> file = std::make_shared<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly))
+        return false;
+
+    qint64 size = file->size();
+    if (size >= minMappedSize && size <= std::numeric_limits<unsigned int>::max())
+    {
+        uchar* data = file->map(0, size, QFileDevice::MapPrivateOption);
+        if (data)
+        {
+            chunk = MemChunk(data, size, file);
+            return true;
+        }
+    }
+#endif
+
+    std::ifstream ifs(QFile::encodeName(path).constData(), std::ios_base::binary);
+    if (!ifs.good())
+        return false;
+    chunk.append(ifs);
+    return true;
+}
+
 void MainWindow::open(const char* path)
 {
     QString sPath = QFile::decodeName(path);
@@ -262,17 +375,13 @@ void MainWindow::open(const char* path)
             return;
         }
 
-        std::ifstream ifs(path, std::ios_base::binary);
-        if (!ifs.good())
+        MemChunk chunk;
+        if (!MainWindow::readFile(sPath, chunk))
         {
             QMessageBox::critical(this, "File does not exists", "Unable to open file : " + sPath);
             return;
         }
 
-        MemChunk chunk;
-        chunk.append(ifs);
-        ifs.close();
-
         if (this->openFromMemChunk(chunk, sPath))
             statusBar()->showMessage("File loaded", 2000);
     }
@@ -290,17 +399,13 @@ void MainWindow::open()
             return;
         }
 
-        std::ifstream ifs(QFile::encodeName(path).constData(), std::ios_base::binary);
-        if (!ifs.good())
+        MemChunk chunk;
+        if (!MainWindow::readFile(path, chunk))
         {
             QMessageBox::critical(this, "File does not exists", "Unable to open file : " + path);
             return;
         }
 
-        MemChunk chunk;
-        chunk.append(ifs);
-        ifs.close();
-
         if (this->openFromMemChunk(chunk, path))
             statusBar()->showMessage("File loaded", 2000);
     }
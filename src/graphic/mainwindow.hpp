@@ -53,6 +53,8 @@ public:
     static void showMessage(QString text);
     static inline Document* getCurrentDocument();
     static Console* console();
+    // may be called from any thread
+    static void reportError(QString text);
 
     void open(const char* path);
 
@@ -64,6 +66,10 @@ private slots:
     void split();
     void unsplit();
     void clearConsole();
+    void setProfiling(bool enabled);
+    void setNestedParsing(bool enabled);
+    void setDiskCache(bool enabled);
+    void exportTrace();
 
     void tileSubwin();
     void cascadeSubwin();
@@ -76,6 +82,7 @@ private slots:
     void updateWindowMenu();
     void setActiveDocument(QWidget* window);
     void statusText(QString text);
+    void consoleError(QString text);
 
 private:
     void closeEvent(QCloseEvent* event);
@@ -83,6 +90,7 @@ private:
     void createActions();
     void updateViewActions(std::shared_ptr<View> currentView);
     static Document* createDocument(const MemChunk& chunk);
+    static bool readFile(const QString& path, MemChunk& chunk);
     bool openFromMemChunk(const MemChunk& chunk, const QString& path);
     bool openFromMemChunk(const MemChunk& chunk);
 
@@ -111,6 +119,10 @@ private:
     QAction* mSplitAction;
     QAction* mUnsplitAction;
     QAction* mClearConsoleAction;
+    QAction* mProfileAction;
+    QAction* mExportTraceAction;
+    QAction* mNestedParsingAction;
+    QAction* mDiskCacheAction;
 
     QMenu* mWindowMenu;
     QAction* mTileAction;
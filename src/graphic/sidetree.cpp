@@ -25,15 +25,17 @@
 namespace tyrex {
 namespace graphic {
 
-SideTree::SideTree(std::shared_ptr<TreeNodeModel> model, const std::shared_ptr<View>& firstView) :
+// number of views kept alive, including the current one
+static const int maxViews = 8;
+
+SideTree::SideTree(std::shared_ptr<TreeNodeModel> model, const std::shared_ptr<ViewFactory>& firstView) :
     mLayout(new QVBoxLayout(this)),
     mSplitter(new QSplitter),
     mTreeView(new QTreeView),
     mStackedWidget(new QStackedWidget),
-    mItemModel(new QStandardItemModel(mTreeView)),
-    mModel(model, *mItemModel, firstView)
+    mModel(new TreeModel(model, firstView, mTreeView))
 {
-    mTreeView->setModel(mItemModel);
+    mTreeView->setModel(mModel);
     mTreeView->setHeaderHidden(true);
     mTreeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
 
@@ -46,8 +48,8 @@ SideTree::SideTree(std::shared_ptr<TreeNodeModel> model, const std::shared_ptr<V
     mLayout->setMargin(0);
     mLayout->addWidget(mSplitter);
 
-    mTreeView->selectionModel()->select(mModel.firstItem(), QItemSelectionModel::Select);
-    this->selected(mModel.firstItem());
+    mTreeView->selectionModel()->select(mModel->firstItem(), QItemSelectionModel::Select);
+    this->selected(mModel->firstItem());
 
     qApp->installEventFilter(this);
 
@@ -79,11 +81,12 @@ bool SideTree::eventFilter(QObject* obj, QEvent* event)
 
 void SideTree::selected(const QModelIndex& index)
 {
-    QStandardItem* item = mItemModel->itemFromIndex(index);
-    std::shared_ptr<View> view = mModel.viewForItem(item);
+    std::shared_ptr<ViewFactory> factory = mModel->factoryForIndex(index);
 
-    if (view)
+    if (factory)
     {
+        std::shared_ptr<View> view = factory->view();
+
         QWidget* old = mStackedWidget->widget(0);
         if (old != view.get())
         {
@@ -91,10 +94,21 @@ void SideTree::selected(const QModelIndex& index)
             mStackedWidget->addWidget(view.get());
 
             mCurrentView = view;
+            this->touch(factory);
             emit viewChanged();
         }
     }
 }
 
+// Views that have not been shown recently are destroyed, they will be built again if selected.
+void SideTree::touch(const std::shared_ptr<ViewFactory>& factory)
+{
+    mRecentViews.removeOne(factory);
+    mRecentViews.prepend(factory);
+
+    while (mRecentViews.size() > maxViews)
+        mRecentViews.takeLast()->release();
+}
+
 }
 }
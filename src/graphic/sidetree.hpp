@@ -33,7 +33,7 @@ class SideTree : public QWidget
     Q_OBJECT
 
 public:
-    SideTree(std::shared_ptr<TreeNodeModel> model, const std::shared_ptr<View>& firstView);
+    SideTree(std::shared_ptr<TreeNodeModel> model, const std::shared_ptr<ViewFactory>& firstView);
 
     std::shared_ptr<View> currentView();
 
@@ -46,14 +46,16 @@ private slots:
 
 private:
     bool eventFilter(QObject* obj, QEvent* event);
+    void touch(const std::shared_ptr<ViewFactory>& factory);
 
     QVBoxLayout* mLayout;
     QSplitter* mSplitter;
     QTreeView* mTreeView;
     QStackedWidget* mStackedWidget;
-    QStandardItemModel* mItemModel;
-    TreeModel mModel;
+    TreeModel* mModel;
     std::shared_ptr<View> mCurrentView;
+    // most recently shown first
+    QList<std::shared_ptr<ViewFactory> > mRecentViews;
 };
 
 }
@@ -0,0 +1,70 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_TREEITEMMODEL_HPP
+#define TYREX_TREEITEMMODEL_HPP
+
+#include "misc/tree.hpp"
+#include <QAbstractItemModel>
+#include <QHash>
+
+namespace tyrex {
+namespace graphic {
+
+// Item model reading a Tree directly, without copying it into items.
+// An index points to the node holding the row ; nodes only get a back-link to their parent once a view asks for their
+// children, so that memory follows what has been expanded rather than the size of the tree.
+template <typename LeafT, typename NodeT>
+class TreeItemModel : public QAbstractItemModel
+{
+public:
+    TreeItemModel(const NodeT& root, bool subtreesFirst, QObject* parent = 0);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex& child) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+
+protected:
+    // null if the index is a leaf ; the root for an invalid index
+    const NodeT* subtree(const QModelIndex& index) const;
+    // null if the index is a subtree
+    const TreeLeaf<LeafT>* leaf(const QModelIndex& index) const;
+    QString title(const QModelIndex& index) const;
+
+private:
+    struct Location
+    {
+        const NodeT* mParent;
+        int mRow;
+    };
+
+    inline const NodeT* node(const QModelIndex& index) const;
+
+    const NodeT& mRoot;
+    bool mSubtreesFirst;
+    mutable QHash<const NodeT*, Location> mLocations;
+};
+
+template <typename LeafT, typename NodeT>
+inline const NodeT* TreeItemModel<LeafT, NodeT>::node(const QModelIndex& index) const
+    {return static_cast<const NodeT*>(index.internalPointer());}
+
+}
+}
+
+#endif // TYREX_TREEITEMMODEL_HPP
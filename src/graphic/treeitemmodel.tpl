@@ -0,0 +1,126 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_TREEITEMMODEL_TPL
+#define TYREX_TREEITEMMODEL_TPL
+
+#include "treeitemmodel.hpp"
+
+namespace tyrex {
+namespace graphic {
+
+template <typename LeafT, typename NodeT>
+TreeItemModel<LeafT, NodeT>::TreeItemModel(const NodeT& root, bool subtreesFirst, QObject* parent) :
+    QAbstractItemModel(parent),
+    mRoot(root),
+    mSubtreesFirst(subtreesFirst)
+{
+}
+
+
+template <typename LeafT, typename NodeT>
+QModelIndex TreeItemModel<LeafT, NodeT>::index(int row, int column, const QModelIndex& parent) const
+{
+    const NodeT* node = this->subtree(parent);
+    if (!node || row < 0 || column < 0 || row >= node->mSubtrees.size() + node->mLeaves.size() || column >= this->columnCount(parent))
+        return QModelIndex();
+
+    if (parent.isValid() && !mLocations.contains(node))
+    {
+        Location location;
+        location.mParent = this->node(parent);
+        location.mRow = parent.row();
+        mLocations.insert(node, location);
+    }
+
+    return this->createIndex(row, column, const_cast<NodeT*>(node));
+}
+
+template <typename LeafT, typename NodeT>
+QModelIndex TreeItemModel<LeafT, NodeT>::parent(const QModelIndex& child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+
+    const NodeT* node = this->node(child);
+    if (node == &mRoot)
+        return QModelIndex();
+
+    Location location = mLocations.value(node);
+    return this->createIndex(location.mRow, 0, const_cast<NodeT*>(location.mParent));
+}
+
+template <typename LeafT, typename NodeT>
+int TreeItemModel<LeafT, NodeT>::rowCount(const QModelIndex& parent) const
+{
+    if (parent.column() > 0)
+        return 0;
+
+    const NodeT* node = this->subtree(parent);
+    if (!node)
+        return 0;
+    return node->mSubtrees.size() + node->mLeaves.size();
+}
+
+
+template <typename LeafT, typename NodeT>
+const NodeT* TreeItemModel<LeafT, NodeT>::subtree(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return &mRoot;
+
+    const NodeT* node = this->node(index);
+    int row = index.row();
+
+    if (!mSubtreesFirst)
+        row -= node->mLeaves.size();
+    if (row < 0 || row >= node->mSubtrees.size())
+        return 0;
+    return node->mSubtrees[row].get();
+}
+
+template <typename LeafT, typename NodeT>
+const TreeLeaf<LeafT>* TreeItemModel<LeafT, NodeT>::leaf(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return 0;
+
+    const NodeT* node = this->node(index);
+    int row = index.row();
+
+    if (mSubtreesFirst)
+        row -= node->mSubtrees.size();
+    if (row < 0 || row >= node->mLeaves.size())
+        return 0;
+    return &node->mLeaves[row];
+}
+
+template <typename LeafT, typename NodeT>
+QString TreeItemModel<LeafT, NodeT>::title(const QModelIndex& index) const
+{
+    if (const TreeLeaf<LeafT>* leaf = this->leaf(index))
+        return leaf->mTitle;
+    if (const NodeT* subtree = this->subtree(index))
+        return subtree->mTitle;
+    return QString();
+}
+
+}
+}
+
+#endif // TYREX_TREEITEMMODEL_TPL
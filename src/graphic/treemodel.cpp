@@ -18,61 +18,85 @@
 
 #include "treemodel.hpp"
 
+#include "misc/profiler.hpp"
+
 namespace tyrex {
 namespace graphic {
 
-QStandardItem* TreeNodeModel::makeTreeModel(QStandardItem* rootItem, QMap<QStandardItem*, std::shared_ptr<View> >& itemToView, const std::shared_ptr<View>& firstView, bool& firstViewFound) const
+std::shared_ptr<ViewFactory> TreeNodeModel::appendView(QString title, const ViewFactory::Maker& maker)
 {
-    QStandardItem* firstItem = 0;
+    std::shared_ptr<ViewFactory> factory = std::make_shared<ViewFactory>(maker);
+    this->appendLeaf(title, factory);
+    return factory;
+}
 
-    for (auto& leaf : mLeaves)
-    {
-        QStandardItem* item = new QStandardItem(leaf.mTitle);
-        rootItem->appendRow(item);
-        itemToView[item] = leaf.mContent;
 
-        if (leaf.mContent == firstView)
+TreeModel::TreeModel(std::shared_ptr<TreeNodeModel> root, const std::shared_ptr<ViewFactory>& firstView, QObject* parent) :
+    TreeItemModel<std::shared_ptr<ViewFactory>, TreeNodeModel>(*root, false, parent),
+    mRoot(root)
+{
+    Profiler::Scope scope("item model");
+    bool found = false;
+    mFirstItem = this->findItem(QModelIndex(), firstView, found);
+}
+
+
+int TreeModel::columnCount(const QModelIndex&) const
+{
+    return 1;
+}
+
+QVariant TreeModel::data(const QModelIndex& index, int role) const
+{
+    if (role == Qt::DisplayRole)
+        return this->title(index);
+    return QVariant();
+}
+
+
+std::shared_ptr<ViewFactory> TreeModel::factoryForIndex(const QModelIndex& index) const
+{
+    if (const TreeLeafModel* leaf = this->leaf(index))
+        return leaf->mContent;
+    return std::shared_ptr<ViewFactory>();
+}
+
+// The leaf showing the given view, or else the first leaf in depth-first order.
+QModelIndex TreeModel::findItem(const QModelIndex& parent, const std::shared_ptr<ViewFactory>& view, bool& found) const
+{
+    const TreeNodeModel* node = this->subtree(parent);
+    int leafCount = node->mLeaves.size();
+    Profiler::count(Profiler::treeNodes, leafCount + node->mSubtrees.size());
+
+    for (int i = 0 ; i < leafCount ; ++i)
+    {
+        if (node->mLeaves[i].mContent == view)
         {
-            firstViewFound = true;
-            firstItem = item;
+            found = true;
+            return this->index(i, 0, parent);
         }
-        else if (!firstItem)
-            firstItem = item;
     }
 
-    for (auto& subtree : mSubtrees)
-    {
-        QStandardItem* item = new QStandardItem(subtree->mTitle);
-        rootItem->appendRow(item);
-        itemToView[item] = std::shared_ptr<View>();
+    QModelIndex firstItem;
+    if (leafCount)
+        firstItem = this->index(0, 0, parent);
 
-        bool found = false;
-        item = subtree->makeTreeModel(item, itemToView, firstView, found);
+    for (int i = 0 ; i < node->mSubtrees.size() ; ++i)
+    {
+        bool subtreeFound = false;
+        QModelIndex item = this->findItem(this->index(leafCount + i, 0, parent), view, subtreeFound);
 
-        if (found)
+        if (subtreeFound)
         {
-            firstViewFound = true;
-            firstItem = item;
+            found = true;
+            return item;
         }
-        else if (!firstItem)
+        else if (!firstItem.isValid())
             firstItem = item;
     }
 
     return firstItem;
 }
 
-
-TreeModel::TreeModel(std::shared_ptr<TreeNodeModel> root, QStandardItemModel& model, const std::shared_ptr<View>& firstView) :
-    mRoot(root)
-{
-    bool found;
-    mFirstItem = model.indexFromItem(mRoot->makeTreeModel(model.invisibleRootItem(), mItemToView, firstView, found));
-}
-
-std::shared_ptr<View> TreeModel::viewForItem(QStandardItem* item) const
-{
-    return mItemToView[item];
-}
-
 }
 }
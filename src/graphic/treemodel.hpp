@@ -20,39 +20,43 @@
 #define TYREX_TREEMODEL_HPP
 
 #include "misc/tree.tpl"
-#include "view/view.hpp"
+#include "treeitemmodel.tpl"
+#include "viewfactory.hpp"
 #include <QString>
-#include <QStandardItemModel>
 
 namespace tyrex {
 namespace graphic {
 
-// A leaf of the tree is a view associated with a title.
-typedef TreeLeaf<std::shared_ptr<View> > TreeLeafModel;
+// A leaf of the tree is a view (built on demand) associated with a title.
+typedef TreeLeaf<std::shared_ptr<ViewFactory> > TreeLeafModel;
 
 // A node of the tree is labelled with a title.
-class TreeNodeModel : public TreeNode<std::shared_ptr<View>, TreeNodeModel>
+class TreeNodeModel : public TreeNode<std::shared_ptr<ViewFactory>, TreeNodeModel>
 {
 public:
     inline TreeNodeModel(QString title) :
-        TreeNode<std::shared_ptr<View>, TreeNodeModel>(title) {}
+        TreeNode<std::shared_ptr<ViewFactory>, TreeNodeModel>(title) {}
 
-    QStandardItem* makeTreeModel(QStandardItem* rootItem, QMap<QStandardItem*, std::shared_ptr<View> >& itemToView, const std::shared_ptr<View>& firstView, bool& firstViewFound) const;
+    std::shared_ptr<ViewFactory> appendView(QString title, const ViewFactory::Maker& maker);
 };
 
-// A tree of views.
-class TreeModel
+// A tree of views, as an item model listing the titles.
+class TreeModel : public TreeItemModel<std::shared_ptr<ViewFactory>, TreeNodeModel>
 {
 public:
-    TreeModel(std::shared_ptr<TreeNodeModel> root, QStandardItemModel& model, const std::shared_ptr<View>& firstView = std::shared_ptr<View>());
+    TreeModel(std::shared_ptr<TreeNodeModel> root, const std::shared_ptr<ViewFactory>& firstView = std::shared_ptr<ViewFactory>(), QObject* parent = 0);
+
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
 
     inline QModelIndex firstItem() const;
-    std::shared_ptr<View> viewForItem(QStandardItem* item) const;
+    std::shared_ptr<ViewFactory> factoryForIndex(const QModelIndex& index) const;
 
 private:
+    QModelIndex findItem(const QModelIndex& parent, const std::shared_ptr<ViewFactory>& view, bool& found) const;
+
     std::shared_ptr<TreeNodeModel> mRoot;
     QModelIndex mFirstItem;
-    QMap<QStandardItem*, std::shared_ptr<View> > mItemToView;
 };
 
 inline QModelIndex TreeModel::firstItem() const
@@ -0,0 +1,239 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "entropystrip.hpp"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QThread>
+#include <QToolTip>
+#include "misc/bytestats.hpp"
+#include "misc/util.hpp"
+#include <algorithm>
+
+namespace tyrex {
+namespace graphic {
+
+static const unsigned int windowsPerBlock = 64;
+// default window size, so that large chunks have about this many windows
+static const unsigned int targetWindowCount = 8192;
+static const unsigned int minWindowSize = 256;
+static const int stripWidth = 16;
+
+
+EntropyStrip::EntropyStrip(const MemChunk& chunk, QWidget* parent) :
+    QWidget(parent),
+    mChunk(chunk),
+    mWindowSize(minWindowSize),
+    mStarted(false),
+    mNextBlock(0),
+    mCancelled(false),
+    mVisibleStart(0),
+    mVisibleSize(0)
+{
+    while (mWindowSize < chunk.size() / targetWindowCount)
+        mWindowSize <<= 1;
+
+    this->setMouseTracking(true);
+    this->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
+}
+
+EntropyStrip::~EntropyStrip()
+{
+    this->stop();
+}
+
+
+void EntropyStrip::setWindowSize(unsigned int windowSize)
+{
+    this->stop();
+    mWindowSize = std::max(windowSize, 1u);
+    if (mStarted)
+        this->start();
+    this->update();
+}
+
+QSize EntropyStrip::sizeHint() const
+{
+    return QSize(stripWidth, 0);
+}
+
+void EntropyStrip::setVisibleRange(quint64 start, quint64 size)
+{
+    mVisibleStart = start;
+    mVisibleSize = size;
+    this->update();
+}
+
+
+void EntropyStrip::start()
+{
+    mStarted = true;
+    mWindows.assign(this->windowCount(), Window());
+    mBlockDone.reset(new std::atomic<bool>[this->blockCount()]);
+    for (unsigned int i = 0 ; i < this->blockCount() ; ++i)
+        mBlockDone[i].store(false);
+    mNextBlock = 0;
+    mCancelled = false;
+
+    int threads = std::min<int>(QThread::idealThreadCount(), this->blockCount());
+    for (int i = 0 ; i < threads ; ++i)
+        mPool.start(new Task(*this));
+}
+
+void EntropyStrip::stop()
+{
+    mCancelled = true;
+    mPool.waitForDone();
+}
+
+unsigned int EntropyStrip::blockCount() const
+{
+    return (this->windowCount() + windowsPerBlock - 1) / windowsPerBlock;
+}
+
+
+EntropyStrip::Task::Task(EntropyStrip& strip) :
+    mStrip(strip)
+{
+}
+
+void EntropyStrip::Task::run()
+{
+    const unsigned char* data = mStrip.mChunk.data();
+    unsigned int size = mStrip.mChunk.size();
+    unsigned int windowSize = mStrip.mWindowSize;
+    unsigned int windowCount = mStrip.windowCount();
+    ByteStats stats;
+
+    for (unsigned int block ; !mStrip.mCancelled && (block = mStrip.mNextBlock++) < mStrip.blockCount() ; )
+    {
+        unsigned int end = std::min((block + 1) * windowsPerBlock, windowCount);
+        for (unsigned int i = block * windowsPerBlock ; i < end ; ++i)
+        {
+            unsigned int start = i * windowSize;
+            stats.compute(data + start, std::min(windowSize, size - start));
+
+            Window& window = mStrip.mWindows[i];
+            window.mEntropy = stats.entropy();
+            window.mChiSquare = stats.chiSquare();
+            window.mMode = stats.mode();
+        }
+
+        mStrip.mBlockDone[block].store(true, std::memory_order_release);
+        // repaints are merged by Qt, and the strip outlives its tasks
+        QMetaObject::invokeMethod(&mStrip, "update", Qt::QueuedConnection);
+    }
+}
+
+
+void EntropyStrip::showEvent(QShowEvent*)
+{
+    if (!mStarted)
+        this->start();
+}
+
+void EntropyStrip::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.fillRect(this->rect(), Qt::lightGray);
+
+    int height = this->height();
+    unsigned int count = this->windowCount();
+    if (!count || height <= 0 || !mBlockDone)
+        return;
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        unsigned int first = uint64_t(y) * count / height;
+        unsigned int last = std::max<unsigned int>(first + 1, uint64_t(y + 1) * count / height);
+
+        // average of the windows already analysed
+        float sum = 0;
+        unsigned int done = 0;
+        for (unsigned int i = first ; i < last ; ++i)
+        {
+            if (mBlockDone[i / windowsPerBlock].load(std::memory_order_acquire))
+            {
+                sum += mWindows[i].mEntropy;
+                ++done;
+            }
+        }
+
+        if (done)
+            painter.fillRect(0, y, this->width(), 1, EntropyStrip::color(sum / done));
+    }
+
+    if (mVisibleSize && mChunk.size())
+    {
+        int top = std::min<uint64_t>(mVisibleStart, mChunk.size()) * height / mChunk.size();
+        int bottom = std::min<uint64_t>(mVisibleStart + mVisibleSize, mChunk.size()) * height / mChunk.size();
+        painter.setPen(Qt::black);
+        painter.drawRect(0, top, this->width() - 1, std::max(bottom - top, 2) - 1);
+    }
+}
+
+void EntropyStrip::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || !mChunk.size())
+    {
+        event->ignore();
+        return;
+    }
+
+    emit offsetClicked(this->offsetAt(event->pos().y()));
+}
+
+void EntropyStrip::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!mChunk.size() || !mBlockDone)
+        return;
+
+    if (event->buttons() & Qt::LeftButton)
+        emit offsetClicked(this->offsetAt(event->pos().y()));
+
+    unsigned int offset = this->offsetAt(event->pos().y());
+    unsigned int i = offset / mWindowSize;
+    QString text = "0x" + Util::numToHex(i * mWindowSize, 8);
+    if (mBlockDone[i / windowsPerBlock].load(std::memory_order_acquire))
+    {
+        const Window& window = mWindows[i];
+        text += QString("\nentropy : %1 bits/byte\nchi-square : %2\nmost frequent : 0x%3")
+                .arg(window.mEntropy, 0, 'f', 3)
+                .arg(window.mChiSquare, 0, 'f', 1)
+                .arg(Util::numToHex(window.mMode, 2));
+    }
+    QToolTip::showText(event->globalPos(), text, this);
+}
+
+
+unsigned int EntropyStrip::offsetAt(int y) const
+{
+    y = std::max(0, std::min(y, this->height() - 1));
+    return std::min<uint64_t>(uint64_t(y) * mChunk.size() / this->height(), mChunk.size() - 1);
+}
+
+// blue for padding, green for text and code, red for compressed or encrypted data
+QColor EntropyStrip::color(float entropy)
+{
+    float t = std::max(0.0f, std::min(entropy / 8, 1.0f));
+    return QColor::fromHsvF((1 - t) * 2.0 / 3, 0.9, 0.95);
+}
+
+}
+}
@@ -0,0 +1,112 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_ENTROPYSTRIP_HPP
+#define TYREX_ENTROPYSTRIP_HPP
+
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWidget>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "misc/memchunk.hpp"
+
+namespace tyrex {
+namespace graphic {
+
+// A vertical map of the entropy of a chunk, window after window, drawn next to a hex view.
+// The whole chunk is mapped to the height of the strip ; the range shown by the hex view is framed, and a click jumps to an offset.
+// Windows are analysed in the background, by blocks, and the map fills in as they complete.
+class EntropyStrip : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit EntropyStrip(const MemChunk& chunk, QWidget* parent = 0);
+    ~EntropyStrip();
+
+    inline unsigned int windowSize() const;
+    // restarts the analysis
+    void setWindowSize(unsigned int windowSize);
+
+    QSize sizeHint() const;
+
+public slots:
+    void setVisibleRange(quint64 start, quint64 size);
+
+signals:
+    void offsetClicked(quint64 offset);
+
+private:
+    struct Window
+    {
+        float mEntropy;
+        float mChiSquare;
+        unsigned char mMode;
+    };
+
+    // analyses blocks of windows until there is none left
+    class Task : public QRunnable
+    {
+    public:
+        explicit Task(EntropyStrip& strip);
+
+        void run();
+
+    private:
+        EntropyStrip& mStrip;
+    };
+
+    void start();
+    void stop();
+
+    void showEvent(QShowEvent* event);
+    void paintEvent(QPaintEvent* event);
+    void mousePressEvent(QMouseEvent* event);
+    void mouseMoveEvent(QMouseEvent* event);
+
+    inline unsigned int windowCount() const;
+    unsigned int blockCount() const;
+    unsigned int offsetAt(int y) const;
+    static QColor color(float entropy);
+
+    MemChunk mChunk;
+    unsigned int mWindowSize;
+    bool mStarted;
+
+    std::vector<Window> mWindows;
+    // a block of windows is read only once its flag is set
+    std::unique_ptr<std::atomic<bool>[]> mBlockDone;
+    std::atomic<unsigned int> mNextBlock;
+    std::atomic<bool> mCancelled;
+    QThreadPool mPool;
+
+    uint64_t mVisibleStart;
+    uint64_t mVisibleSize;
+};
+
+inline unsigned int EntropyStrip::windowSize() const
+    {return mWindowSize;}
+inline unsigned int EntropyStrip::windowCount() const
+    {return (mChunk.size() + mWindowSize - 1) / mWindowSize;}
+
+}
+}
+
+#endif // TYREX_ENTROPYSTRIP_HPP
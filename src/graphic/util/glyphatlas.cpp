@@ -0,0 +1,88 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "glyphatlas.hpp"
+
+#include <QFontMetrics>
+#include <QImage>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace tyrex {
+namespace graphic {
+
+GlyphAtlas::GlyphAtlas(const QFont& font, qreal pixelRatio, const QColor& text) :
+    mPixelRatio(pixelRatio)
+{
+    QFont boldFont = font;
+    boldFont.setBold(true);
+
+    QFontMetrics metrics(font);
+    QFontMetrics boldMetrics(boldFont);
+
+    // bold glyphs may be slightly wider, they overlap the next cell as with drawText
+    mAscent = std::max(metrics.ascent(), boldMetrics.ascent());
+    mCellWidth = std::ceil(std::max(metrics.width("0"), boldMetrics.maxWidth()) * pixelRatio);
+    mCellHeight = std::ceil((mAscent + std::max(metrics.descent(), boldMetrics.descent())) * pixelRatio);
+
+    QImage image((lastChar - firstChar + 1) * mCellWidth, styleCount * mCellHeight, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.scale(pixelRatio, pixelRatio);
+
+    const QFont* fonts[styleCount] = {&font, &boldFont, &boldFont};
+    const QColor colors[styleCount] = {text, Qt::yellow, Qt::white};
+    for (int style = 0 ; style < styleCount ; ++style)
+    {
+        painter.setFont(*fonts[style]);
+        painter.setPen(colors[style]);
+        for (unsigned int c = firstChar ; c <= lastChar ; ++c)
+            painter.drawText(QPointF((c - firstChar) * mCellWidth / pixelRatio, style * mCellHeight / pixelRatio + mAscent), QString(QChar(c)));
+    }
+    painter.end();
+
+    mPixmap = QPixmap::fromImage(image);
+}
+
+std::shared_ptr<const GlyphAtlas> GlyphAtlas::get(const QFont& font, qreal pixelRatio, const QColor& text)
+{
+    // pixmaps belong to the GUI thread, so does the cache
+    static std::map<std::pair<std::pair<QString, qreal>, QRgb>, std::shared_ptr<const GlyphAtlas> > atlases;
+
+    std::shared_ptr<const GlyphAtlas>& atlas = atlases[std::make_pair(std::make_pair(font.key(), pixelRatio), text.rgba())];
+    if (!atlas)
+        atlas.reset(new GlyphAtlas(font, pixelRatio, text));
+    return atlas;
+}
+
+
+GlyphAtlas::Batch::Batch(const std::shared_ptr<const GlyphAtlas>& atlas) :
+    mAtlas(atlas)
+{
+}
+
+void GlyphAtlas::Batch::draw(QPainter& painter) const
+{
+    if (!mFragments.empty())
+        painter.drawPixmapFragments(mFragments.data(), mFragments.size(), mAtlas->mPixmap);
+}
+
+}
+}
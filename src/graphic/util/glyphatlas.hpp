@@ -0,0 +1,114 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_GLYPHATLAS_HPP
+#define TYREX_GLYPHATLAS_HPP
+
+#include <QColor>
+#include <QFont>
+#include <QPainter>
+#include <QPixmap>
+#include <memory>
+#include <vector>
+
+namespace tyrex {
+namespace graphic {
+
+// The printable ASCII characters of a font, rasterized once in each style into a single pixmap.
+// Text made of these characters is drawn by blitting parts of the pixmap, in one call per frame (see Batch),
+// which is much cheaper than laying out each character with QPainter::drawText.
+class GlyphAtlas
+{
+public:
+    enum Style {
+        // in the text colour given to get()
+        normal,
+        // bold yellow, for search results
+        found,
+        // bold white, under the cursor
+        cursor,
+        styleCount
+    };
+
+    // atlases are shared by all widgets with the same font, pixel ratio and text colour
+    static std::shared_ptr<const GlyphAtlas> get(const QFont& font, qreal pixelRatio, const QColor& text);
+
+    inline int ascent() const;
+    inline const QPixmap& pixmap() const;
+    // characters out of the printable range are drawn as '?'
+    inline QRectF source(Style style, unsigned char c) const;
+
+    // Characters to draw with an atlas, in a single call to draw().
+    class Batch
+    {
+    public:
+        explicit Batch(const std::shared_ptr<const GlyphAtlas>& atlas);
+
+        inline void clear();
+        // (x, baseline) as for QPainter::drawText
+        inline void add(Style style, qreal x, qreal baseline, unsigned char c);
+        void draw(QPainter& painter) const;
+
+    private:
+        std::shared_ptr<const GlyphAtlas> mAtlas;
+        std::vector<QPainter::PixmapFragment> mFragments;
+    };
+
+private:
+    GlyphAtlas(const QFont& font, qreal pixelRatio, const QColor& text);
+
+    static const unsigned char firstChar = 0x20;
+    static const unsigned char lastChar = 0x7E;
+
+    qreal mPixelRatio;
+    // cell size in device pixels
+    int mCellWidth;
+    int mCellHeight;
+    int mAscent;
+    QPixmap mPixmap;
+};
+
+inline int GlyphAtlas::ascent() const
+    {return mAscent;}
+inline const QPixmap& GlyphAtlas::pixmap() const
+    {return mPixmap;}
+
+inline QRectF GlyphAtlas::source(Style style, unsigned char c) const
+{
+    if (c < firstChar || c > lastChar)
+        c = '?';
+    return QRectF((c - firstChar) * mCellWidth, style * mCellHeight, mCellWidth, mCellHeight);
+}
+
+inline void GlyphAtlas::Batch::clear()
+    {mFragments.clear();}
+
+inline void GlyphAtlas::Batch::add(Style style, qreal x, qreal baseline, unsigned char c)
+{
+    QRectF source = mAtlas->source(style, c);
+    qreal scale = 1 / mAtlas->mPixelRatio;
+    // fragments are positioned by their center
+    mFragments.push_back(QPainter::PixmapFragment::create(
+            QPointF(x + source.width() * scale / 2, baseline - mAtlas->mAscent + source.height() * scale / 2),
+            source, scale, scale));
+}
+
+}
+}
+
+#endif // TYREX_GLYPHATLAS_HPP
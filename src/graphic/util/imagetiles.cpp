@@ -0,0 +1,473 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "imagetiles.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace tyrex {
+namespace graphic {
+
+static const unsigned int tileSize = 256;
+// the first level with at most this many pixels is the overview (16 MiB in ARGB32)
+static const uint64_t overviewPixels = 4 * 1024 * 1024;
+static const std::size_t maxCacheBytes = 64 * 1024 * 1024;
+// the overview task checks for cancellation this often while it waits for rows
+static const std::chrono::milliseconds waitInterval(50);
+
+
+// Each pixel of rect (in pixels of the downscaled image) averages a block of 2^shift x 2^shift source pixels, or what is left of it on the edges.
+// rows(y, x, count, dst) reads count ARGB32 pixels of source row y from column x ; rowDone(n) is called when n rows of dst are complete.
+// Returns false if cancelled.
+template <typename Rows, typename RowDone>
+static bool downscale(Rows rows, unsigned int width, unsigned int height, unsigned int shift, const QRect& rect, uint32_t* dst, unsigned int stride, const std::atomic<bool>& cancelled, RowDone rowDone)
+{
+    unsigned int x = rect.x() << shift;
+    unsigned int count = std::min<uint64_t>(uint64_t(rect.width()) << shift, width - x);
+    std::vector<uint32_t> line(count);
+    std::vector<uint32_t> sums(4 * rect.width());
+
+    for (int i = 0 ; i < rect.height() ; ++i, dst += stride)
+    {
+        if (cancelled)
+            return false;
+
+        unsigned int y = (rect.y() + i) << shift;
+        if (!shift)
+        {
+            rows(y, x, count, dst);
+            rowDone(i + 1);
+            continue;
+        }
+
+        unsigned int rowCount = std::min(1u << shift, height - y);
+        std::fill(sums.begin(), sums.end(), 0);
+        for (unsigned int j = 0 ; j < rowCount ; ++j)
+        {
+            rows(y + j, x, count, line.data());
+            for (unsigned int k = 0 ; k < count ; ++k)
+            {
+                uint32_t pixel = line[k];
+                uint32_t* sum = &sums[4 * (k >> shift)];
+                sum[0] += pixel >> 24;
+                sum[1] += (pixel >> 16) & 0xFF;
+                sum[2] += (pixel >> 8) & 0xFF;
+                sum[3] += pixel & 0xFF;
+            }
+        }
+
+        for (int k = 0 ; k < rect.width() ; ++k)
+        {
+            unsigned int n = rowCount * std::min(1u << shift, count - (k << shift));
+            const uint32_t* sum = &sums[4 * k];
+            dst[k] = ((sum[0] / n) << 24) ^ ((sum[1] / n) << 16) ^ ((sum[2] / n) << 8) ^ (sum[3] / n);
+        }
+        rowDone(i + 1);
+    }
+
+    return true;
+}
+
+
+ImageTiles::ImageTiles(const std::shared_ptr<data::Pixmap>& pixmap, const std::shared_ptr<data::PixmapProgress>& progress, QWidget* widget) :
+    mPixmap(pixmap),
+    mProgress(progress),
+    mWidget(widget),
+    mStarted(false),
+    mPreviewCount(0),
+    mPreviewShift(0),
+    mLevelCount(1),
+    mOverviewLevel(0),
+    mOverviewRows(0),
+    mLevelsDone(0),
+    mCacheBytes(0),
+    mPaint(0),
+    mWorkers(0),
+    mCancelled(false)
+{
+    if (!mPixmap->width() || !mPixmap->height())
+        return;
+
+    // the coarsest level fits in a tile
+    while (this->levelWidth(mLevelCount - 1) > tileSize || this->levelHeight(mLevelCount - 1) > tileSize)
+        ++mLevelCount;
+    while (uint64_t(this->levelWidth(mOverviewLevel)) * this->levelHeight(mOverviewLevel) > overviewPixels)
+        ++mOverviewLevel;
+
+    for (unsigned int level = mOverviewLevel ; level < mLevelCount ; ++level)
+    {
+        QImage image;
+        if (level == 0)
+            image = ImageTiles::wrap(*mPixmap);
+
+        if (image.isNull())
+        {
+            image = QImage(this->levelWidth(level), this->levelHeight(level), QImage::Format_ARGB32);
+            mLevelBits.push_back(reinterpret_cast<uint32_t*>(image.bits()));
+        }
+        else
+        {
+            mLevelBits.push_back(nullptr);
+            mOverviewRows = image.height();
+            mLevelsDone = 1;
+        }
+        mLevels.push_back(image);
+    }
+}
+
+ImageTiles::~ImageTiles()
+{
+    mCancelled = true;
+    mPool.waitForDone();
+}
+
+
+void ImageTiles::draw(QPainter& painter, const QRectF& target, const QRectF& source)
+{
+    if (mLevels.empty() || source.isEmpty())
+        return;
+    if (!mStarted)
+        this->start();
+    this->drawPreview(painter, target, source);
+
+    double xscale = target.width() / source.width();
+    double yscale = target.height() / source.height();
+
+    // the finest level with no more than one pixel per pixel drawn
+    unsigned int level = 0;
+    while (level + 1 < mLevelCount && xscale * (2u << level) <= 1)
+        ++level;
+
+    if (level >= mOverviewLevel)
+    {
+        this->drawOverview(painter, target, source, level);
+        return;
+    }
+
+    unsigned int span = tileSize << level;
+    unsigned int tx0 = source.left() / span;
+    unsigned int ty0 = source.top() / span;
+    unsigned int tx1 = std::min<unsigned int>(std::ceil(source.right() / span), (this->levelWidth(level) + tileSize - 1) / tileSize);
+    unsigned int ty1 = std::min<unsigned int>(std::ceil(source.bottom() / span), (this->levelHeight(level) + tileSize - 1) / tileSize);
+
+    // tiles are built from final rows only, the others are left to the overview
+    unsigned int ready = this->readyRows();
+
+    std::vector<std::pair<QRectF, QImage> > found;
+    std::vector<std::pair<QRectF, uint64_t> > missing;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mPaint;
+
+        for (unsigned int ty = ty0 ; ty < ty1 ; ++ty)
+        {
+            for (unsigned int tx = tx0 ; tx < tx1 ; ++tx)
+            {
+                unsigned int x = tx * span;
+                unsigned int y = ty * span;
+                QRectF rect(x, y, std::min(span, mPixmap->width() - x), std::min(span, mPixmap->height() - y));
+
+                uint64_t key = ImageTiles::key(level, tx, ty);
+                std::map<uint64_t, Tile>::iterator it = mTiles.find(key);
+                if (it != mTiles.end())
+                {
+                    it->second.mLastUse = mPaint;
+                    found.push_back(std::make_pair(rect, it->second.mImage));
+                }
+                else
+                    missing.push_back(std::make_pair(rect, key));
+            }
+        }
+    }
+
+    std::vector<uint64_t> keys;
+    for (const std::pair<QRectF, uint64_t>& tile : missing)
+    {
+        QRectF rect = tile.first;
+        QRectF tileTarget(target.left() + (rect.left() - source.left()) * xscale, target.top() + (rect.top() - source.top()) * yscale, rect.width() * xscale, rect.height() * yscale);
+        this->drawOverview(painter, tileTarget, rect, mOverviewLevel);
+        if (rect.bottom() <= ready)
+            keys.push_back(tile.second);
+    }
+    for (const std::pair<QRectF, QImage>& tile : found)
+    {
+        QRectF rect = tile.first;
+        QRectF tileTarget(target.left() + (rect.left() - source.left()) * xscale, target.top() + (rect.top() - source.top()) * yscale, rect.width() * xscale, rect.height() * yscale);
+        painter.drawImage(tileTarget, tile.second);
+    }
+
+    this->request(keys);
+}
+
+// Qt reads these formats as they are : the pixmap is drawn without conversion.
+QImage ImageTiles::wrap(const data::Pixmap& pixmap)
+{
+    int width = pixmap.width();
+    int height = pixmap.height();
+
+    switch (pixmap.type())
+    {
+    case data::Pixmap::rgb24:
+        return QImage(pixmap.pixels(), width, height, pixmap.linesize(), QImage::Format_RGB888);
+#if QT_VERSION >= 0x050200
+    case data::Pixmap::rgba32:
+        return QImage(pixmap.pixels(), width, height, pixmap.linesize(), QImage::Format_RGBA8888);
+#endif
+#if QT_VERSION >= 0x050500
+    case data::Pixmap::grey8:
+        return QImage(pixmap.pixels(), width, height, pixmap.linesize(), QImage::Format_Grayscale8);
+#endif
+    default:
+        return QImage();
+    }
+}
+
+
+void ImageTiles::start()
+{
+    mStarted = true;
+    if (mLevelsDone < mLevels.size())
+        mPool.start(new OverviewTask(*this));
+}
+
+// The preview is drawn until the first overview level is complete, and dropped then.
+void ImageTiles::drawPreview(QPainter& painter, const QRectF& target, const QRectF& source)
+{
+    if (!mProgress)
+        return;
+    if (mLevelsDone.load(std::memory_order_acquire) && (mLevelBits[0] || this->readyRows() == mPixmap->height()))
+    {
+        mPreview = QImage();
+        return;
+    }
+
+    unsigned int count = mProgress->previewCount();
+    if (count != mPreviewCount)
+    {
+        mPreviewCount = count;
+        std::shared_ptr<data::Pixmap> preview = mProgress->preview(mPreviewShift);
+        if (preview)
+        {
+            mPreview = QImage(preview->width(), preview->height(), QImage::Format_ARGB32);
+            for (int y = 0 ; y < mPreview.height() ; ++y)
+                preview->rowARGB32(y, reinterpret_cast<uint32_t*>(mPreview.scanLine(y)));
+        }
+    }
+
+    if (mPreview.isNull())
+        return;
+    double factor = 1.0 / (1u << mPreviewShift);
+    painter.drawImage(target, mPreview, QRectF(source.left() * factor, source.top() * factor, source.width() * factor, source.height() * factor));
+}
+
+// Draws from the overview level closest to level among those built so far ; the rows of the first one appear as they are built.
+void ImageTiles::drawOverview(QPainter& painter, const QRectF& target, const QRectF& source, unsigned int level)
+{
+    unsigned int done = mLevelsDone.load(std::memory_order_acquire);
+    unsigned int i = std::min(level - mOverviewLevel, done ? done - 1 : 0);
+    level = mOverviewLevel + i;
+    unsigned int rows = i < done ? this->levelHeight(level) : mOverviewRows.load(std::memory_order_acquire);
+    // a level sharing the pixels of the pixmap has its final rows
+    if (!mLevelBits[i])
+        rows = std::min(rows, this->readyRows());
+
+    double factor = 1.0 / (1u << level);
+    QRectF levelSource(source.left() * factor, source.top() * factor, source.width() * factor, source.height() * factor);
+    if (levelSource.top() >= rows)
+        return;
+
+    QRectF levelTarget = target;
+    if (levelSource.bottom() > rows)
+    {
+        levelTarget.setHeight(target.height() * (rows - levelSource.top()) / levelSource.height());
+        levelSource.setBottom(rows);
+    }
+    painter.drawImage(levelTarget, mLevels[i], levelSource);
+}
+
+void ImageTiles::request(const std::vector<uint64_t>& keys)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // previous requests are dropped : only the tiles of the last paint are wanted
+    mWanted.clear();
+    for (std::vector<uint64_t>::const_reverse_iterator it = keys.rbegin() ; it != keys.rend() ; ++it)
+        if (!mBusy.count(*it))
+            mWanted.push_back(*it);
+
+    int workers = std::min<int>(mPool.maxThreadCount(), mWanted.size());
+    for ( ; mWorkers < workers ; ++mWorkers)
+        mPool.start(new TileTask(*this));
+}
+
+QImage ImageTiles::buildTile(uint64_t key) const
+{
+    unsigned int level = key >> 48;
+    unsigned int x = (key & 0xFFFFFF) * tileSize;
+    unsigned int y = ((key >> 24) & 0xFFFFFF) * tileSize;
+
+    QRect rect(x, y, std::min(tileSize, this->levelWidth(level) - x), std::min(tileSize, this->levelHeight(level) - y));
+    QImage image(rect.size(), QImage::Format_ARGB32);
+    if (image.isNull())
+        return image;
+
+    const data::Pixmap& pixmap = *mPixmap;
+    if (!downscale([&pixmap](unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) {pixmap.rowARGB32(y, x, count, dst);},
+                   pixmap.width(), pixmap.height(), level, rect, reinterpret_cast<uint32_t*>(image.bits()), image.bytesPerLine() / 4,
+                   mCancelled, [](unsigned int) {}))
+        return QImage();
+    return image;
+}
+
+unsigned int ImageTiles::readyRows() const
+{
+    if (!mProgress || mProgress->finished())
+        return mPixmap->height();
+    return mProgress->rows();
+}
+
+void ImageTiles::readRows(unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) const
+{
+    while (!mCancelled)
+    {
+        if (!mProgress || mProgress->wait(y + 1, waitInterval))
+        {
+            mPixmap->rowARGB32(y, x, count, dst);
+            return;
+        }
+    }
+    std::fill(dst, dst + count, 0);
+}
+
+// Least recently drawn tiles go first, but not those of the current paint.
+void ImageTiles::evict()
+{
+    while (mCacheBytes > maxCacheBytes)
+    {
+        std::map<uint64_t, Tile>::iterator oldest = mTiles.end();
+        for (std::map<uint64_t, Tile>::iterator it = mTiles.begin() ; it != mTiles.end() ; ++it)
+            if (it->second.mLastUse < mPaint && (oldest == mTiles.end() || it->second.mLastUse < oldest->second.mLastUse))
+                oldest = it;
+
+        if (oldest == mTiles.end())
+            break;
+        mCacheBytes -= oldest->second.mImage.bytesPerLine() * oldest->second.mImage.height();
+        mTiles.erase(oldest);
+    }
+}
+
+
+ImageTiles::OverviewTask::OverviewTask(ImageTiles& tiles) :
+    mTiles(tiles)
+{
+}
+
+void ImageTiles::OverviewTask::run()
+{
+    // the pixmap may still be decoded : its rows are read once final
+    const data::Pixmap& pixmap = *mTiles.mPixmap;
+    const ImageTiles& tiles = mTiles;
+    QWidget* widget = mTiles.mWidget;
+
+    for (unsigned int i = mTiles.mLevelsDone ; i < mTiles.mLevels.size() ; ++i)
+    {
+        unsigned int level = mTiles.mOverviewLevel + i;
+        QRect rect(0, 0, mTiles.levelWidth(level), mTiles.levelHeight(level));
+        bool done;
+
+        if (i == 0)
+        {
+            // the first level is shown as it is built
+            std::atomic<unsigned int>& overviewRows = mTiles.mOverviewRows;
+            done = downscale([&tiles](unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) {tiles.readRows(y, x, count, dst);},
+                             pixmap.width(), pixmap.height(), level, rect, mTiles.mLevelBits[i], rect.width(), mTiles.mCancelled,
+                             [&overviewRows, widget](unsigned int rows) {
+                                 overviewRows.store(rows, std::memory_order_release);
+                                 if (rows % 64 == 0)
+                                     QMetaObject::invokeMethod(widget, "update", Qt::QueuedConnection);
+                             });
+        }
+        else if (level == 1)
+        {
+            done = downscale([&tiles](unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) {tiles.readRows(y, x, count, dst);},
+                             pixmap.width(), pixmap.height(), 1, rect, mTiles.mLevelBits[i], rect.width(), mTiles.mCancelled, [](unsigned int) {});
+        }
+        else
+        {
+            // halves the previous level
+            const uint32_t* bits = mTiles.mLevelBits[i - 1];
+            unsigned int width = mTiles.levelWidth(level - 1);
+            done = downscale([bits, width](unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) {std::copy(bits + uint64_t(y) * width + x, bits + uint64_t(y) * width + x + count, dst);},
+                             width, mTiles.levelHeight(level - 1), 1, rect, mTiles.mLevelBits[i], rect.width(), mTiles.mCancelled, [](unsigned int) {});
+        }
+
+        if (!done)
+            return;
+        mTiles.mLevelsDone.store(i + 1, std::memory_order_release);
+        QMetaObject::invokeMethod(widget, "update", Qt::QueuedConnection);
+    }
+}
+
+
+ImageTiles::TileTask::TileTask(ImageTiles& tiles) :
+    mTiles(tiles)
+{
+}
+
+void ImageTiles::TileTask::run()
+{
+    for (;;)
+    {
+        uint64_t key;
+        {
+            std::lock_guard<std::mutex> lock(mTiles.mMutex);
+            if (mTiles.mCancelled || mTiles.mWanted.empty())
+            {
+                --mTiles.mWorkers;
+                return;
+            }
+
+            key = mTiles.mWanted.back();
+            mTiles.mWanted.pop_back();
+            mTiles.mBusy.insert(key);
+        }
+
+        QImage image = mTiles.buildTile(key);
+
+        {
+            std::lock_guard<std::mutex> lock(mTiles.mMutex);
+            mTiles.mBusy.erase(key);
+            if (image.isNull())
+                continue;
+
+            Tile& tile = mTiles.mTiles[key];
+            tile.mImage = image;
+            tile.mLastUse = mTiles.mPaint;
+            mTiles.mCacheBytes += image.bytesPerLine() * image.height();
+            mTiles.evict();
+        }
+
+        // repaints are merged by Qt, and the widget outlives the tasks
+        QMetaObject::invokeMethod(mTiles.mWidget, "update", Qt::QueuedConnection);
+    }
+}
+
+}
+}
@@ -0,0 +1,149 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_IMAGETILES_HPP
+#define TYREX_IMAGETILES_HPP
+
+#include <QImage>
+#include <QPainter>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWidget>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "data/image/pixmap.hpp"
+#include "data/image/pixmapprogress.hpp"
+
+namespace tyrex {
+namespace graphic {
+
+// Levels of detail of a pixmap, to draw any part of it at any scale : level k is the pixmap downscaled by 2^k.
+// The coarse levels, from the first one small enough to be an overview, are built whole in the background.
+// Finer levels are cut into tiles, converted on demand by background tasks and kept in a cache of bounded size.
+// Until a tile is ready, the overview stands in for it ; the widget is updated as tiles complete.
+// While the pixmap is decoded (with a progress), only its final rows are drawn, over the preview of the decoder if there is one.
+class ImageTiles
+{
+public:
+    ImageTiles(const std::shared_ptr<data::Pixmap>& pixmap, const std::shared_ptr<data::PixmapProgress>& progress, QWidget* widget);
+    ~ImageTiles();
+
+    // Draws the rectangle source of the pixmap (in pixmap pixels) to the rectangle target.
+    void draw(QPainter& painter, const QRectF& target, const QRectF& source);
+
+    // Image sharing the pixels of the pixmap, for the formats that Qt reads as they are ; null for the others.
+    static QImage wrap(const data::Pixmap& pixmap);
+
+private:
+    // builds the overview levels, one after the other
+    class OverviewTask : public QRunnable
+    {
+    public:
+        explicit OverviewTask(ImageTiles& tiles);
+
+        void run();
+
+    private:
+        ImageTiles& mTiles;
+    };
+
+    // converts wanted tiles until there is none left
+    class TileTask : public QRunnable
+    {
+    public:
+        explicit TileTask(ImageTiles& tiles);
+
+        void run();
+
+    private:
+        ImageTiles& mTiles;
+    };
+
+    struct Tile
+    {
+        QImage mImage;
+        uint64_t mLastUse;
+    };
+
+    void start();
+    void drawPreview(QPainter& painter, const QRectF& target, const QRectF& source);
+    void drawOverview(QPainter& painter, const QRectF& target, const QRectF& source, unsigned int level);
+    void request(const std::vector<uint64_t>& keys);
+    QImage buildTile(uint64_t key) const;
+    void evict();
+
+    // rows of the pixmap which are final
+    unsigned int readyRows() const;
+    // reads count pixels of row y from column x once the row is final ; zeros if cancelled before
+    void readRows(unsigned int y, unsigned int x, unsigned int count, uint32_t* dst) const;
+
+    inline unsigned int levelWidth(unsigned int level) const;
+    inline unsigned int levelHeight(unsigned int level) const;
+    static inline uint64_t key(unsigned int level, unsigned int tx, unsigned int ty);
+
+    std::shared_ptr<data::Pixmap> mPixmap;
+    std::shared_ptr<data::PixmapProgress> mProgress;
+    QWidget* mWidget;
+    bool mStarted;
+
+    // preview of the decoder, converted on the first paint after it is published
+    unsigned int mPreviewCount;
+    QImage mPreview;
+    unsigned int mPreviewShift;
+
+    unsigned int mLevelCount;
+    // first level kept whole
+    unsigned int mOverviewLevel;
+    // levels from mOverviewLevel on ; allocated upfront and filled by the overview task
+    std::vector<QImage> mLevels;
+    std::vector<uint32_t*> mLevelBits;
+    // rows of the first overview level already built, then number of overview levels complete
+    std::atomic<unsigned int> mOverviewRows;
+    std::atomic<unsigned int> mLevelsDone;
+
+    // guards the tiles, the wanted and busy keys and the worker count
+    mutable std::mutex mMutex;
+    std::map<uint64_t, Tile> mTiles;
+    std::size_t mCacheBytes;
+    // stamp of the current paint : tiles drawn by it are not evicted
+    uint64_t mPaint;
+    // wanted keys, the next one last
+    std::vector<uint64_t> mWanted;
+    std::set<uint64_t> mBusy;
+    int mWorkers;
+
+    std::atomic<bool> mCancelled;
+    QThreadPool mPool;
+};
+
+inline unsigned int ImageTiles::levelWidth(unsigned int level) const
+    {return (uint64_t(mPixmap->width()) + (1u << level) - 1) >> level;}
+inline unsigned int ImageTiles::levelHeight(unsigned int level) const
+    {return (uint64_t(mPixmap->height()) + (1u << level) - 1) >> level;}
+inline uint64_t ImageTiles::key(unsigned int level, unsigned int tx, unsigned int ty)
+    {return (uint64_t(level) << 48) ^ (uint64_t(ty) << 24) ^ tx;}
+
+}
+}
+
+#endif // TYREX_IMAGETILES_HPP
@@ -0,0 +1,90 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "archivemodel.hpp"
+
+namespace tyrex {
+namespace graphic {
+
+ArchiveModel::ArchiveModel(const data::FileInfoFilter& fileInfoFilter, const data::ArchiveIndex& index, const Tree<data::File>& files, QObject* parent) :
+    TreeItemModel<data::File, Tree<data::File> >(files, true, parent),
+    mFileInfoFilter(fileInfoFilter),
+    mIndex(index)
+{
+}
+
+
+int ArchiveModel::columnCount(const QModelIndex&) const
+{
+    return mFileInfoFilter.mInfos.size();
+}
+
+QVariant ArchiveModel::data(const QModelIndex& index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid())
+        return QVariant();
+
+    if (index.column() == 0)
+        return this->title(index);
+
+    const TreeLeaf<data::File>* file = this->leaf(index);
+    if (!file)
+        return QVariant();
+    return mIndex.text(file->mContent.mRow, mFileInfoFilter.mInfos[index.column()].first);
+}
+
+QVariant ArchiveModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= this->columnCount())
+        return QVariant();
+    return data::FileInfo::infoToString(mFileInfoFilter.mInfos[section].first);
+}
+
+
+bool ArchiveModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    const TreeLeaf<data::File>* leftFile = this->leaf(left);
+    const TreeLeaf<data::File>* rightFile = this->leaf(right);
+
+    if (!leftFile || !rightFile)
+    {
+        if (leftFile || rightFile)
+            return !leftFile;
+        return this->title(left) < this->title(right);
+    }
+
+    if (left.column() == 0)
+        return leftFile->mTitle < rightFile->mTitle;
+    return mIndex.lessThan(leftFile->mContent.mRow, rightFile->mContent.mRow, mFileInfoFilter.mInfos[left.column()].first);
+}
+
+
+ArchiveSortModel::ArchiveSortModel(ArchiveModel* model, QObject* parent) :
+    QSortFilterProxyModel(parent),
+    mModel(model)
+{
+    this->setSourceModel(model);
+}
+
+bool ArchiveSortModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    return mModel->lessThan(left, right);
+}
+
+}
+}
@@ -0,0 +1,64 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_ARCHIVEMODEL_HPP
+#define TYREX_ARCHIVEMODEL_HPP
+
+#include "data/archiveindex.hpp"
+#include "data/file.hpp"
+#include "graphic/treeitemmodel.tpl"
+#include <QSortFilterProxyModel>
+
+namespace tyrex {
+namespace graphic {
+
+// Members of an archive, one column per visible metadata. Cells are formatted from the index when displayed.
+class ArchiveModel : public TreeItemModel<data::File, Tree<data::File> >
+{
+public:
+    ArchiveModel(const data::FileInfoFilter& fileInfoFilter, const data::ArchiveIndex& index, const Tree<data::File>& files, QObject* parent = 0);
+
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    // Folders come first, members are compared on raw values.
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const;
+
+private:
+    const data::FileInfoFilter& mFileInfoFilter;
+    const data::ArchiveIndex& mIndex;
+};
+
+// Sorts an ArchiveModel, one folder at a time when it is expanded.
+class ArchiveSortModel : public QSortFilterProxyModel
+{
+public:
+    ArchiveSortModel(ArchiveModel* model, QObject* parent = 0);
+
+protected:
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const;
+
+private:
+    ArchiveModel* mModel;
+};
+
+}
+}
+
+#endif // TYREX_ARCHIVEMODEL_HPP
@@ -21,22 +21,26 @@
 namespace tyrex {
 namespace graphic {
 
-ArchiveView::ArchiveView(const data::FileInfoFilter& fileInfoFilter, const Tree<data::File>& files, QWidget* parent) :
+ArchiveView::ArchiveView(const data::FileInfoFilter& fileInfoFilter, const data::ArchiveIndex& index, const Tree<data::File>& files, QWidget* parent) :
     View(parent),
     mFileInfoFilter(fileInfoFilter),
-    mFiles(files),
     mLayout(new QHBoxLayout(this)),
     mTreeView(new QTreeView),
     mHeaderView(mTreeView->header()),
-    mModelFiles(new QStandardItemModel(mTreeView))
+    mModelFiles(new ArchiveModel(fileInfoFilter, index, files, mTreeView)),
+    mSortModel(new ArchiveSortModel(mModelFiles, mTreeView))
 {
     mTreeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mTreeView->setUniformRowHeights(true);
 
     mLayout->setContentsMargins(QMargins());
     mLayout->addWidget(mTreeView);
 
-    this->makeTree();
-    mTreeView->setModel(mModelFiles);
+    mTreeView->setModel(mSortModel);
+
+    // keep the archive order until a column is clicked
+    mHeaderView->setSortIndicator(-1, Qt::AscendingOrder);
+    mTreeView->setSortingEnabled(true);
 
     for (unsigned int i = 0 ; i < mFileInfoFilter.mInfos.size() ; ++i)
         mHeaderView->setSectionHidden(i, !mFileInfoFilter.mInfos[i].second);
@@ -47,45 +51,5 @@ ArchiveView::ArchiveView(const data::FileInfoFilter& fileInfoFilter, const Tree<
 #endif
 }
 
-
-void ArchiveView::makeTree()
-{
-    QStringList titles;
-    for (auto& info : mFileInfoFilter.mInfos)
-        titles.append(data::FileInfo::infoToString(info.first));
-    mModelFiles->setHorizontalHeaderLabels(titles);
-
-    QStandardItem* root = mModelFiles->invisibleRootItem();
-
-    for (auto& subtree : mFiles.mSubtrees)
-        this->appendToTree(root, *subtree);
-    for (auto& leaf : mFiles.mLeaves)
-        this->appendToTree(root, leaf);
-}
-
-void ArchiveView::appendToTree(QStandardItem* root, const Tree<data::File>& folder)
-{
-    QStandardItem* item = new QStandardItem(folder.mTitle);
-
-    for (auto& subtree : folder.mSubtrees)
-        this->appendToTree(item, *subtree);
-    for (auto& leaf : folder.mLeaves)
-        this->appendToTree(item, leaf);
-
-    root->appendRow(item);
-}
-
-void ArchiveView::appendToTree(QStandardItem* root, const TreeLeaf<data::File>& file)
-{
-    QList<QStandardItem*> item;
-    const data::FileInfo& info = file.mContent.mInfo;
-
-    item.append(new QStandardItem(file.mTitle));
-    for (unsigned int i = 1 ; i < mFileInfoFilter.mInfos.size() ; ++i)
-        item.append(new QStandardItem(info[mFileInfoFilter.mInfos[i].first]));
-
-    root->appendRow(item);
-}
-
 }
 }
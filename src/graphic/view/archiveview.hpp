@@ -19,13 +19,11 @@
 #ifndef TYREX_ARCHIVEVIEW_HPP
 #define TYREX_ARCHIVEVIEW_HPP
 
-#include "data/file.hpp"
-#include "misc/tree.hpp"
+#include "archivemodel.hpp"
 #include "view.hpp"
 
 #include <QHBoxLayout>
 #include <QTreeView>
-#include <QStandardItemModel>
 #include <QHeaderView>
 
 namespace tyrex {
@@ -34,20 +32,16 @@ namespace graphic {
 class ArchiveView : public View
 {
 public:
-    ArchiveView(const data::FileInfoFilter& fileInfoFilter, const Tree<data::File>& files, QWidget* parent = 0);
+    ArchiveView(const data::FileInfoFilter& fileInfoFilter, const data::ArchiveIndex& index, const Tree<data::File>& files, QWidget* parent = 0);
 
 private:
-    void makeTree();
-    void appendToTree(QStandardItem* root, const Tree<data::File>& folder);
-    void appendToTree(QStandardItem* root, const TreeLeaf<data::File>& file);
-
     const data::FileInfoFilter& mFileInfoFilter;
-    const Tree<data::File>& mFiles;
 
     QHBoxLayout* mLayout;
     QTreeView* mTreeView;
     QHeaderView* mHeaderView;
-    QStandardItemModel* mModelFiles;
+    ArchiveModel* mModelFiles;
+    ArchiveSortModel* mSortModel;
 };
 
 }
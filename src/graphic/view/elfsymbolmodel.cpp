@@ -0,0 +1,56 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "elfsymbolmodel.hpp"
+
+namespace tyrex {
+namespace graphic {
+
+ElfSymbolModel::ElfSymbolModel(const std::shared_ptr<const data::ElfSymbols>& symbols, QObject* parent) :
+    QAbstractTableModel(parent),
+    mSymbols(symbols)
+{
+}
+
+
+int ElfSymbolModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : mSymbols->rowCount();
+}
+
+int ElfSymbolModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : data::ElfSymbols::columnCount;
+}
+
+QVariant ElfSymbolModel::data(const QModelIndex& index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid())
+        return QVariant();
+    return mSymbols->text(index.row(), static_cast<data::ElfSymbols::Column>(index.column()));
+}
+
+QVariant ElfSymbolModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= data::ElfSymbols::columnCount)
+        return QVariant();
+    return data::ElfSymbols::columnName(static_cast<data::ElfSymbols::Column>(section));
+}
+
+}
+}
@@ -0,0 +1,48 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_ELFSYMBOLMODEL_HPP
+#define TYREX_ELFSYMBOLMODEL_HPP
+
+#include "data/elfsymbols.hpp"
+#include <QAbstractTableModel>
+#include <memory>
+
+namespace tyrex {
+namespace graphic {
+
+// Symbols of an elf file, one row per symbol. Cells are formatted from the table only when displayed,
+// so that views stay instant whatever the number of symbols.
+class ElfSymbolModel : public QAbstractTableModel
+{
+public:
+    ElfSymbolModel(const std::shared_ptr<const data::ElfSymbols>& symbols, QObject* parent = 0);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+private:
+    std::shared_ptr<const data::ElfSymbols> mSymbols;
+};
+
+}
+}
+
+#endif // TYREX_ELFSYMBOLMODEL_HPP
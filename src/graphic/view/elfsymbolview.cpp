@@ -0,0 +1,92 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "elfsymbolview.hpp"
+
+#include <QHeaderView>
+
+namespace tyrex {
+namespace graphic {
+
+ElfSymbolView::ElfSymbolView(const std::shared_ptr<const data::ElfSymbols>& symbols, QWidget* parent) :
+    View(parent),
+    mSymbols(symbols),
+    mLayout(new QVBoxLayout(this)),
+    mFindLayout(new QHBoxLayout),
+    mFindEdit(new QLineEdit),
+    mFindStatus(new QLabel),
+    mTreeView(new QTreeView),
+    mModel(new ElfSymbolModel(symbols, mTreeView))
+{
+    mTreeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mTreeView->setRootIsDecorated(false);
+    mTreeView->setUniformRowHeights(true);
+    mTreeView->setModel(mModel);
+
+    // resizing to contents would format every row : widths come from the font instead
+    QFontMetrics metrics = mTreeView->fontMetrics();
+    QHeaderView* header = mTreeView->header();
+    header->resizeSection(data::ElfSymbols::nameColumn, metrics.width(QString(40, 'm')));
+    header->resizeSection(data::ElfSymbols::valueColumn, metrics.width(QString(20, '0')));
+    header->resizeSection(data::ElfSymbols::sizeColumn, metrics.width(QString(10, '0')));
+    header->resizeSection(data::ElfSymbols::typeColumn, metrics.width("SECTION") + 20);
+    header->resizeSection(data::ElfSymbols::bindingColumn, metrics.width("GLOBAL") + 20);
+
+    mFindEdit->setPlaceholderText("Name or address (0x...)");
+    mFindLayout->addWidget(mFindEdit);
+    mFindLayout->addWidget(mFindStatus);
+
+    mLayout->setContentsMargins(QMargins());
+    mLayout->addLayout(mFindLayout);
+    mLayout->addWidget(mTreeView);
+
+    QObject::connect(mFindEdit, SIGNAL(returnPressed()), this, SLOT(find()));
+}
+
+
+void ElfSymbolView::find()
+{
+    QString text = mFindEdit->text().trimmed();
+    if (text.isEmpty())
+        return;
+
+    int row = -1;
+    if (text.startsWith("0x", Qt::CaseInsensitive))
+    {
+        bool ok;
+        qulonglong address = text.mid(2).toULongLong(&ok, 16);
+        if (ok)
+            row = mSymbols->findAddress(address);
+    }
+    if (row < 0)
+        row = mSymbols->findName(text.toUtf8());
+
+    if (row < 0)
+    {
+        mFindStatus->setText("No symbol found.");
+        return;
+    }
+
+    mFindStatus->clear();
+    QModelIndex index = mModel->index(row, 0);
+    mTreeView->setCurrentIndex(index);
+    mTreeView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+}
+}
@@ -0,0 +1,60 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_ELFSYMBOLVIEW_HPP
+#define TYREX_ELFSYMBOLVIEW_HPP
+
+#include "elfsymbolmodel.hpp"
+#include "view.hpp"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+namespace tyrex {
+namespace graphic {
+
+// Symbol table with a find bar : a name selects the first symbol of that name,
+// an address (0x...) the symbol which holds it, through the indexes of the table.
+class ElfSymbolView : public View
+{
+    Q_OBJECT
+
+public:
+    ElfSymbolView(const std::shared_ptr<const data::ElfSymbols>& symbols, QWidget* parent = 0);
+
+private slots:
+    void find();
+
+private:
+    std::shared_ptr<const data::ElfSymbols> mSymbols;
+
+    QVBoxLayout* mLayout;
+    QHBoxLayout* mFindLayout;
+    QLineEdit* mFindEdit;
+    QLabel* mFindStatus;
+    QTreeView* mTreeView;
+    ElfSymbolModel* mModel;
+};
+
+}
+}
+
+#endif // TYREX_ELFSYMBOLVIEW_HPP
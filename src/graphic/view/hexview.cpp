@@ -22,6 +22,7 @@
 #include <QMessageBox>
 #include "graphic/mainwindow.hpp"
 #include "graphic/dialog/consoledialog.hpp"
+#include "graphic/dialog/inputdialog.hpp"
 #include "misc/hash/hash.hpp"
 #include "misc/util.hpp"
 
@@ -30,8 +31,13 @@ namespace graphic {
 
 HexView::HexView(const MemChunk& chunk, const data::Colorizer& colorizer, QWidget* parent) :
     ScrollView(new HexArea(chunk, colorizer, this), parent),
-    mHexArea(reinterpret_cast<HexArea*>(mArea))
+    mHexArea(reinterpret_cast<HexArea*>(mArea)),
+    mEntropyStrip(new EntropyStrip(chunk, this))
 {
+    this->addSideWidget(mEntropyStrip);
+
+    QObject::connect(mHexArea, SIGNAL(visibleRangeChanged(quint64, quint64)), mEntropyStrip, SLOT(setVisibleRange(quint64, quint64)));
+    QObject::connect(mEntropyStrip, SIGNAL(offsetClicked(quint64)), this, SLOT(jumpTo(quint64)));
 }
 
 
@@ -76,6 +82,16 @@ ActionSet HexView::getActions()
     QObject::connect(textAction, SIGNAL(triggered()), mHexArea, SLOT(toggleTextInHex()));
     display.mActions.append(textAction);
 
+    QAction* entropyAction = new QAction("&Entropy map", this);
+    entropyAction->setCheckable(true);
+    entropyAction->setChecked(mEntropyStrip->isVisibleTo(this));
+    QObject::connect(entropyAction, SIGNAL(toggled(bool)), mEntropyStrip, SLOT(setVisible(bool)));
+    display.mActions.append(entropyAction);
+
+    QAction* entropyWindowAction = new QAction("Entropy &window...", this);
+    QObject::connect(entropyWindowAction, SIGNAL(triggered()), this, SLOT(entropyWindowAction()));
+    display.mActions.append(entropyWindowAction);
+
     ActionSet result;
     result.mSubsets.append(file);
     result.mSubsets.append(edit);
@@ -134,5 +150,17 @@ void HexView::infoAction()
     dialog.exec();
 }
 
+void HexView::entropyWindowAction()
+{
+    unsigned int windowSize;
+    if (InputDialog::getUint(windowSize, QString("Size of entropy windows (currently %1 bytes)").arg(mEntropyStrip->windowSize()), this) && windowSize)
+        mEntropyStrip->setWindowSize(windowSize);
+}
+
+void HexView::jumpTo(quint64 offset)
+{
+    mHexArea->setCursor(offset);
+}
+
 }
 }
@@ -21,6 +21,7 @@
 
 #include "scrollview.hpp"
 #include "graphic/area/hexarea.hpp"
+#include "graphic/util/entropystrip.hpp"
 
 #include <QAction>
 
@@ -42,9 +43,12 @@ private slots:
     void exportAction();
     void extractAction();
     void infoAction();
+    void entropyWindowAction();
+    void jumpTo(quint64 offset);
 
 private:
     HexArea* mHexArea;
+    EntropyStrip* mEntropyStrip;
 };
 
 }
@@ -18,85 +18,158 @@
 
 #include "imageview.hpp"
 
-#include <QWheelEvent>
+#include <QMouseEvent>
 #include <QPainter>
+#include <QTimerEvent>
+#include <QWheelEvent>
+#include <algorithm>
 #include <cmath>
 
 namespace tyrex {
 namespace graphic {
 
-ImageView::ImageView(std::shared_ptr<data::Pixmap> pixmap, QWidget* parent) :
+static const double minScale = 1.0 / 4096;
+static const double maxScale = 256;
+// interval between repaints of the rows decoded meanwhile (ms)
+static const int loadInterval = 40;
+
+
+ImageView::ImageView(std::shared_ptr<data::Pixmap> pixmap, std::shared_ptr<data::PixmapProgress> progress, QWidget* parent) :
     View(parent),
     mLayout(new QHBoxLayout(this)),
-    mScrollArea(new QScrollArea),
-    mImageWidget(new ImageWidget(pixmap))
+    mImageWidget(new ImageWidget(pixmap, progress))
 {
     mLayout->setContentsMargins(QMargins());
-    mLayout->addWidget(mScrollArea);
-
-    mScrollArea->setBackgroundRole(QPalette::Dark);
-    mScrollArea->setAlignment(Qt::AlignCenter);
-    mScrollArea->setWidget(mImageWidget);
+    mLayout->addWidget(mImageWidget);
 }
 
 
-void ImageView::wheelEvent(QWheelEvent* event)
+ImageWidget::ImageWidget(std::shared_ptr<data::Pixmap> pixmap, std::shared_ptr<data::PixmapProgress> progress, QWidget* parent) :
+    QWidget(parent),
+    mPixmap(pixmap),
+    mProgress(progress),
+    mTiles(pixmap, progress, this),
+    mScale(1),
+    mFit(true),
+    mRows(0),
+    mPreviewCount(0)
 {
-    int offset = event->delta() / 120;
-    mImageWidget->setZoom(offset);
-    event->accept();
+    this->setBackgroundRole(QPalette::Dark);
+    this->setAutoFillBackground(true);
+
+    if (mProgress)
+        mLoadTimer.start(loadInterval, this);
 }
 
 
-ImageWidget::ImageWidget(std::shared_ptr<data::Pixmap> pixmap, QWidget* parent) :
-    QWidget(parent),
-    mPixmap(pixmap),
-    mQImage(mPixmap->width(), mPixmap->height(), QImage::Format_ARGB32),
-    mZoom(0)
+void ImageWidget::zoom(int steps, const QPointF& center)
 {
-    for (unsigned int y = 0 ; y < mPixmap->height() ; ++y)
-        for (unsigned int x = 0 ; x < mPixmap->width() ; ++x)
-            mQImage.setPixel(x, y, mPixmap->getARGB32(x, y));
+    // the image point under center stays there
+    QPointF point = mOrigin + center / mScale;
+    mScale = std::max(minScale, std::min(mScale * std::pow(2, steps / 4.0), maxScale));
+    mOrigin = point - center / mScale;
+    mFit = false;
 
-    this->resize(mPixmap->width(), mPixmap->height());
+    this->clampOrigin();
+    this->update();
 }
 
-
 void ImageWidget::wheelEvent(QWheelEvent* event)
 {
-    int offset = event->delta() / 120;
-    this->setZoom(offset);
+    this->zoom(event->delta() / 120, event->pos());
     event->accept();
 }
 
-void ImageWidget::setZoom(int zoom)
+void ImageWidget::mousePressEvent(QMouseEvent* event)
 {
-    mZoom += zoom;
-    double realFactor = std::pow(2, mZoom / 4.0);
-    this->resize(mPixmap->width() * realFactor, mPixmap->height() * realFactor);
+    if (event->button() != Qt::LeftButton)
+    {
+        event->ignore();
+        return;
+    }
+    mDragPos = event->pos();
 }
 
+void ImageWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!(event->buttons() & Qt::LeftButton))
+        return;
 
-void ImageWidget::resizeEvent(QResizeEvent* event)
+    mOrigin -= QPointF(event->pos() - mDragPos) / mScale;
+    mDragPos = event->pos();
+
+    this->clampOrigin();
+    this->update();
+}
+
+
+void ImageWidget::resizeEvent(QResizeEvent*)
 {
+    if (mFit && mPixmap->width() && mPixmap->height())
+    {
+        double scale = std::min(this->width() / double(mPixmap->width()), this->height() / double(mPixmap->height()));
+        mScale = std::max(minScale, std::min(scale, 1.0));
+    }
+
+    this->clampOrigin();
     this->update();
 }
 
-void ImageWidget::paintEvent(QPaintEvent* event)
+void ImageWidget::paintEvent(QPaintEvent*)
 {
     QPainter painter(this);
-    painter.fillRect(0, 0, this->width(), this->height(), Qt::white);
 
-    double xratio = this->width() / (double)mQImage.width();
-    double yratio = this->height() / (double)mQImage.height();
-    double ratio = xratio < yratio ? xratio : yratio;
+    QRectF image(0, 0, mPixmap->width(), mPixmap->height());
+    QRectF source = image & QRectF(mOrigin, QSizeF(this->width() / mScale, this->height() / mScale));
+    if (source.isEmpty())
+        return;
 
-    unsigned int w = mQImage.width() * ratio;
-    unsigned int h = mQImage.height() * ratio;
-    unsigned int x = (this->width() - w) / 2;
-    unsigned int y = (this->height() - h) / 2;
+    QRectF target((source.topLeft() - mOrigin) * mScale, source.size() * mScale);
+    painter.fillRect(target, Qt::white);
+    mTiles.draw(painter, target, source);
+}
 
-    painter.drawImage(QRect(x, y, w, h), mQImage);
+
+// A new preview repaints the whole image, new rows only their band.
+void ImageWidget::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != mLoadTimer.timerId())
+    {
+        QWidget::timerEvent(event);
+        return;
+    }
+
+    bool finished = mProgress->finished();
+    unsigned int rows = finished ? mPixmap->height() : mProgress->rows();
+    unsigned int previewCount = mProgress->previewCount();
+
+    if (previewCount != mPreviewCount)
+        this->update();
+    else if (rows > mRows)
+        this->update(QRectF(0, (mRows - mOrigin.y()) * mScale, this->width(), (rows - mRows) * mScale).toAlignedRect());
+
+    mRows = rows;
+    mPreviewCount = previewCount;
+    if (finished)
+        mLoadTimer.stop();
+}
+
+
+// An image smaller than the widget is centered, a larger one is kept over the whole widget.
+void ImageWidget::clampOrigin()
+{
+    double width = this->width() / mScale;
+    double height = this->height() / mScale;
+
+    if (width >= mPixmap->width())
+        mOrigin.setX((mPixmap->width() - width) / 2);
+    else
+        mOrigin.setX(std::max(0.0, std::min(mOrigin.x(), mPixmap->width() - width)));
+
+    if (height >= mPixmap->height())
+        mOrigin.setY((mPixmap->height() - height) / 2);
+    else
+        mOrigin.setY(std::max(0.0, std::min(mOrigin.y(), mPixmap->height() - height)));
 }
 
 }
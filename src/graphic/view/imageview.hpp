@@ -21,41 +21,59 @@
 
 #include "view.hpp"
 #include "data/image/pixmap.hpp"
-#include <QImage>
+#include "data/image/pixmapprogress.hpp"
+#include "graphic/util/imagetiles.hpp"
+#include <QBasicTimer>
 #include <QHBoxLayout>
-#include <QScrollArea>
 #include <memory>
 
 namespace tyrex {
 namespace graphic {
 
+// Shows a part of the image at any scale : the wheel zooms around the cursor, dragging pans.
+// Only the visible tiles are drawn, from the level of detail closest to the scale.
+// While the pixmap is decoded, the rows completed meanwhile are repainted at regular intervals.
 class ImageWidget : public QWidget
 {
 public:
-    ImageWidget(std::shared_ptr<data::Pixmap> pixmap, QWidget* parent = 0);
+    ImageWidget(std::shared_ptr<data::Pixmap> pixmap, std::shared_ptr<data::PixmapProgress> progress, QWidget* parent = 0);
 
-    void setZoom(int zoom);
+    // zooms by steps of 2^(1/4), around a point of the widget
+    void zoom(int steps, const QPointF& center);
 
 private:
     void wheelEvent(QWheelEvent* event);
+    void mousePressEvent(QMouseEvent* event);
+    void mouseMoveEvent(QMouseEvent* event);
     void paintEvent(QPaintEvent* event);
     void resizeEvent(QResizeEvent* event);
+    void timerEvent(QTimerEvent* event);
+
+    void clampOrigin();
 
     std::shared_ptr<data::Pixmap> mPixmap;
-    QImage mQImage;
-    int mZoom;
+    std::shared_ptr<data::PixmapProgress> mProgress;
+    ImageTiles mTiles;
+    // widget pixels per image pixel ; the whole image fits until the first zoom
+    double mScale;
+    bool mFit;
+    // image point at the top left corner of the widget
+    QPointF mOrigin;
+    QPoint mDragPos;
+
+    QBasicTimer mLoadTimer;
+    // rows and previews of the progress already repainted
+    unsigned int mRows;
+    unsigned int mPreviewCount;
 };
 
 class ImageView : public View
 {
 public:
-    ImageView(std::shared_ptr<data::Pixmap> pixmap, QWidget* parent = 0);
+    ImageView(std::shared_ptr<data::Pixmap> pixmap, std::shared_ptr<data::PixmapProgress> progress = nullptr, QWidget* parent = 0);
 
 private:
-    void wheelEvent(QWheelEvent* event);
-
     QHBoxLayout* mLayout;
-    QScrollArea* mScrollArea;
     ImageWidget* mImageWidget;
 };
 
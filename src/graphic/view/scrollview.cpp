@@ -21,60 +21,101 @@
 #include <QWheelEvent>
 #include <QApplication>
 #include <QStyle>
+#include <algorithm>
 #include "graphic/area/area.hpp"
 #include "graphic/mainwindow.hpp"
 
 namespace tyrex {
 namespace graphic {
 
+// largest range of the scrollbar, well within an int
+static const int maxScrollBarRange = 1 << 24;
+
+
 ScrollView::ScrollView(Area* area, QWidget* parent) :
     View(parent),
     mArea(area),
     mLayout(new QGridLayout(this)),
-    mScrollBar(new QScrollBar(Qt::Vertical))
+    mScrollBar(new QScrollBar(Qt::Vertical)),
+    mLineCount(0),
+    mPageStep(0),
+    mLine(0),
+    mUpdatingScrollBar(false)
 {
     mLayout->setContentsMargins(QMargins());
     mLayout->setSpacing(0);
     mLayout->addWidget(mArea, 0, 0);
     mLayout->addWidget(mScrollBar, 0, 1);
 
-    QObject::connect(mScrollBar, SIGNAL(valueChanged(int)), mArea, SLOT(scroll(int)));
+    QObject::connect(mScrollBar, SIGNAL(valueChanged(int)), this, SLOT(scrollBarMoved(int)));
 }
 
 
-void ScrollView::setScroll(int value)
+void ScrollView::setScroll(uint64_t line)
+{
+    mLine = std::min(line, this->maxScroll());
+    this->updateScrollBar();
+    mArea->scroll(mLine);
+}
+
+void ScrollView::changeScroll(uint64_t lineCount, uint64_t pageStep, uint64_t line)
 {
-    mScrollBar->setValue(value);
+    mLineCount = lineCount;
+    mPageStep = pageStep;
+    this->setScroll(line);
 }
 
-void ScrollView::changeScroll(int linecount, int pagestep, int value)
+void ScrollView::scrollBarMoved(int value)
 {
+    if (mUpdatingScrollBar)
+        return;
+
+    uint64_t maxLine = this->maxScroll();
+    if (maxLine <= uint64_t(maxScrollBarRange))
+        mLine = value;
+    else
+        mLine = std::min<uint64_t>(double(value) / maxScrollBarRange * maxLine, maxLine);
+
+    mArea->scroll(mLine);
+}
+
+void ScrollView::updateScrollBar()
+{
+    uint64_t maxLine = this->maxScroll();
+
+    mUpdatingScrollBar = true;
     mScrollBar->setMinimum(0);
-    if (linecount > pagestep)
+    if (maxLine <= uint64_t(maxScrollBarRange))
     {
-        mScrolling = true;
-        mScrollBar->setMaximum(linecount - pagestep);
+        mScrollBar->setMaximum(maxLine);
+        mScrollBar->setPageStep(std::max<uint64_t>(mPageStep, 1));
+        mScrollBar->setValue(mLine);
     }
     else
     {
-        mScrolling = false;
-        mScrollBar->setMaximum(0);
+        mScrollBar->setMaximum(maxScrollBarRange);
+        mScrollBar->setPageStep(std::max(1.0, double(mPageStep) / maxLine * maxScrollBarRange));
+        mScrollBar->setValue(double(mLine) / maxLine * maxScrollBarRange);
     }
-    mScrollBar->setPageStep(pagestep);
-    mScrollBar->setValue(value);
+    mUpdatingScrollBar = false;
+}
+
+void ScrollView::addSideWidget(QWidget* widget)
+{
+    mLayout->addWidget(widget, 0, mLayout->columnCount());
 }
 
 void ScrollView::wheelEvent(QWheelEvent* event)
 {
-    if (mScrolling)
+    int offset = -event->delta() / 40;
+    if ((offset > 0 && mLine < this->maxScroll()) || (offset < 0 && mLine > 0))
     {
-        int offset = -event->delta() / 40;
-        if ((mScrollBar->value() != mScrollBar->maximum() || offset < 0) && (mScrollBar->value() != 0 || offset > 0))
-        {
-            mScrollBar->setValue(mScrollBar->value() + offset);
-            event->accept();
-            return;
-        }
+        if (offset < 0 && uint64_t(-offset) > mLine)
+            this->setScroll(0);
+        else
+            this->setScroll(mLine + offset);
+        event->accept();
+        return;
     }
 
     event->ignore();
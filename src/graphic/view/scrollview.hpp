@@ -21,6 +21,7 @@
 
 #include <QHBoxLayout>
 #include <QScrollBar>
+#include <cstdint>
 
 #include "view.hpp"
 
@@ -30,29 +31,45 @@ namespace graphic {
 class Area;
 
 // A view with a scrollbar and an inner area.
+// The area scrolls by lines, counted on 64 bits. When there are too many lines for the range of a QScrollBar,
+// the scrollbar positions are spread evenly over the lines ; the wheel and the keys still move line by line.
 class ScrollView : public View
 {
+    Q_OBJECT
+
 public:
     ScrollView(Area* area, QWidget* parent);
 
-    void changeScroll(int linecount, int pagestep, int value);
-    void setScroll(int value);
-    inline int maxScroll() const;
+    void changeScroll(uint64_t lineCount, uint64_t pageStep, uint64_t line);
+    void setScroll(uint64_t line);
+    inline uint64_t maxScroll() const;
 
 protected:
+    // adds a widget on the right of the scrollbar
+    void addSideWidget(QWidget* widget);
+
     void wheelEvent(QWheelEvent* event);
 
     Area* mArea;
 
+private slots:
+    void scrollBarMoved(int value);
+
 private:
+    void updateScrollBar();
+
     QGridLayout* mLayout;
     QScrollBar* mScrollBar;
 
-    bool mScrolling;
+    uint64_t mLineCount;
+    uint64_t mPageStep;
+    uint64_t mLine;
+    // set while the scrollbar is moved to follow mLine
+    bool mUpdatingScrollBar;
 };
 
-inline int ScrollView::maxScroll() const
-    {return mScrollBar->maximum();}
+inline uint64_t ScrollView::maxScroll() const
+    {return mLineCount > mPageStep ? mLineCount - mPageStep : 0;}
 
 }
 }
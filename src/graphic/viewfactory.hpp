@@ -0,0 +1,58 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_VIEWFACTORY_HPP
+#define TYREX_VIEWFACTORY_HPP
+
+#include "view/view.hpp"
+#include <functional>
+#include <memory>
+
+namespace tyrex {
+namespace graphic {
+
+// Builds a view the first time it is shown.
+// The view may then be released while hidden, it is built again on the next request.
+class ViewFactory
+{
+public:
+    typedef std::function<std::shared_ptr<View>()> Maker;
+
+    inline ViewFactory(const Maker& maker);
+
+    std::shared_ptr<View> view();
+    inline bool hasView() const;
+    inline void release();
+
+private:
+    Maker mMaker;
+    std::shared_ptr<View> mView;
+};
+
+inline ViewFactory::ViewFactory(const Maker& maker) :
+    mMaker(maker) {}
+
+inline bool ViewFactory::hasView() const
+    {return (bool)mView;}
+inline void ViewFactory::release()
+    {mView.reset();}
+
+}
+}
+
+#endif // TYREX_VIEWFACTORY_HPP
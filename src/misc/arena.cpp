@@ -0,0 +1,84 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace tyrex {
+
+thread_local std::vector<std::shared_ptr<Arena> > Arena::mStack;
+
+// Blocks double in size up to the maximum, so that small documents stay small
+// and big ones get blocks large enough to be returned to the system when freed.
+static const std::size_t minBlockSize = 64 * 1024;
+static const std::size_t maxBlockSize = 4 * 1024 * 1024;
+
+
+Arena::Arena() :
+    mPtr(nullptr),
+    mEnd(nullptr),
+    mReserved(0)
+{
+}
+
+Arena::~Arena()
+{
+}
+
+
+void* Arena::allocate(std::size_t size, std::size_t alignment)
+{
+    std::uintptr_t ptr = reinterpret_cast<std::uintptr_t>(mPtr);
+    std::uintptr_t aligned = (ptr + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+
+    if (!mPtr || aligned + size > reinterpret_cast<std::uintptr_t>(mEnd))
+    {
+        this->newBlock(size + alignment);
+        ptr = reinterpret_cast<std::uintptr_t>(mPtr);
+        aligned = (ptr + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+
+    mPtr = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::newBlock(std::size_t minSize)
+{
+    std::size_t size = std::min(maxBlockSize, minBlockSize << std::min<std::size_t>(mBlocks.size(), 6));
+    size = std::max(size, minSize);
+
+    mBlocks.push_back(std::unique_ptr<char[]>(new char[size]));
+    mPtr = mBlocks.back().get();
+    mEnd = mPtr + size;
+    mReserved += size;
+}
+
+
+void Arena::push(const std::shared_ptr<Arena>& arena)
+{
+    mStack.push_back(arena);
+}
+
+void Arena::pop()
+{
+    mStack.pop_back();
+}
+
+}
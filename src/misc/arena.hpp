@@ -0,0 +1,174 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_ARENA_HPP
+#define TYREX_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace tyrex {
+
+// A monotonic buffer : small objects are carved out of large blocks, which are all freed at once when the arena is destroyed.
+// Each document owns an arena, made current while its data is built (see Arena::Scope).
+// An arena is not thread-safe : each thread has its own stack of current arenas, and parallel parses use an arena each.
+class Arena
+{
+public:
+    Arena();
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+    inline std::size_t reserved() const;
+
+    // Arena used by default-constructed ArenaAllocators; null if none.
+    static inline std::shared_ptr<Arena> current();
+    static void push(const std::shared_ptr<Arena>& arena);
+    static void pop();
+
+    class Scope
+    {
+    public:
+        inline Scope(const std::shared_ptr<Arena>& arena);
+        inline ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    void newBlock(std::size_t minSize);
+
+    std::vector<std::unique_ptr<char[]> > mBlocks;
+    char* mPtr;
+    char* mEnd;
+    std::size_t mReserved;
+
+    static thread_local std::vector<std::shared_ptr<Arena> > mStack;
+};
+
+inline std::size_t Arena::reserved() const
+    {return mReserved;}
+inline std::shared_ptr<Arena> Arena::current()
+    {return mStack.empty() ? std::shared_ptr<Arena>() : mStack.back();}
+
+inline Arena::Scope::Scope(const std::shared_ptr<Arena>& arena)
+    {Arena::push(arena);}
+inline Arena::Scope::~Scope()
+    {Arena::pop();}
+
+
+// Standard allocator drawing from an arena, or from the heap when there is no current arena.
+// It keeps a reference to its arena, so that objects which escape their document (e.g. shared with a view) remain valid.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+
+    inline ArenaAllocator();
+    inline ArenaAllocator(const std::shared_ptr<Arena>& arena);
+    template <typename U>
+    inline ArenaAllocator(const ArenaAllocator<U>& other);
+
+    inline T* allocate(std::size_t n, const void* hint = 0);
+    inline void deallocate(T* ptr, std::size_t n);
+
+    template <typename U, typename... Args>
+    inline void construct(U* ptr, Args&&... args);
+    template <typename U>
+    inline void destroy(U* ptr);
+    inline std::size_t max_size() const;
+
+    inline const std::shared_ptr<Arena>& arena() const;
+
+private:
+    std::shared_ptr<Arena> mArena;
+};
+
+template <typename T>
+inline ArenaAllocator<T>::ArenaAllocator() :
+    mArena(Arena::current()) {}
+template <typename T>
+inline ArenaAllocator<T>::ArenaAllocator(const std::shared_ptr<Arena>& arena) :
+    mArena(arena) {}
+template <typename T>
+template <typename U>
+inline ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other) :
+    mArena(other.arena()) {}
+
+template <typename T>
+inline T* ArenaAllocator<T>::allocate(std::size_t n, const void*)
+{
+    if (mArena)
+        return static_cast<T*>(mArena->allocate(n * sizeof(T), alignof(T)));
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+// Arena memory is only reclaimed with the whole arena.
+template <typename T>
+inline void ArenaAllocator<T>::deallocate(T* ptr, std::size_t)
+{
+    if (!mArena)
+        ::operator delete(ptr);
+}
+
+template <typename T>
+template <typename U, typename... Args>
+inline void ArenaAllocator<T>::construct(U* ptr, Args&&... args)
+    {::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);}
+template <typename T>
+template <typename U>
+inline void ArenaAllocator<T>::destroy(U* ptr)
+    {ptr->~U();}
+template <typename T>
+inline std::size_t ArenaAllocator<T>::max_size() const
+    {return static_cast<std::size_t>(-1) / sizeof(T);}
+
+template <typename T>
+inline const std::shared_ptr<Arena>& ArenaAllocator<T>::arena() const
+    {return mArena;}
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    {return a.arena() == b.arena();}
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    {return a.arena() != b.arena();}
+
+}
+
+#endif // TYREX_ARENA_HPP
@@ -0,0 +1,101 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "bytestats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace tyrex {
+
+// counts up to this value use a table of c * log2(c)
+static const unsigned int tableSize = 1 << 16;
+
+static const std::vector<float>& xLog2xTable()
+{
+    static const std::vector<float> table = [] {
+        std::vector<float> result(tableSize);
+        for (unsigned int i = 1 ; i < tableSize ; ++i)
+            result[i] = i * std::log2(static_cast<double>(i));
+        return result;
+    }();
+    return table;
+}
+
+
+ByteStats::ByteStats() :
+    mSize(0),
+    mEntropy(0),
+    mChiSquare(0),
+    mMode(0)
+{
+    std::memset(mHistogram, 0, sizeof(mHistogram));
+}
+
+
+void ByteStats::compute(const unsigned char* data, unsigned int size)
+{
+    // Four histograms, so that runs of the same byte do not serialize the increments on a single counter.
+    // Words are read 4 bytes at a time and their bytes go to different histograms.
+    uint32_t histograms[4][256];
+    std::memset(histograms, 0, sizeof(histograms));
+
+    unsigned int i = 0;
+    for ( ; i + 4 <= size ; i += 4)
+    {
+        uint32_t word;
+        std::memcpy(&word, data + i, 4);
+        ++histograms[0][word & 0xFF];
+        ++histograms[1][(word >> 8) & 0xFF];
+        ++histograms[2][(word >> 16) & 0xFF];
+        ++histograms[3][word >> 24];
+    }
+    for ( ; i < size ; ++i)
+        ++histograms[0][data[i]];
+
+    mSize = size;
+    for (unsigned int v = 0 ; v < 256 ; ++v)
+        mHistogram[v] = histograms[0][v] + histograms[1][v] + histograms[2][v] + histograms[3][v];
+
+    mEntropy = 0;
+    mChiSquare = 0;
+    mMode = 0;
+    if (!size)
+        return;
+
+    // H = log2(n) - sum(c * log2(c)) / n
+    const std::vector<float>& table = xLog2xTable();
+    double sum = 0;
+    double chiSquare = 0;
+    double expected = size / 256.0;
+    for (unsigned int v = 0 ; v < 256 ; ++v)
+    {
+        uint32_t c = mHistogram[v];
+        sum += c < tableSize ? table[c] : c * std::log2(static_cast<double>(c));
+        chiSquare += (c - expected) * (c - expected);
+        if (c > mHistogram[mMode])
+            mMode = v;
+    }
+
+    mEntropy = std::max(0.0, std::log2(static_cast<double>(size)) - sum / size);
+    mChiSquare = chiSquare / expected;
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_BYTESTATS_HPP
+#define TYREX_BYTESTATS_HPP
+
+#include <cstdint>
+
+namespace tyrex {
+
+// Statistics of the byte values in a window of data, to tell text, code, compressed or encrypted data and padding apart.
+class ByteStats
+{
+public:
+    ByteStats();
+
+    // replaces the statistics by those of data[0, size)
+    void compute(const unsigned char* data, unsigned int size);
+
+    inline unsigned int size() const;
+    inline uint32_t count(unsigned char value) const;
+    // Shannon entropy, in bits per byte (0 for a constant, 8 for uniform random data)
+    inline float entropy() const;
+    // chi-square against a uniform distribution ; about 255 for random data, much more for compressed data
+    inline float chiSquare() const;
+    // most frequent byte value
+    inline unsigned char mode() const;
+
+private:
+    unsigned int mSize;
+    uint32_t mHistogram[256];
+    float mEntropy;
+    float mChiSquare;
+    unsigned char mMode;
+};
+
+inline unsigned int ByteStats::size() const
+    {return mSize;}
+inline uint32_t ByteStats::count(unsigned char value) const
+    {return mHistogram[value];}
+inline float ByteStats::entropy() const
+    {return mEntropy;}
+inline float ByteStats::chiSquare() const
+    {return mChiSquare;}
+inline unsigned char ByteStats::mode() const
+    {return mMode;}
+
+}
+
+#endif // TYREX_BYTESTATS_HPP
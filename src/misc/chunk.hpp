@@ -21,17 +21,21 @@
 
 #include <vector>
 #include <memory>
+#include "chunkbuffer.hpp"
 
 namespace tyrex {
 
 // A class to share a block of memory, or part of a block.
 // Memory units are objects of class T (usually unsigned char or unsigned int).
+// Slicing and copying never copy the memory ; appending copies only the appended data, or nothing if it directly follows the chunk.
 template <typename T>
 class Chunk
 {
 public:
     Chunk();
     Chunk(unsigned int size);
+    // The region must remain valid as long as the owner is alive.
+    Chunk(T* data, unsigned int size, const std::shared_ptr<void>& owner);
     Chunk(const Chunk& other);
     void operator=(const Chunk& other);
 
@@ -43,6 +47,7 @@ public:
     void append(T value, unsigned int length);
     void append(const Chunk& other);
     void append(const T* data, unsigned int size);
+    void reserve(unsigned int size);
     void clear();
     Chunk subChunk(unsigned int start, unsigned int size, T fillWith) const;
     Chunk subChunk(unsigned int start, unsigned int size) const;
@@ -50,6 +55,8 @@ public:
 
     inline unsigned int offset() const;
     inline unsigned int size() const;
+    // True if next directly follows this chunk in the same block : appending it is free.
+    inline bool adjacent(const Chunk& next) const;
     // Warning : unchecked access to data !
     inline const T* data() const;
     inline T operator[](unsigned int pos) const;
@@ -59,10 +66,12 @@ public:
 
 protected:
     void clone();
+    inline void prepareAppend();
+    inline void countGrowth(unsigned int extra) const;
 
     unsigned int mStart;
     unsigned int mSize;
-    std::shared_ptr<std::vector<T> > mData;
+    std::shared_ptr<ChunkBuffer<T> > mData;
 };
 
 template <typename T>
@@ -76,8 +85,11 @@ template <typename T>
 inline unsigned int Chunk<T>::size() const
     {return mSize;}
 template <typename T>
+inline bool Chunk<T>::adjacent(const Chunk& next) const
+    {return mData == next.mData && mStart + mSize == next.mStart;}
+template <typename T>
 inline const T* Chunk<T>::data() const
-    {return &(*mData)[mStart];}
+    {return mData->data() + mStart;}
 template <typename T>
 inline T Chunk<T>::operator[](unsigned int pos) const
     {return (*mData)[mStart + pos];}
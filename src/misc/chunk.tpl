@@ -19,7 +19,9 @@
 #ifndef TYREX_CHUNK_TPL
 #define TYREX_CHUNK_TPL
 
+#include <algorithm>
 #include "chunk.hpp"
+#include "profiler.hpp"
 #include "util.hpp"
 
 namespace tyrex {
@@ -28,15 +30,25 @@ template <typename T>
 Chunk<T>::Chunk() :
     mStart(0),
     mSize(0),
-    mData(std::make_shared<std::vector<T> >())
+    mData(std::make_shared<ChunkBuffer<T> >())
 {
+    Profiler::count(Profiler::allocations);
 }
 
 template <typename T>
 Chunk<T>::Chunk(unsigned int size) :
     mStart(0),
     mSize(size),
-    mData(std::make_shared<std::vector<T> >(size, 0))
+    mData(std::make_shared<ChunkBuffer<T> >(size, 0))
+{
+    Profiler::count(Profiler::allocations);
+}
+
+template <typename T>
+Chunk<T>::Chunk(T* data, unsigned int size, const std::shared_ptr<void>& owner) :
+    mStart(0),
+    mSize(size),
+    mData(std::make_shared<ChunkBuffer<T> >(data, size, owner))
 {
 }
 
@@ -59,15 +71,26 @@ void Chunk<T>::operator=(const Chunk& other)
 template <typename T>
 void Chunk<T>::clone()
 {
-    std::shared_ptr<std::vector<T> > data(std::make_shared<std::vector<T> >(mSize));
-    const std::vector<T>& src = *mData;
-    std::vector<T>& dst = *data;
+    mData = std::make_shared<ChunkBuffer<T> >(this->data(), mSize);
+    Profiler::count(Profiler::allocations);
+    mStart = 0;
+}
 
-    for (unsigned int i = 0, k = mStart ; i < mSize ; ++i, ++k)
-        dst[i] = src[k];
+// Appending writes past the end of the block : a chunk which does not reach the end
+// (it would overwrite data of other chunks) or an external block gets its own copy first.
+template <typename T>
+inline void Chunk<T>::prepareAppend()
+{
+    if (mData->external() || mStart + mSize != mData->size())
+        this->clone();
+}
 
-    mData = data;
-    mStart = 0;
+// Profiling : count the reallocations of the buffer when appending.
+template <typename T>
+inline void Chunk<T>::countGrowth(unsigned int extra) const
+{
+    if (Profiler::enabled() && mData->size() + extra > mData->capacity())
+        Profiler::count(Profiler::allocations);
 }
 
 
@@ -104,6 +127,8 @@ bool Chunk<T>::operator==(const Chunk& other) const
 template <typename T>
 void Chunk<T>::append(T value)
 {
+    this->prepareAppend();
+    this->countGrowth(1);
     mData->push_back(value);
     ++mSize;
 }
@@ -111,38 +136,57 @@ void Chunk<T>::append(T value)
 template <typename T>
 void Chunk<T>::append(T value, unsigned int length)
 {
-    for (unsigned int i = 0 ; i < length ; ++i)
-        mData->push_back(value);
+    this->prepareAppend();
+    this->countGrowth(length);
+    mData->append(value, length);
     mSize += length;
 }
 
 template <typename T>
 void Chunk<T>::append(const Chunk& other)
 {
-    if (mData == other.mData)
-        clone();
+    if (!mSize)
+    {
+        *this = other;
+        return;
+    }
+    if (this->adjacent(other))
+    {
+        mSize += other.mSize;
+        return;
+    }
 
-    const std::vector<T>& src = *other.mData;
-    std::vector<T>& dst = *mData;
-    for (unsigned int i = other.mStart ; i < other.mStart + other.mSize ; ++i)
-        dst.push_back(src[i]);
+    if (mData == other.mData)
+        this->clone();
+    this->prepareAppend();
+    this->countGrowth(other.mSize);
+    mData->append(other.data(), other.mSize);
     mSize += other.mSize;
 }
 
 template <typename T>
 void Chunk<T>::append(const T* data, unsigned int size)
 {
-    for (unsigned int i = 0 ; i < size ; ++i)
-        mData->push_back(data[i]);
+    this->prepareAppend();
+    this->countGrowth(size);
+    mData->append(data, size);
     mSize += size;
 }
 
+template <typename T>
+void Chunk<T>::reserve(unsigned int size)
+{
+    this->prepareAppend();
+    mData->reserve(mStart + size);
+}
+
 template <typename T>
 void Chunk<T>::clear()
 {
     mStart = 0;
     mSize = 0;
-    mData = std::make_shared<std::vector<T> >();
+    mData = std::make_shared<ChunkBuffer<T> >();
+    Profiler::count(Profiler::allocations);
 }
 
 template <typename T>
@@ -158,13 +202,9 @@ Chunk<T> Chunk<T>::subChunk(unsigned int start, unsigned int size, T fillWith) c
     }
     else
     {
-        const std::vector<T>& src = *mData;
-        std::vector<T>& dst = *chunk.mData;
-
-        for (unsigned int i = start ; i < mSize ; ++i)
-            dst.push_back(src[mStart + i]);
-        for (unsigned int i = mSize ; i < start + size ; ++i)
-            dst.push_back(fillWith);
+        unsigned int available = start < mSize ? std::min(size, mSize - start) : 0;
+        chunk.mData->append(this->data() + start, available);
+        chunk.mData->append(fillWith, size - available);
         chunk.mSize = size;
     }
 
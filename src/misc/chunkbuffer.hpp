@@ -0,0 +1,144 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_CHUNKBUFFER_HPP
+#define TYREX_CHUNKBUFFER_HPP
+
+#include <memory>
+#include <vector>
+
+namespace tyrex {
+
+// The block of memory shared by Chunks.
+// It is either a vector, or an external region kept alive by an owner (e.g. a mapped file).
+// An external region is only copied into a vector when something is appended to it.
+template <typename T>
+class ChunkBuffer
+{
+public:
+    inline ChunkBuffer();
+    inline ChunkBuffer(unsigned int size, T value);
+    inline ChunkBuffer(const T* data, unsigned int size);
+    inline ChunkBuffer(T* data, unsigned int size, const std::shared_ptr<void>& owner);
+
+    ChunkBuffer(const ChunkBuffer&) = delete;
+    ChunkBuffer& operator=(const ChunkBuffer&) = delete;
+
+    inline bool external() const;
+    inline unsigned int size() const;
+    inline unsigned int capacity() const;
+    inline T* data() const;
+    inline T operator[](unsigned int pos) const;
+    inline T& operator[](unsigned int pos);
+
+    inline void push_back(T value);
+    void append(const T* data, unsigned int size);
+    void append(T value, unsigned int size);
+    void reserve(unsigned int size);
+
+private:
+    void detach();
+
+    std::vector<T> mVector;
+    T* mData;
+    unsigned int mSize;
+    std::shared_ptr<void> mOwner;
+};
+
+template <typename T>
+inline ChunkBuffer<T>::ChunkBuffer() :
+    mData(nullptr), mSize(0) {}
+template <typename T>
+inline ChunkBuffer<T>::ChunkBuffer(unsigned int size, T value) :
+    mVector(size, value), mData(mVector.data()), mSize(size) {}
+template <typename T>
+inline ChunkBuffer<T>::ChunkBuffer(const T* data, unsigned int size) :
+    mVector(data, data + size), mData(mVector.data()), mSize(size) {}
+template <typename T>
+inline ChunkBuffer<T>::ChunkBuffer(T* data, unsigned int size, const std::shared_ptr<void>& owner) :
+    mData(data), mSize(size), mOwner(owner) {}
+
+template <typename T>
+inline bool ChunkBuffer<T>::external() const
+    {return static_cast<bool>(mOwner);}
+template <typename T>
+inline unsigned int ChunkBuffer<T>::size() const
+    {return mSize;}
+template <typename T>
+inline unsigned int ChunkBuffer<T>::capacity() const
+    {return mOwner ? mSize : mVector.capacity();}
+template <typename T>
+inline T* ChunkBuffer<T>::data() const
+    {return mData;}
+template <typename T>
+inline T ChunkBuffer<T>::operator[](unsigned int pos) const
+    {return mData[pos];}
+template <typename T>
+inline T& ChunkBuffer<T>::operator[](unsigned int pos)
+    {return mData[pos];}
+
+template <typename T>
+inline void ChunkBuffer<T>::push_back(T value)
+{
+    if (mOwner)
+        this->detach();
+    mVector.push_back(value);
+    mData = mVector.data();
+    ++mSize;
+}
+
+template <typename T>
+void ChunkBuffer<T>::append(const T* data, unsigned int size)
+{
+    if (mOwner)
+        this->detach();
+    mVector.insert(mVector.end(), data, data + size);
+    mData = mVector.data();
+    mSize += size;
+}
+
+template <typename T>
+void ChunkBuffer<T>::append(T value, unsigned int size)
+{
+    if (mOwner)
+        this->detach();
+    mVector.insert(mVector.end(), size, value);
+    mData = mVector.data();
+    mSize += size;
+}
+
+template <typename T>
+void ChunkBuffer<T>::reserve(unsigned int size)
+{
+    if (mOwner)
+        this->detach();
+    mVector.reserve(size);
+    mData = mVector.data();
+}
+
+template <typename T>
+void ChunkBuffer<T>::detach()
+{
+    mVector.assign(mData, mData + mSize);
+    mData = mVector.data();
+    mOwner.reset();
+}
+
+}
+
+#endif // TYREX_CHUNKBUFFER_HPP
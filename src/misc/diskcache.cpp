@@ -0,0 +1,105 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "diskcache.hpp"
+
+#include "platform-specific/platform-specific.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+
+namespace tyrex {
+
+std::atomic<bool> DiskCache::mEnabled(false);
+
+DiskCache::DiskCache(const QString& name) :
+    mDirectory(PlatformSpecific::cacheDirectory() + "/" + name)
+{
+}
+
+
+bool DiskCache::load(const QString& key, QByteArray& data) const
+{
+    QFile file;
+    if (!this->open(key, file))
+        return false;
+
+    data = qUncompress(file.readAll());
+    return !data.isEmpty();
+}
+
+void DiskCache::store(const QString& key, const QByteArray& data) const
+{
+    QFile file;
+    if (!this->create(key, file))
+        return;
+
+    QByteArray compressed = qCompress(data);
+    this->commit(key, file, file.write(compressed) == compressed.size());
+}
+
+
+bool DiskCache::open(const QString& key, QFile& file) const
+{
+    if (!DiskCache::enabled())
+        return false;
+
+    file.setFileName(mDirectory + "/" + key);
+    return file.open(QIODevice::ReadOnly);
+}
+
+bool DiskCache::create(const QString& key, QFile& file) const
+{
+    if (!DiskCache::enabled())
+        return false;
+
+    if (!QDir().mkpath(mDirectory))
+        return false;
+
+    file.setFileName(mDirectory + "/" + key + ".tmp");
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void DiskCache::commit(const QString& key, QFile& file, bool success) const
+{
+    QString path = mDirectory + "/" + key;
+    file.close();
+    success = success && file.error() == QFile::NoError;
+
+    if (success)
+        QFile::remove(path);
+    if (!success || !file.rename(path))
+        file.remove();
+}
+
+
+void DiskCache::trim(qint64 maxSize) const
+{
+    QFileInfoList entries = QDir(mDirectory).entryInfoList(QDir::Files, QDir::Time);
+
+    // newest first
+    qint64 total = 0;
+    for (const QFileInfo& entry : entries)
+    {
+        total += entry.size();
+        if (total > maxSize)
+            QFile::remove(entry.absoluteFilePath());
+    }
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_DISKCACHE_HPP
+#define TYREX_DISKCACHE_HPP
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <atomic>
+
+namespace tyrex {
+
+// Data kept between sessions in a subdirectory of the user's cache directory, e.g. indexes of big archives.
+// Entries are compressed, and written atomically so that a crash never leaves a truncated entry.
+// Failures are silent : the cache is only an optimization.
+// Off by default, as entries hold decoded contents of the files opened : while disabled, nothing is read or written.
+class DiskCache
+{
+public:
+    DiskCache(const QString& name);
+
+    // May be called from any thread.
+    static inline bool enabled();
+    static inline void setEnabled(bool enabled);
+
+    bool load(const QString& key, QByteArray& data) const;
+    void store(const QString& key, const QByteArray& data) const;
+
+    // Uncompressed entries, read and written in place for data too big to be held twice in memory.
+    bool open(const QString& key, QFile& file) const;
+    bool create(const QString& key, QFile& file) const;
+    // publishes an entry written after create(), or drops it
+    void commit(const QString& key, QFile& file, bool success) const;
+
+    // removes the oldest entries until the cache holds at most maxSize bytes
+    void trim(qint64 maxSize) const;
+
+private:
+    QString mDirectory;
+
+    static std::atomic<bool> mEnabled;
+};
+
+inline bool DiskCache::enabled()
+    {return mEnabled.load(std::memory_order_relaxed);}
+inline void DiskCache::setEnabled(bool enabled)
+    {mEnabled.store(enabled, std::memory_order_relaxed);}
+
+}
+
+#endif // TYREX_DISKCACHE_HPP
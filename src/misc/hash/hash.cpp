@@ -18,23 +18,57 @@
 
 #include "hash.hpp"
 
+#include <algorithm>
 #include "misc/memchunk.hpp"
 #include "misc/hash/sha256.hpp"
 
 namespace tyrex {
 
+static const uint64_t xxhPrime1 = 0x9E3779B185EBCA87ull;
+static const uint64_t xxhPrime2 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t xxhPrime3 = 0x165667B19E3779F9ull;
+static const uint64_t xxhPrime4 = 0x85EBCA77C2B2AE63ull;
+static const uint64_t xxhPrime5 = 0x27D4EB2F165667C5ull;
+
+static inline uint64_t rotateLeft(uint64_t x, unsigned int n)
+    {return (x << n) | (x >> (64 - n));}
+// compilers turn these into single loads on little-endian machines
+static inline uint64_t readLE32(const unsigned char* p)
+    {return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) | (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24);}
+static inline uint64_t readLE64(const unsigned char* p)
+    {return readLE32(p) | (readLE32(p + 4) << 32);}
+static inline uint64_t xxhRound(uint64_t acc, uint64_t input)
+    {return rotateLeft(acc + input * xxhPrime2, 31) * xxhPrime1;}
+static inline uint64_t xxhMerge(uint64_t acc, uint64_t value)
+    {return (acc ^ xxhRound(0, value)) * xxhPrime1 + xxhPrime4;}
+
+
 unsigned int Hasher::getAdler32(const MemChunk& chunk)
 {
-    unsigned int size = chunk.size();
+    return Hasher::updateAdler32(1, chunk.data(), chunk.size());
+}
 
-    unsigned int s1 = 1;
-    unsigned int s2 = 0;
+unsigned int Hasher::updateAdler32(unsigned int adler, const unsigned char* data, unsigned int size)
+{
+    // largest count of bytes for which s2 cannot overflow before the modulo
+    static const unsigned int maxRun = 5552;
 
-    for (unsigned int i = 0 ; i < size ; ++i)
+    unsigned int s1 = adler & 0xFFFF;
+    unsigned int s2 = adler >> 16;
+
+    while (size)
     {
-        s1 += chunk[i];
+        unsigned int run = std::min(size, maxRun);
+        size -= run;
+
+        for (unsigned int i = 0 ; i < run ; ++i)
+        {
+            s1 += data[i];
+            s2 += s1;
+        }
+        data += run;
+
         s1 %= 65521;
-        s2 += s1;
         s2 %= 65521;
     }
 
@@ -83,6 +117,59 @@ Hash<32> Hasher::getSha256(const MemChunk& chunk)
     return sha.get();
 }
 
+uint64_t Hasher::getXXH64(const MemChunk& chunk, uint64_t seed)
+{
+    unsigned int size = chunk.size();
+    const unsigned char* p = size ? chunk.data() : nullptr;
+    const unsigned char* end = p + size;
+    uint64_t result;
+
+    if (size >= 32)
+    {
+        // four independent lanes, merged at the end
+        uint64_t v1 = seed + xxhPrime1 + xxhPrime2;
+        uint64_t v2 = seed + xxhPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - xxhPrime1;
+
+        for ( ; p + 32 <= end ; p += 32)
+        {
+            v1 = xxhRound(v1, readLE64(p));
+            v2 = xxhRound(v2, readLE64(p + 8));
+            v3 = xxhRound(v3, readLE64(p + 16));
+            v4 = xxhRound(v4, readLE64(p + 24));
+        }
+
+        result = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        result = xxhMerge(result, v1);
+        result = xxhMerge(result, v2);
+        result = xxhMerge(result, v3);
+        result = xxhMerge(result, v4);
+    }
+    else
+        result = seed + xxhPrime5;
+
+    result += size;
+
+    for ( ; p + 8 <= end ; p += 8)
+        result = rotateLeft(result ^ xxhRound(0, readLE64(p)), 27) * xxhPrime1 + xxhPrime4;
+    if (p + 4 <= end)
+    {
+        result = rotateLeft(result ^ (readLE32(p) * xxhPrime1), 23) * xxhPrime2 + xxhPrime3;
+        p += 4;
+    }
+    for ( ; p < end ; ++p)
+        result = rotateLeft(result ^ (*p * xxhPrime5), 11) * xxhPrime1;
+
+    result ^= result >> 33;
+    result *= xxhPrime2;
+    result ^= result >> 29;
+    result *= xxhPrime3;
+    result ^= result >> 32;
+
+    return result;
+}
+
 
 const std::vector<unsigned int>& Hasher::generateCRC32Table(unsigned int magic)
 {
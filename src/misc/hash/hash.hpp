@@ -43,10 +43,17 @@ class Hasher
 {
 public:
     static unsigned int getAdler32(const MemChunk& chunk);
+    // Adler32 of data following the data of the given checksum (1 initially).
+    static unsigned int updateAdler32(unsigned int adler, const unsigned char* data, unsigned int size);
     static unsigned int getCRC32(const MemChunk& chunk, unsigned int magic = 0xEDB88320);
     static uint64_t getCRC64(const MemChunk& chunk, uint64_t magic = 0xC96C5795D7870F42ull);
     static unsigned int getCRC32Reverse(const MemChunk& chunk, unsigned int magic = 0x04C11DB7);
     static Hash<32> getSha256(const MemChunk& chunk);
+    // Fast non-cryptographic hash (xxHash64), for cache keys.
+    static uint64_t getXXH64(const MemChunk& chunk, uint64_t seed = 0);
+    // FNV-1a, one step per element (bytes, or UTF-16 code units), for hash tables of short strings.
+    template <typename T>
+    static inline uint32_t getFNV1a(const T* data, unsigned int length);
 
 private:
     static const std::vector<unsigned int>& generateCRC32Table(unsigned int magic);
@@ -54,6 +61,18 @@ private:
     static const std::vector<unsigned int>& generateCRC32ReverseTable(unsigned int magic);
 };
 
+template <typename T>
+inline uint32_t Hasher::getFNV1a(const T* data, unsigned int length)
+{
+    uint32_t h = 2166136261u;
+    for (unsigned int i = 0 ; i < length ; ++i)
+    {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
 }
 
 #endif // TYREX_HASH_HPP
@@ -22,12 +22,12 @@
 
 namespace tyrex {
 
+static const unsigned int readBlockSize = 64 * 1024;
+
 MemChunk::MemChunk(const std::string& str) :
     Chunk<unsigned char>()
 {
-    for (char c : str)
-        mData->push_back(c);
-    mSize = str.size();
+    this->append(str.data(), str.size());
 }
 
 bool MemChunk::operator==(const std::string& str) const
@@ -45,22 +45,16 @@ bool MemChunk::operator==(const std::string& str) const
 
 void MemChunk::append(const std::string& str)
 {
-    for (char c : str)
-        mData->push_back(c);
-    mSize += str.size();
+    this->append(str.data(), str.size());
 }
 
 bool MemChunk::append(std::ifstream& file)
 {
-    char c;
+    std::vector<char> buffer(readBlockSize);
     while (file.good())
     {
-        c = file.get();
-        if (file.good())
-        {
-            mData->push_back(c);
-            ++mSize;
-        }
+        file.read(buffer.data(), readBlockSize);
+        this->append(buffer.data(), file.gcount());
     }
 
     return true;
@@ -68,9 +62,7 @@ bool MemChunk::append(std::ifstream& file)
 
 void MemChunk::append(const char* data, unsigned int size)
 {
-    for (unsigned int i = 0 ; i < size ; ++i)
-        mData->push_back(data[i]);
-    mSize += size;
+    this->append(reinterpret_cast<const unsigned char*>(data), size);
 }
 
 void MemChunk::write(std::ostream& file) const
@@ -36,6 +36,7 @@ public:
 
     inline MemChunk();
     inline MemChunk(unsigned int size);
+    inline MemChunk(unsigned char* data, unsigned int size, const std::shared_ptr<void>& owner);
     inline MemChunk(const Chunk<unsigned char>& other);
     MemChunk(const std::string& str);
 
@@ -76,6 +77,8 @@ inline MemChunk::MemChunk() :
     Chunk<unsigned char>() {}
 inline MemChunk::MemChunk(unsigned int size) :
     Chunk<unsigned char>(size) {}
+inline MemChunk::MemChunk(unsigned char* data, unsigned int size, const std::shared_ptr<void>& owner) :
+    Chunk<unsigned char>(data, size, owner) {}
 inline MemChunk::MemChunk(const Chunk<unsigned char>& other) :
     Chunk<unsigned char>(other) {}
 
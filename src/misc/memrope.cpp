@@ -0,0 +1,122 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "memrope.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tyrex {
+
+MemRope::MemRope() :
+    mSize(0)
+{
+}
+
+MemRope::MemRope(const MemChunk& chunk) :
+    mSize(0)
+{
+    this->append(chunk);
+}
+
+
+void MemRope::append(const MemChunk& chunk)
+{
+    if (!chunk.size())
+        return;
+
+    if (!mExtents.empty() && mExtents.back().adjacent(chunk))
+        mExtents.back().append(chunk);
+    else
+    {
+        mExtents.push_back(chunk);
+        mOffsets.push_back(mSize);
+    }
+    mSize += chunk.size();
+}
+
+void MemRope::append(const MemRope& rope)
+{
+    for (const MemChunk& chunk : rope.mExtents)
+        this->append(chunk);
+}
+
+MemRope MemRope::subRope(uint64_t start, uint64_t size) const
+{
+    MemRope result;
+    if (start + size > mSize || start + size < start || !size)
+        return result;
+
+    for (unsigned int i = this->findExtent(start) ; size ; ++i)
+    {
+        unsigned int begin = start - mOffsets[i];
+        unsigned int length = std::min<uint64_t>(size, mExtents[i].size() - begin);
+        result.append(mExtents[i].subChunk(begin, length));
+        start += length;
+        size -= length;
+    }
+
+    return result;
+}
+
+MemChunk MemRope::flatten() const
+{
+    if (mExtents.size() == 1)
+        return mExtents[0];
+
+    MemChunk result;
+    result.reserve(mSize);
+    for (const MemChunk& chunk : mExtents)
+        result.append(chunk.data(), chunk.size());
+    return result;
+}
+
+bool MemRope::read(uint64_t start, unsigned char* dst, unsigned int size) const
+{
+    if (start + size > mSize || start + size < start)
+        return false;
+    if (!size)
+        return true;
+
+    for (unsigned int i = this->findExtent(start) ; size ; ++i)
+    {
+        unsigned int begin = start - mOffsets[i];
+        unsigned int length = std::min(size, mExtents[i].size() - begin);
+        std::memcpy(dst, mExtents[i].data() + begin, length);
+        dst += length;
+        start += length;
+        size -= length;
+    }
+
+    return true;
+}
+
+
+unsigned char MemRope::operator[](uint64_t pos) const
+{
+    unsigned int i = this->findExtent(pos);
+    return mExtents[i][pos - mOffsets[i]];
+}
+
+// Index of the extent containing pos, which must be in range.
+unsigned int MemRope::findExtent(uint64_t pos) const
+{
+    return std::upper_bound(mOffsets.begin(), mOffsets.end(), pos) - mOffsets.begin() - 1;
+}
+
+}
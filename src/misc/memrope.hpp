@@ -0,0 +1,74 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_MEMROPE_HPP
+#define TYREX_MEMROPE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "memchunk.hpp"
+
+namespace tyrex {
+
+// A sequence of MemChunks read as a single one, without copying them (e.g. the IDAT chunks of a png).
+// Extents are kept in order with their offsets : appending is O(1), access by position is a binary search.
+// Contiguous extents of the same block are merged, so that flattening a rope of consecutive slices is free.
+class MemRope
+{
+public:
+    MemRope();
+    MemRope(const MemChunk& chunk);
+
+    void append(const MemChunk& chunk);
+    void append(const MemRope& rope);
+    MemRope subRope(uint64_t start, uint64_t size) const;
+    // Single chunk with the whole content : shared if there is a single extent, copied otherwise.
+    MemChunk flatten() const;
+    // Copies [start, start + size) to dst ; false if out of range.
+    bool read(uint64_t start, unsigned char* dst, unsigned int size) const;
+
+    inline uint64_t size() const;
+    inline bool empty() const;
+    inline unsigned int extentCount() const;
+    inline const MemChunk& extent(unsigned int i) const;
+    inline uint64_t extentOffset(unsigned int i) const;
+    // Warning : unchecked access to data !
+    unsigned char operator[](uint64_t pos) const;
+
+private:
+    unsigned int findExtent(uint64_t pos) const;
+
+    std::vector<MemChunk> mExtents;
+    std::vector<uint64_t> mOffsets;
+    uint64_t mSize;
+};
+
+inline uint64_t MemRope::size() const
+    {return mSize;}
+inline bool MemRope::empty() const
+    {return !mSize;}
+inline unsigned int MemRope::extentCount() const
+    {return mExtents.size();}
+inline const MemChunk& MemRope::extent(unsigned int i) const
+    {return mExtents[i];}
+inline uint64_t MemRope::extentOffset(unsigned int i) const
+    {return mOffsets[i];}
+
+}
+
+#endif // TYREX_MEMROPE_HPP
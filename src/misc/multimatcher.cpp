@@ -0,0 +1,170 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "multimatcher.hpp"
+
+#include <queue>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TYREX_MULTIMATCHER_SSE2
+#endif
+
+namespace tyrex {
+
+// above, testing each pair costs more than the automaton saves
+static const unsigned int maxVectorPairs = 16;
+
+MultiMatcher::MultiMatcher()
+{
+}
+
+
+void MultiMatcher::addPattern(const std::vector<unsigned char>& pattern)
+{
+    mPatterns.push_back(pattern);
+}
+
+void MultiMatcher::build()
+{
+    // trie of the patterns, 0 meaning "no child" (the root is never a child)
+    std::vector<unsigned int> children(256, 0);
+    mOutputs.assign(1, std::vector<unsigned int>());
+
+    for (unsigned int p = 0 ; p < mPatterns.size() ; ++p)
+    {
+        unsigned int state = 0;
+        for (unsigned char c : mPatterns[p])
+        {
+            if (!children[(state << 8) | c])
+            {
+                children[(state << 8) | c] = mOutputs.size();
+                children.resize(children.size() + 256, 0);
+                mOutputs.push_back(std::vector<unsigned int>());
+            }
+            state = children[(state << 8) | c];
+        }
+        mOutputs[state].push_back(p);
+    }
+
+    // breadth-first, so that failure links point to states already complete
+    unsigned int stateCount = mOutputs.size();
+    std::vector<unsigned int> fail(stateCount, 0);
+    mTransitions.assign(stateCount << 8, 0);
+
+    std::queue<unsigned int> queue;
+    for (unsigned int c = 0 ; c < 256 ; ++c)
+    {
+        unsigned int child = children[c];
+        mTransitions[c] = child;
+        if (child)
+            queue.push(child);
+    }
+
+    while (!queue.empty())
+    {
+        unsigned int state = queue.front();
+        queue.pop();
+
+        for (unsigned int c = 0 ; c < 256 ; ++c)
+        {
+            unsigned int child = children[(state << 8) | c];
+            if (child)
+            {
+                fail[child] = mTransitions[(fail[state] << 8) | c];
+                const std::vector<unsigned int>& inherited = mOutputs[fail[child]];
+                mOutputs[child].insert(mOutputs[child].end(), inherited.begin(), inherited.end());
+
+                mTransitions[(state << 8) | c] = child;
+                queue.push(child);
+            }
+            else
+                mTransitions[(state << 8) | c] = mTransitions[(fail[state] << 8) | c];
+        }
+    }
+
+    mStarts.assign(65536 / 64, 0);
+    mStartPairs.clear();
+    bool singleBytes = false;
+    for (const std::vector<unsigned char>& pattern : mPatterns)
+    {
+        if (pattern.empty())
+            continue;
+
+        unsigned char first = pattern[0];
+        singleBytes |= pattern.size() == 1;
+        if (pattern.size() > 1 && !this->mayStart(first, pattern[1]))
+            mStartPairs.push_back(std::make_pair(first, pattern[1]));
+
+        for (unsigned int second = 0 ; second < 256 ; ++second)
+            if (pattern.size() == 1 || pattern[1] == second)
+                mStarts[(first << 2) | (second >> 6)] |= uint64_t(1) << (second & 63);
+    }
+    if (singleBytes || mStartPairs.size() > maxVectorPairs)
+        mStartPairs.clear();
+
+    // flags are set last, the links above need plain state numbers
+    for (unsigned int& next : mTransitions)
+        if (!mOutputs[next].empty())
+            next |= matchFlag;
+}
+
+
+unsigned int MultiMatcher::skip(const unsigned char* data, unsigned int pos, unsigned int size) const
+{
+#ifdef TYREX_MULTIMATCHER_SSE2
+    if (!mStartPairs.empty())
+    {
+        __m128i firsts[maxVectorPairs];
+        __m128i seconds[maxVectorPairs];
+        unsigned int count = mStartPairs.size();
+        for (unsigned int k = 0 ; k < count ; ++k)
+        {
+            firsts[k] = _mm_set1_epi8(static_cast<char>(mStartPairs[k].first));
+            seconds[k] = _mm_set1_epi8(static_cast<char>(mStartPairs[k].second));
+        }
+
+        // compares the bytes at [pos, pos + 16) and their successors
+        for ( ; pos + 17 <= size ; pos += 16)
+        {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 1));
+
+            __m128i hits = _mm_setzero_si128();
+            for (unsigned int k = 0 ; k < count ; ++k)
+                hits = _mm_or_si128(hits, _mm_and_si128(_mm_cmpeq_epi8(first, firsts[k]), _mm_cmpeq_epi8(second, seconds[k])));
+
+            unsigned int mask = _mm_movemask_epi8(hits);
+            if (mask)
+            {
+                while (!(mask & 1))
+                {
+                    mask >>= 1;
+                    ++pos;
+                }
+                return pos;
+            }
+        }
+    }
+#endif
+
+    while (pos + 1 < size && !this->mayStart(data[pos], data[pos + 1]))
+        ++pos;
+    return pos;
+}
+
+}
@@ -0,0 +1,101 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_MULTIMATCHER_HPP
+#define TYREX_MULTIMATCHER_HPP
+
+#include "memchunk.hpp"
+#include <vector>
+
+namespace tyrex {
+
+// Finds all occurrences of a set of byte strings in a single pass (Aho-Corasick automaton).
+// Transitions are stored as a dense table of 256 entries per state, so that scanning costs one lookup per byte,
+// whatever the number of patterns. The table stays small (a few states per pattern byte) and in cache.
+// Outside of a partial match, the scan skips ahead to the next pair of bytes that starts a pattern :
+// this test does not depend on the previous byte, and runs much faster than the automaton (16 bytes at a time with SSE2).
+class MultiMatcher
+{
+public:
+    MultiMatcher();
+
+    // patterns are numbered in order of insertion ; build() must be called after the last one
+    void addPattern(const std::vector<unsigned char>& pattern);
+    void build();
+
+    inline unsigned int patternCount() const;
+    inline unsigned int patternLength(unsigned int pattern) const;
+
+    // calls match(start, pattern) for each occurrence, by increasing end offset
+    template <typename F>
+    void find(const MemChunk& chunk, F match) const;
+
+private:
+    // set on transitions to states where patterns end
+    static const unsigned int matchFlag = 0x80000000;
+
+    inline bool mayStart(unsigned char first, unsigned char second) const;
+    // first position from pos where a pattern may start, or the last byte
+    unsigned int skip(const unsigned char* data, unsigned int pos, unsigned int size) const;
+
+    std::vector<std::vector<unsigned char> > mPatterns;
+    // mTransitions[(state << 8) | byte], with matchFlag
+    std::vector<unsigned int> mTransitions;
+    // patterns ending at each state, including through failure links
+    std::vector<std::vector<unsigned int> > mOutputs;
+    // bit (first << 8) | second is set if a pattern starts with these bytes
+    std::vector<uint64_t> mStarts;
+    // the same pairs as a list, if it is short enough to be tested with vector instructions
+    std::vector<std::pair<unsigned char, unsigned char> > mStartPairs;
+};
+
+inline unsigned int MultiMatcher::patternCount() const
+    {return mPatterns.size();}
+inline unsigned int MultiMatcher::patternLength(unsigned int pattern) const
+    {return mPatterns[pattern].size();}
+inline bool MultiMatcher::mayStart(unsigned char first, unsigned char second) const
+    {return (mStarts[(first << 2) | (second >> 6)] >> (second & 63)) & 1;}
+
+template <typename F>
+void MultiMatcher::find(const MemChunk& chunk, F match) const
+{
+    unsigned int size = chunk.size();
+    if (!size || mTransitions.empty())
+        return;
+
+    const unsigned char* data = chunk.data();
+    const unsigned int* transitions = mTransitions.data();
+    unsigned int state = 0;
+
+    for (unsigned int i = 0 ; i < size ; ++i)
+    {
+        if (!state)
+            i = this->skip(data, i, size);
+
+        unsigned int next = transitions[(state << 8) | data[i]];
+        state = next & ~matchFlag;
+
+        if (next & matchFlag)
+            for (unsigned int pattern : mOutputs[state])
+                match(i + 1 - mPatterns[pattern].size(), pattern);
+    }
+}
+
+}
+
+#endif // TYREX_MULTIMATCHER_HPP
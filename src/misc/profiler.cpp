@@ -0,0 +1,223 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace tyrex {
+
+std::atomic<bool> Profiler::mEnabled(false);
+Profiler::Clock::time_point Profiler::mOrigin;
+thread_local std::vector<Profiler::Frame> Profiler::mStack;
+std::vector<Profiler::Event> Profiler::mEvents;
+unsigned int Profiler::mReported = 0;
+
+// guards mEvents and mReported
+static std::mutex eventsMutex;
+static std::atomic<unsigned int> threadCount(0);
+static thread_local unsigned int threadId = 0;
+
+
+void Profiler::setEnabled(bool enabled)
+{
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        if (enabled && !Profiler::enabled() && mEvents.empty())
+            mOrigin = Clock::now();
+    }
+    mEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::hasEvents()
+{
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    return !mEvents.empty();
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    mEvents.clear();
+    mReported = 0;
+    mOrigin = Clock::now();
+}
+
+
+void Profiler::begin(const std::string& name)
+{
+    if (!threadId)
+        threadId = ++threadCount;
+
+    Frame frame;
+    frame.mName = name;
+    std::fill(frame.mCounters, frame.mCounters + counterCount, 0);
+    mStack.push_back(frame);
+
+    // start the clock last, not to time the bookkeeping
+    mStack.back().mStart = Clock::now();
+}
+
+void Profiler::end()
+{
+    Clock::time_point stop = Clock::now();
+    if (mStack.empty())
+        return;
+
+    const Frame& frame = mStack.back();
+
+    Event event;
+    event.mName = frame.mName;
+    event.mThread = threadId;
+    event.mDepth = mStack.size() - 1;
+    event.mStart = std::chrono::duration<double, std::micro>(frame.mStart - mOrigin).count();
+    event.mDuration = std::chrono::duration<double, std::micro>(stop - frame.mStart).count();
+    std::copy(frame.mCounters, frame.mCounters + counterCount, event.mCounters);
+
+    mStack.pop_back();
+
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    mEvents.push_back(event);
+}
+
+void Profiler::add(Counter counter, uint64_t value)
+{
+    if (!mStack.empty())
+        mStack.back().mCounters[counter] += value;
+}
+
+
+std::string Profiler::takeReport()
+{
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.assign(mEvents.begin() + mReported, mEvents.end());
+        mReported = mEvents.size();
+    }
+
+    // events are stored when they end : sort by start to print parents before children, one thread after the other
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {return a.mThread < b.mThread || (a.mThread == b.mThread && a.mStart < b.mStart);});
+
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2);
+
+    for (unsigned int i = 0 ; i < events.size() ; ++i)
+    {
+        const Event& event = events[i];
+        if (event.mThread != 1 && (i == 0 || events[i - 1].mThread != event.mThread))
+            os << "thread " << event.mThread << " :\n";
+
+        os << std::string(2 * event.mDepth, ' ') << event.mName << " : " << event.mDuration / 1000 << " ms";
+        for (unsigned int i = 0 ; i < counterCount ; ++i)
+            if (event.mCounters[i])
+                os << ", " << Profiler::counterName(static_cast<Counter>(i)) << " " << event.mCounters[i];
+        os << "\n";
+    }
+
+    return os.str();
+}
+
+void Profiler::writeTrace(std::ostream& os)
+{
+    std::lock_guard<std::mutex> lock(eventsMutex);
+
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    os << std::fixed << std::setprecision(3);
+
+    for (unsigned int i = 0 ; i < mEvents.size() ; ++i)
+    {
+        const Event& event = mEvents[i];
+
+        std::string name;
+        for (char c : event.mName)
+        {
+            if (c == '"' || c == '\\')
+                name += '\\';
+            name += c;
+        }
+
+        os << (i ? ",\n" : "\n")
+           << "{\"name\": \"" << name << "\", \"cat\": \"tyrex\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.mThread
+           << ", \"ts\": " << event.mStart << ", \"dur\": " << event.mDuration
+           << ", \"args\": {";
+
+        bool first = true;
+        for (unsigned int k = 0 ; k < counterCount ; ++k)
+        {
+            if (event.mCounters[k])
+            {
+                os << (first ? "" : ", ") << "\"" << Profiler::counterName(static_cast<Counter>(k)) << "\": " << event.mCounters[k];
+                first = false;
+            }
+        }
+        os << "}}";
+    }
+
+    os << "\n]}\n";
+}
+
+
+const char* Profiler::counterName(Counter counter)
+{
+    switch (counter)
+    {
+    case bytesIn:
+        return "bytes in";
+    case bytesOut:
+        return "bytes out";
+    case allocations:
+        return "allocations";
+    case colorizerEntries:
+        return "colorizer entries";
+    case treeNodes:
+        return "tree nodes";
+    default:
+        return "";
+    }
+}
+
+std::string Profiler::typeName(const std::type_info& type)
+{
+    std::string result = type.name();
+
+#ifdef __GNUG__
+    int status;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (status == 0 && demangled)
+        result = demangled;
+    std::free(demangled);
+#endif
+
+    // drop namespaces, they are the same everywhere
+    for (const std::string prefix : {"tyrex::parse::", "tyrex::data::", "tyrex::"})
+        for (std::size_t pos ; (pos = result.find(prefix)) != std::string::npos ; )
+            result.erase(pos, prefix.size());
+
+    return result;
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PROFILER_HPP
+#define TYREX_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace tyrex {
+
+// Scoped timers and counters, to find out where the time goes when a document is opened.
+// Scopes nest (recursive formats give nested events). A counter is attributed to the innermost open scope only.
+// Each thread has its own stack of scopes ; the events of all threads are gathered in a single list.
+// When profiling is disabled (the default), a scope or a counter costs a single test.
+class Profiler
+{
+public:
+    enum Counter {
+        bytesIn,
+        bytesOut,
+        allocations,
+        colorizerEntries,
+        treeNodes,
+        counterCount
+    };
+
+    struct Event
+    {
+        std::string mName;
+        // threads are numbered from 1 in the order they first open a scope
+        unsigned int mThread;
+        unsigned int mDepth;
+        // microseconds since profiling was enabled
+        double mStart;
+        double mDuration;
+        uint64_t mCounters[counterCount];
+    };
+
+    class Scope
+    {
+    public:
+        inline Scope(const char* name);
+        inline Scope(const std::string& name);
+        // named after the dynamic type, e.g. Profiler::Scope scope(typeid(*this));
+        inline Scope(const std::type_info& type);
+        inline ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool mActive;
+    };
+
+    static inline bool enabled();
+    static void setEnabled(bool enabled);
+    static inline void count(Counter counter, uint64_t value = 1);
+
+    static void clear();
+    // whether events were recorded ; locked, so that it may be called while other threads are profiling
+    static bool hasEvents();
+    // Indented report of the events completed since the previous call.
+    static std::string takeReport();
+    // Chrome trace format (chrome://tracing, Perfetto).
+    static void writeTrace(std::ostream& os);
+
+    static const char* counterName(Counter counter);
+    static std::string typeName(const std::type_info& type);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Frame
+    {
+        std::string mName;
+        Clock::time_point mStart;
+        uint64_t mCounters[counterCount];
+    };
+
+    static void begin(const std::string& name);
+    static void end();
+    static void add(Counter counter, uint64_t value);
+
+    // read by the parsing threads, toggled from the GUI
+    static std::atomic<bool> mEnabled;
+    static Clock::time_point mOrigin;
+    static thread_local std::vector<Frame> mStack;
+    static std::vector<Event> mEvents;
+    static unsigned int mReported;
+};
+
+inline Profiler::Scope::Scope(const char* name) :
+    mActive(Profiler::mEnabled.load(std::memory_order_relaxed))
+    {if (mActive) Profiler::begin(name);}
+inline Profiler::Scope::Scope(const std::string& name) :
+    mActive(Profiler::mEnabled.load(std::memory_order_relaxed))
+    {if (mActive) Profiler::begin(name);}
+inline Profiler::Scope::Scope(const std::type_info& type) :
+    mActive(Profiler::mEnabled.load(std::memory_order_relaxed))
+    {if (mActive) Profiler::begin(Profiler::typeName(type));}
+inline Profiler::Scope::~Scope()
+    {if (mActive) Profiler::end();}
+
+inline bool Profiler::enabled()
+    {return mEnabled.load(std::memory_order_relaxed);}
+inline void Profiler::count(Counter counter, uint64_t value)
+    {if (mEnabled.load(std::memory_order_relaxed)) Profiler::add(counter, value);}
+
+}
+
+#endif // TYREX_PROFILER_HPP
@@ -20,18 +20,21 @@
 #define TYREX_TREE_TPL
 
 #include "tree.hpp"
+#include "profiler.hpp"
 
 namespace tyrex {
 
 template <typename LeafT, typename NodeT>
 void TreeNode<LeafT, NodeT>::appendLeaf(QString title, const LeafT& content)
 {
+    Profiler::count(Profiler::treeNodes);
     mLeaves.append(TreeLeaf<LeafT>(title, content));
 }
 
 template <typename LeafT, typename NodeT>
 void TreeNode<LeafT, NodeT>::appendTree(std::shared_ptr<NodeT> tree)
 {
+    Profiler::count(Profiler::treeNodes);
     mSubtrees.append(tree);
 }
 
@@ -39,6 +42,7 @@ void TreeNode<LeafT, NodeT>::appendTree(std::shared_ptr<NodeT> tree)
 template <typename NodeT>
 void TreeNodeVoid<NodeT>::appendTree(std::shared_ptr<NodeT> tree)
 {
+    Profiler::count(Profiler::treeNodes);
     mSubtrees.append(tree);
 }
 
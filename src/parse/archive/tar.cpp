@@ -19,36 +19,60 @@
 #include "tar.hpp"
 
 #include "tarfile.hpp"
+#include "tarindex.hpp"
+#include "misc/profiler.hpp"
 
 namespace tyrex {
 namespace parse {
 
+Tar::Tar() :
+    mIndex(data::ArchiveIndex::unixTime)
+{
+}
+
 void Tar::onError(const MemChunk& chunk, std::shared_ptr<data::Archive>& data)
 {
-    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mTarFilter, mExtractedFiles);
+    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mTarFilter, mIndex, mExtractedFiles);
 }
 
 void Tar::doParse(const MemChunk& chunk, std::shared_ptr<data::Archive>& data)
 {
-    unsigned int size = chunk.size();
-    unsigned int processed = 0;
+    TarIndex tarIndex(chunk);
+    std::vector<TarReader::Entry> entries;
+    bool cached;
+    {
+        Profiler::Scope scope("load tar index");
+        cached = tarIndex.load(entries);
+        // the key only covers the edges of the archive : a member changed in the middle falls back to a full scan
+        for (unsigned int i = 0 ; cached && i < entries.size() ; ++i)
+            cached = TarReader::matches(chunk, entries[i]);
+    }
+
+    TarReader reader = cached ? TarReader(chunk, entries) : TarReader(chunk);
+    TarFile tarFile(mSrcColorizer, mIndex, reader);
+    bool complete = true;
 
-    while (processed < size)
+    while (!reader.atEnd())
     {
-        TarFile tarFile(mSrcColorizer, processed);
+        unsigned int position = reader.position();
 
         data::File file;
-        if (!tarFile.parse(chunk.subChunk(processed), file))
+        if (!tarFile.parse(chunk, file))
         {
-            Except::reportWarning(processed, "tar file extraction", "error decoding file");
+            Except::reportWarning(position, "tar file extraction", "error decoding file");
+            complete = false;
             break;
         }
 
-        processed = tarFile.processed();
+        if (!cached)
+            tarIndex.append(tarFile.entry());
         mExtractedFiles.push_back(file);
     }
 
-    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mTarFilter, mExtractedFiles);
+    if (!cached && complete)
+        tarIndex.save();
+
+    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mTarFilter, mIndex, mExtractedFiles);
 }
 
 }
@@ -28,13 +28,14 @@ namespace parse {
 class Tar : public DataParser<data::Archive>
 {
 public:
-    Tar() = default;
+    Tar();
 
 private:
     void doParse(const MemChunk& chunk, std::shared_ptr<data::Archive>& data);
     void onError(const MemChunk& chunk, std::shared_ptr<data::Archive>& data);
 
     data::Colorizer mSrcColorizer;
+    data::ArchiveIndex mIndex;
     std::vector<data::File> mExtractedFiles;
 };
 
@@ -18,111 +18,47 @@
 
 #include "tarfile.hpp"
 
-#include "misc/util.hpp"
-
-#include <QDateTime>
-
 namespace tyrex {
 namespace parse {
 
-TarFile::TarFile(data::Colorizer& srcColorizer, unsigned int processed) :
+TarFile::TarFile(data::Colorizer& srcColorizer, data::ArchiveIndex& index, TarReader& reader) :
     mSrcColorizer(srcColorizer),
-    mProcessed(processed)
+    mIndex(index),
+    mReader(reader)
 {
 }
 
 
-void TarFile::doParse(const MemChunk& chunk, data::File& file)
+void TarFile::doParse(const MemChunk&, data::File& file)
 {
-    unsigned int size = chunk.size();
-
-    if (size < 0x200)
-        Except::reportError(mProcessed + size, "tar file header", "unexpected end of data");
-
-    mSrcColorizer.addHighlight(mProcessed, 0x200, QColor(128, 0, 255, 64));
-    mSrcColorizer.addSeparation(mProcessed, 2);
-    mSrcColorizer.addSeparation(mProcessed + 100, 1);
-    mSrcColorizer.addSeparation(mProcessed + 108, 1);
-    mSrcColorizer.addSeparation(mProcessed + 116, 1);
-    mSrcColorizer.addSeparation(mProcessed + 124, 1);
-    mSrcColorizer.addSeparation(mProcessed + 136, 1);
-    mSrcColorizer.addSeparation(mProcessed + 148, 1);
-    mSrcColorizer.addSeparation(mProcessed + 156, 1);
-    mSrcColorizer.addSeparation(mProcessed + 157, 1);
-    mSrcColorizer.addSeparation(mProcessed + 257, 1);
-    mSrcColorizer.addSeparation(mProcessed + 0x200, 2);
-
-    data::FileInfo fileInfo;
-
-    unsigned int fileNameLength = 0;
-    for (unsigned int i = 0 ; i < 100 ; ++i)
-    {
-        if (!chunk[i])
-        {
-            fileNameLength = i;
-            break;
-        }
-    }
-
-    if (!fileNameLength)
-        Except::reportError(mProcessed, "tar file header", "invalid file name");
-    fileInfo.mInfos[data::FileInfo::fileName] = Util::chunkToUtf8(chunk.subChunk(0, fileNameLength));
-
-    bool ok;
-    unsigned int mode = Util::numFromOctal(chunk.subChunk(100, 8), ok);
-    if (!ok)
-        Except::reportError(mProcessed + 100, "tar file header", "invalid file mode");
-    fileInfo.mInfos[data::FileInfo::fileMode] = QString::number(mode, 8);
-
-    unsigned int uid = Util::numFromOctal(chunk.subChunk(108, 8), ok);
-    if (!ok)
-        Except::reportError(mProcessed + 108, "tar file header", "invalid user id");
-    fileInfo.mInfos[data::FileInfo::fileMode] = QString::number(uid);
-
-    unsigned int gid = Util::numFromOctal(chunk.subChunk(116, 8), ok);
-    if (!ok)
-        Except::reportError(mProcessed + 116, "tar file header", "invalid group id");
-    fileInfo.mInfos[data::FileInfo::fileMode] = QString::number(gid);
-
-    unsigned int fileSize = Util::numFromOctal(chunk.subChunk(124, 12), ok);
-    if (!ok)
-        Except::reportError(mProcessed + 124, "tar file header", "invalid file size");
-    fileInfo.mInfos[data::FileInfo::size] = QString::number(fileSize);
-
-    unsigned int mtime = Util::numFromOctal(chunk.subChunk(136, 12), ok);
-    if (!ok)
-        Except::reportError(mProcessed + 136, "tar file header", "invalid modification time");
-    QDateTime dateTime = QDateTime(QDate(1970, 1, 1), QTime(0, 0)).addSecs(mtime);
-    fileInfo.mInfos[data::FileInfo::modDateTime] = dateTime.toString("dd MMM yyyy  hh:mm:ss");
-
-    unsigned int checksum = Util::numFromOctal(chunk.subChunk(148, 8), ok);
-    if (!ok)
-        Except::reportError(mProcessed + 148, "tar file header", "invalid checksum");
-
-    unsigned int tmp = 0;
-    for (unsigned int i = 0 ; i < 0x200 ; ++i)
-    {
-        if (i >= 148 && i < 156)
-            tmp += 0x20;
-        else
-            tmp += chunk[i];
-    }
-    if (tmp != checksum)
-        Except::reportError(mProcessed + 148, "tar file header", "invalid checksum");
-
-
-    if (!Util::checkRange(fileSize, 0x200, size))
-        Except::reportError(size, "tar file", "unexpected end of data");
-
-    file.mChunk = chunk.subChunk(0x200, fileSize);
-    file.mInfo = fileInfo;
-
-
-    mSrcColorizer.addHighlight(mProcessed + 0x200, fileSize, QColor(128, 128, 255, 64));
-    mSrcColorizer.addSeparation(mProcessed + 0x200 + fileSize, 2);
-
-    fileSize = (fileSize + 0x1FF) & 0xFFFFFE00;
-    mProcessed += 0x200 + fileSize;
+    TarReader::Entry& entry = mEntry;
+    mReader.next(entry);
+
+    // one highlight for the headers (including extensions) and one for the data
+    mSrcColorizer.addHighlight(entry.mHeaderOffset, entry.mDataOffset - entry.mHeaderOffset, QColor(128, 0, 255, 64));
+    mSrcColorizer.addSeparation(entry.mHeaderOffset, 2);
+    mSrcColorizer.addHighlight(entry.mDataOffset, entry.mSize, QColor(128, 128, 255, 64));
+    mSrcColorizer.addSeparation(entry.mDataOffset, 1);
+
+    file.mChunk = mReader.contents(entry);
+
+    unsigned int row = mIndex.appendRow();
+    file.mRow = row;
+
+    mIndex.setString(row, data::FileInfo::fileName, entry.mName);
+    mIndex.setNumber(row, data::FileInfo::fileMode, entry.mMode);
+    mIndex.setNumber(row, data::FileInfo::userId, entry.mUserId);
+    mIndex.setNumber(row, data::FileInfo::groupId, entry.mGroupId);
+    mIndex.setString(row, data::FileInfo::userName, entry.mUserName);
+    mIndex.setString(row, data::FileInfo::groupName, entry.mGroupName);
+    mIndex.setNumber(row, data::FileInfo::size, entry.mRealSize);
+    mIndex.setNumber(row, data::FileInfo::modDateTime, entry.mModTime);
+    mIndex.setString(row, data::FileInfo::linkName, entry.mLinkName);
+    mIndex.setNumber(row, data::FileInfo::offset, entry.mHeaderOffset);
+
+    // character and block devices
+    if (entry.mType == '3' || entry.mType == '4')
+        mIndex.setNumber(row, data::FileInfo::devMajorMinor, (static_cast<uint64_t>(entry.mDevMajor) << 32) | entry.mDevMinor);
 }
 
 }
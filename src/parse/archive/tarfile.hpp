@@ -20,28 +20,34 @@
 #define TYREX_PARSE_TARFILE_HPP
 
 #include "parse/parser.tpl"
+#include "data/archiveindex.hpp"
 #include "data/file.hpp"
 #include "data/colorizer.hpp"
+#include "tarreader.hpp"
 
 namespace tyrex {
 namespace parse {
 
+// Extracts the next member of the reader.
 class TarFile : public MemchunkParser<data::File>
 {
 public:
-    TarFile(data::Colorizer& srcColorizer, unsigned int processed);
+    TarFile(data::Colorizer& srcColorizer, data::ArchiveIndex& index, TarReader& reader);
 
-    inline unsigned int processed() const;
+    // last member read
+    inline const TarReader::Entry& entry() const;
 
 private:
     void doParse(const MemChunk& chunk, data::File& file);
 
     data::Colorizer& mSrcColorizer;
-    unsigned int mProcessed;
+    data::ArchiveIndex& mIndex;
+    TarReader& mReader;
+    TarReader::Entry mEntry;
 };
 
-inline unsigned int TarFile::processed() const
-    {return mProcessed;}
+inline const TarReader::Entry& TarFile::entry() const
+    {return mEntry;}
 
 }
 }
@@ -0,0 +1,129 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "tarindex.hpp"
+
+#include "misc/diskcache.hpp"
+#include "misc/hash/hash.hpp"
+#include "misc/util.hpp"
+
+#include <algorithm>
+
+namespace tyrex {
+namespace parse {
+
+static const unsigned int hashedSize = 64 * 1024;
+static const unsigned int minCount = 1000;
+// bump when the format of entries changes
+static const quint32 formatVersion = 1;
+
+
+TarIndex::TarIndex(const MemChunk& chunk) :
+    mStream(&mData, QIODevice::WriteOnly),
+    mCount(0)
+{
+    // nothing is hashed nor serialized while the cache is disabled
+    if (!DiskCache::enabled())
+        return;
+
+    // only the edges are hashed, so that a hit costs less than the header scan ; entries are checked when loaded
+    unsigned int size = chunk.size();
+    unsigned int hashed = std::min(size, hashedSize);
+    uint64_t first = Hasher::getXXH64(chunk.subChunk(0, hashed));
+    uint64_t last = Hasher::getXXH64(chunk.subChunk(size - hashed, hashed));
+    mKey = QString::fromStdString(Util::hexToString(size, 8)
+                                  + Util::hexToString(first >> 32, 8) + Util::hexToString(first & 0xFFFFFFFF, 8)
+                                  + Util::hexToString(last >> 32, 8) + Util::hexToString(last & 0xFFFFFFFF, 8));
+
+    mStream.setVersion(QDataStream::Qt_4_8);
+    mStream << formatVersion;
+}
+
+
+bool TarIndex::load(std::vector<TarReader::Entry>& entries) const
+{
+    QByteArray data;
+    if (mKey.isEmpty() || !DiskCache("tar").load(mKey, data))
+        return false;
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_4_8);
+
+    quint32 version;
+    stream >> version;
+    if (version != formatVersion)
+        return false;
+
+    entries.clear();
+    while (!stream.atEnd() && stream.status() == QDataStream::Ok)
+    {
+        TarReader::Entry entry;
+        quint64 size;
+        quint64 realSize;
+        quint64 modTime;
+        qint8 type;
+        quint32 sparseCount;
+
+        stream >> entry.mHeaderOffset >> entry.mDataOffset >> size >> realSize >> type
+               >> entry.mName >> entry.mLinkName >> entry.mUserName >> entry.mGroupName
+               >> entry.mMode >> entry.mUserId >> entry.mGroupId >> entry.mDevMajor >> entry.mDevMinor
+               >> modTime >> entry.mSparse >> sparseCount;
+
+        entry.mSize = size;
+        entry.mRealSize = realSize;
+        entry.mModTime = modTime;
+        entry.mType = type;
+        for (quint32 i = 0 ; i < sparseCount && stream.status() == QDataStream::Ok ; ++i)
+        {
+            quint64 offset;
+            quint64 length;
+            stream >> offset >> length;
+            entry.mSparseMap.push_back(std::make_pair(offset, length));
+        }
+
+        entries.push_back(entry);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+
+void TarIndex::append(const TarReader::Entry& entry)
+{
+    if (mKey.isEmpty())
+        return;
+
+    mStream << entry.mHeaderOffset << entry.mDataOffset << static_cast<quint64>(entry.mSize) << static_cast<quint64>(entry.mRealSize) << static_cast<qint8>(entry.mType)
+            << entry.mName << entry.mLinkName << entry.mUserName << entry.mGroupName
+            << entry.mMode << entry.mUserId << entry.mGroupId << entry.mDevMajor << entry.mDevMinor
+            << static_cast<quint64>(entry.mModTime) << entry.mSparse << static_cast<quint32>(entry.mSparseMap.size());
+
+    for (auto& segment : entry.mSparseMap)
+        mStream << static_cast<quint64>(segment.first) << static_cast<quint64>(segment.second);
+
+    ++mCount;
+}
+
+void TarIndex::save() const
+{
+    if (!mKey.isEmpty() && mCount >= minCount)
+        DiskCache("tar").store(mKey, mData);
+}
+
+}
+}
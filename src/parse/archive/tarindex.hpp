@@ -0,0 +1,53 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PARSE_TARINDEX_HPP
+#define TYREX_PARSE_TARINDEX_HPP
+
+#include "tarreader.hpp"
+#include <QByteArray>
+#include <QDataStream>
+
+namespace tyrex {
+namespace parse {
+
+// List of the members of a tar archive, saved in the disk cache so that reopening the archive skips the header scan.
+// The key is the size of the archive and hashes of its first and last blocks ; loaded entries are checked
+// against their headers (see TarReader::matches). Unused while the disk cache is disabled.
+class TarIndex
+{
+public:
+    TarIndex(const MemChunk& chunk);
+
+    bool load(std::vector<TarReader::Entry>& entries) const;
+
+    void append(const TarReader::Entry& entry);
+    // only archives with many members are worth saving
+    void save() const;
+
+private:
+    QString mKey;
+    QByteArray mData;
+    QDataStream mStream;
+    unsigned int mCount;
+};
+
+}
+}
+
+#endif // TYREX_PARSE_TARINDEX_HPP
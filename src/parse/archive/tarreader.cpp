@@ -0,0 +1,559 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "tarreader.hpp"
+
+#include "parse/parseexception.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tyrex {
+namespace parse {
+
+static const unsigned int blockSize = 512;
+
+TarReader::Entry::Entry() :
+    mHeaderOffset(0),
+    mDataOffset(0),
+    mSize(0),
+    mRealSize(0),
+    mType('0'),
+    mMode(0),
+    mUserId(0),
+    mGroupId(0),
+    mDevMajor(0),
+    mDevMinor(0),
+    mModTime(0),
+    mSparse(false)
+{
+}
+
+
+TarReader::TarReader(const MemChunk& chunk) :
+    mChunk(chunk),
+    mPos(0),
+    mReplaying(false),
+    mReplayed(0)
+{
+}
+
+TarReader::TarReader(const MemChunk& chunk, const std::vector<Entry>& entries) :
+    mChunk(chunk),
+    mPos(0),
+    mReplaying(true),
+    mReplay(entries),
+    mReplayed(0)
+{
+}
+
+
+bool TarReader::atEnd() const
+{
+    if (mReplaying)
+        return mReplayed >= mReplay.size();
+
+    if (mChunk.size() - mPos < blockSize)
+        return true;
+
+    const unsigned char* header = mChunk.data() + mPos;
+    for (unsigned int i = 0 ; i < blockSize ; ++i)
+        if (header[i])
+            return false;
+    return true;
+}
+
+void TarReader::next(Entry& entry)
+{
+    if (mReplaying)
+    {
+        entry = mReplay[mReplayed++];
+        if (entry.mHeaderOffset > entry.mDataOffset)
+            Except::reportError(entry.mHeaderOffset, "tar index", "invalid entry");
+        this->checkData(entry.mDataOffset, entry.mSize);
+        mPos = this->skip(entry.mDataOffset, entry.mSize);
+        return;
+    }
+
+    entry = Entry();
+    entry.mHeaderOffset = mPos;
+
+    // extended headers of the member override the global ones
+    PaxRecords records = mGlobalRecords;
+    QString longName;
+    QString longLink;
+    bool hasLongName = false;
+    bool hasLongLink = false;
+
+    for (;;)
+    {
+        this->checkHeader(mPos);
+        const unsigned char* header = mChunk.data() + mPos;
+
+        if (!TarReader::validChecksum(header))
+            Except::reportError(mPos + 148, "tar header", "invalid checksum");
+
+        char type = header[156];
+        bool sizeOk;
+        uint64_t size = TarReader::number(header + 124, 12, sizeOk);
+        unsigned int dataPos = mPos + blockSize;
+
+        if (type == 'L' || type == 'K' || type == 'x' || type == 'g')
+        {
+            if (!sizeOk)
+                Except::reportError(mPos + 124, "tar header", "invalid file size");
+            this->checkData(dataPos, size);
+
+            if (type == 'L')
+            {
+                longName = TarReader::string(mChunk.data() + dataPos, size);
+                hasLongName = true;
+            }
+            else if (type == 'K')
+            {
+                longLink = TarReader::string(mChunk.data() + dataPos, size);
+                hasLongLink = true;
+            }
+            else
+            {
+                if (type == 'g')
+                    this->readPax(dataPos, size, mGlobalRecords);
+                this->readPax(dataPos, size, records);
+            }
+
+            mPos = this->skip(dataPos, size);
+            continue;
+        }
+
+        entry.mType = type;
+        entry.mName = TarReader::string(header, 100);
+        entry.mLinkName = TarReader::string(header + 157, 100);
+
+        // POSIX ustar : the name may be split with a prefix (GNU uses these bytes for other purposes)
+        if (std::memcmp(header + 257, "ustar", 6) == 0)
+        {
+            QString prefix = TarReader::string(header + 345, 155);
+            if (!prefix.isEmpty())
+                entry.mName = prefix + "/" + entry.mName;
+        }
+
+        entry.mMode = TarReader::number(header + 100, 8, ok);
+        if (!ok)
+            Except::reportError(mPos + 100, "tar header", "invalid file mode");
+        entry.mUserId = TarReader::number(header + 108, 8, ok);
+        if (!ok)
+            Except::reportError(mPos + 108, "tar header", "invalid user id");
+        entry.mGroupId = TarReader::number(header + 116, 8, ok);
+        if (!ok)
+            Except::reportError(mPos + 116, "tar header", "invalid group id");
+        entry.mModTime = TarReader::number(header + 136, 12, ok);
+        if (!ok)
+            Except::reportError(mPos + 136, "tar header", "invalid modification time");
+
+        entry.mUserName = TarReader::string(header + 265, 32);
+        entry.mGroupName = TarReader::string(header + 297, 32);
+        entry.mDevMajor = TarReader::number(header + 329, 8, ok);
+        entry.mDevMinor = TarReader::number(header + 337, 8, ok);
+
+        unsigned int extensionBlocks = 0;
+        if (type == 'S')
+            extensionBlocks = this->readGnuSparse(mPos, entry);
+
+        if (hasLongName)
+            entry.mName = longName;
+        if (hasLongLink)
+            entry.mLinkName = longLink;
+
+        entry.mSize = size;
+        bool sparseMapInData = false;
+        this->applyPax(records, entry, sparseMapInData);
+        if (!sizeOk && !records.count("size"))
+            Except::reportError(mPos + 124, "tar header", "invalid file size");
+
+        entry.mDataOffset = dataPos + extensionBlocks * blockSize;
+        this->checkData(entry.mDataOffset, entry.mSize);
+        mPos = this->skip(entry.mDataOffset, entry.mSize);
+
+        if (sparseMapInData)
+            this->readSparseMap(entry);
+        if (!entry.mSparse)
+            entry.mRealSize = entry.mSize;
+        return;
+    }
+}
+
+MemChunk TarReader::contents(const Entry& entry) const
+{
+    if (!entry.mSparse)
+        return mChunk.subChunk(entry.mDataOffset, entry.mSize);
+
+    if (entry.mRealSize > 0xFFFFFFFF)
+        Except::reportError(entry.mHeaderOffset, "tar sparse file", "member too large for a 32-bit chunk");
+
+    MemChunk result;
+    uint64_t stored = 0;
+
+    for (auto& segment : entry.mSparseMap)
+    {
+        uint64_t offset = segment.first;
+        uint64_t size = segment.second;
+
+        if (offset < result.size() || offset > entry.mRealSize || size > entry.mRealSize - offset || size > entry.mSize - stored)
+            Except::reportError(entry.mHeaderOffset, "tar sparse file", "invalid sparse map");
+
+        result.append(static_cast<unsigned char>(0), offset - result.size());
+        result.append(mChunk.data() + entry.mDataOffset + stored, size);
+        stored += size;
+    }
+
+    result.append(static_cast<unsigned char>(0), entry.mRealSize - result.size());
+    return result;
+}
+
+
+void TarReader::checkHeader(unsigned int pos) const
+{
+    if (mChunk.size() < blockSize || pos > mChunk.size() - blockSize)
+        Except::reportError(mChunk.size(), "tar header", "unexpected end of data");
+}
+
+void TarReader::checkData(unsigned int pos, uint64_t size) const
+{
+    // sizes are read on 64 bits, but chunks and offsets are on 32 bits
+    if (size > 0xFFFFFFFF)
+        Except::reportError(pos, "tar file", "member too large for a 32-bit chunk");
+    if (pos > mChunk.size() || size > mChunk.size() - pos)
+        Except::reportError(mChunk.size(), "tar file", "unexpected end of data");
+}
+
+unsigned int TarReader::skip(unsigned int pos, uint64_t size) const
+{
+    uint64_t padded = (size + blockSize - 1) / blockSize * blockSize;
+    // tolerate a missing padding at the end of a truncated archive
+    if (padded > mChunk.size() - pos)
+        return mChunk.size();
+    return pos + padded;
+}
+
+
+// Records are "length key=value\n", the length counting the whole record.
+void TarReader::readPax(unsigned int pos, uint64_t size, PaxRecords& records) const
+{
+    const char* data = reinterpret_cast<const char*>(mChunk.data() + pos);
+
+    for (uint64_t i = 0 ; i < size ; )
+    {
+        uint64_t j = i;
+        uint64_t length = 0;
+        for ( ; j < size && data[j] >= '0' && data[j] <= '9' && length <= size ; ++j)
+            length = 10 * length + (data[j] - '0');
+
+        if (j == i || j >= size || data[j] != ' ' || length <= j - i + 1 || length > size - i || data[i + length - 1] != '\n')
+            Except::reportError(pos + i, "tar pax header", "invalid record");
+
+        const char* begin = data + j + 1;
+        const char* end = data + i + length - 1;
+        const char* equal = std::find(begin, end, '=');
+        if (equal == end)
+            Except::reportError(pos + i, "tar pax header", "invalid record");
+
+        std::string key(begin, equal);
+        std::string value(equal + 1, end);
+
+        // sparse format 0.0 repeats these keys, gather them as a format 0.1 map
+        if (key == "GNU.sparse.offset" || key == "GNU.sparse.numbytes")
+            records["GNU.sparse.map"] += value + ",";
+        // an empty value removes a global record
+        else if (value.empty())
+            records.erase(key);
+        else
+            records[key] = value;
+
+        i += length;
+    }
+}
+
+void TarReader::applyPax(const PaxRecords& records, Entry& entry, bool& sparseMapInData) const
+{
+    for (auto& record : records)
+    {
+        const std::string& key = record.first;
+        const std::string& value = record.second;
+        QString text = QString::fromUtf8(value.c_str(), value.size());
+        bool ok = true;
+
+        if (key == "path")
+            entry.mName = text;
+        else if (key == "linkpath")
+            entry.mLinkName = text;
+        else if (key == "uname")
+            entry.mUserName = text;
+        else if (key == "gname")
+            entry.mGroupName = text;
+        else if (key == "size")
+            entry.mSize = TarReader::decimal(value, ok);
+        else if (key == "mtime")
+            entry.mModTime = TarReader::decimal(value, ok);
+        else if (key == "uid")
+            entry.mUserId = TarReader::decimal(value, ok);
+        else if (key == "gid")
+            entry.mGroupId = TarReader::decimal(value, ok);
+        else if (key == "GNU.sparse.size" || key == "GNU.sparse.realsize")
+        {
+            entry.mRealSize = TarReader::decimal(value, ok);
+            entry.mSparse = true;
+        }
+        else if (key == "GNU.sparse.major")
+        {
+            sparseMapInData = (value == "1");
+            entry.mSparse = true;
+        }
+        else if (key == "GNU.sparse.map")
+        {
+            entry.mSparse = true;
+            entry.mSparseMap.clear();
+
+            std::vector<uint64_t> numbers;
+            for (std::size_t begin = 0 ; begin < value.size() && ok ; )
+            {
+                std::size_t end = std::min(value.find(',', begin), value.size());
+                numbers.push_back(TarReader::decimal(value.substr(begin, end - begin), ok));
+                begin = end + 1;
+            }
+
+            if (numbers.size() % 2)
+                ok = false;
+            for (unsigned int i = 0 ; i + 1 < numbers.size() ; i += 2)
+                entry.mSparseMap.push_back(std::make_pair(numbers[i], numbers[i + 1]));
+        }
+
+        if (!ok)
+            Except::reportError(entry.mHeaderOffset, "tar pax header", "invalid value for " + key);
+    }
+
+    // the path of sparse files is a placeholder
+    PaxRecords::const_iterator found = records.find("GNU.sparse.name");
+    if (found != records.end())
+        entry.mName = QString::fromUtf8(found->second.c_str(), found->second.size());
+}
+
+
+// Old GNU format : 4 entries in the header, then blocks of 21 entries as long as the "extended" flag is set.
+unsigned int TarReader::readGnuSparse(unsigned int pos, Entry& entry) const
+{
+    const unsigned char* header = mChunk.data() + pos;
+    entry.mSparse = true;
+
+    bool ok;
+    entry.mRealSize = TarReader::number(header + 483, 12, ok);
+    if (!ok)
+        Except::reportError(pos + 483, "tar sparse header", "invalid real size");
+
+    this->readSparseEntries(pos + 386, 4, entry);
+
+    unsigned int blocks = 0;
+    for (bool extended = header[482] ; extended ; )
+    {
+        ++blocks;
+        unsigned int extension = pos + blocks * blockSize;
+        this->checkHeader(extension);
+
+        this->readSparseEntries(extension, 21, entry);
+        extended = mChunk[extension + 504];
+    }
+
+    return blocks;
+}
+
+void TarReader::readSparseEntries(unsigned int pos, unsigned int count, Entry& entry) const
+{
+    for (unsigned int i = 0 ; i < count ; ++i)
+    {
+        const unsigned char* field = mChunk.data() + pos + 24 * i;
+        if (!field[0])
+            break;
+
+        bool ok1;
+        bool ok2;
+        uint64_t offset = TarReader::number(field, 12, ok1);
+        uint64_t size = TarReader::number(field + 12, 12, ok2);
+        if (!ok1 || !ok2)
+            Except::reportError(pos + 24 * i, "tar sparse header", "invalid sparse entry");
+
+        entry.mSparseMap.push_back(std::make_pair(offset, size));
+    }
+}
+
+// Format 1.0 : the map is written in decimal at the start of the data, padded to a block.
+void TarReader::readSparseMap(Entry& entry) const
+{
+    uint64_t pos = 0;
+    uint64_t count = this->readSparseNumber(entry, pos);
+    if (count > entry.mSize / 4)
+        Except::reportError(entry.mDataOffset, "tar sparse map", "invalid number of entries");
+
+    entry.mSparseMap.clear();
+    for (uint64_t i = 0 ; i < count ; ++i)
+    {
+        uint64_t offset = this->readSparseNumber(entry, pos);
+        uint64_t size = this->readSparseNumber(entry, pos);
+        entry.mSparseMap.push_back(std::make_pair(offset, size));
+    }
+
+    uint64_t mapSize = (pos + blockSize - 1) / blockSize * blockSize;
+    if (mapSize > entry.mSize)
+        Except::reportError(entry.mDataOffset, "tar sparse map", "unexpected end of data");
+
+    entry.mDataOffset += mapSize;
+    entry.mSize -= mapSize;
+}
+
+uint64_t TarReader::readSparseNumber(const Entry& entry, uint64_t& pos) const
+{
+    const unsigned char* data = mChunk.data() + entry.mDataOffset;
+    uint64_t start = pos;
+    uint64_t result = 0;
+
+    for ( ; pos < entry.mSize && data[pos] != '\n' ; ++pos)
+    {
+        if (data[pos] < '0' || data[pos] > '9' || pos - start >= 20)
+            Except::reportError(entry.mDataOffset + pos, "tar sparse map", "invalid number");
+        result = 10 * result + (data[pos] - '0');
+    }
+
+    if (pos >= entry.mSize || pos == start)
+        Except::reportError(entry.mDataOffset + pos, "tar sparse map", "invalid number");
+    ++pos;
+
+    return result;
+}
+
+
+// Octal digits surrounded by spaces or NULs, or GNU base-256 when the high bit of the first byte is set.
+bool TarReader::matches(const MemChunk& chunk, const Entry& entry)
+{
+    if (chunk.size() < blockSize || entry.mHeaderOffset > chunk.size() - blockSize)
+        return false;
+
+    const unsigned char* header = chunk.data() + entry.mHeaderOffset;
+    if (!TarReader::validChecksum(header))
+        return false;
+
+    // the name of the member is elsewhere after long names and extended headers
+    char type = header[156];
+    if (type == 'L' || type == 'K' || type == 'x' || type == 'g')
+        return true;
+    bool ok;
+    uint64_t size = TarReader::number(header + 124, 12, ok);
+    return type == entry.mType && ok && size == entry.mSize && entry.mName.endsWith(TarReader::string(header, 100));
+}
+
+
+bool TarReader::validChecksum(const unsigned char* header)
+{
+    // the checksum field counts as spaces ; some old archives used signed chars
+    bool ok;
+    uint64_t checksum = TarReader::number(header + 148, 8, ok);
+    unsigned int sum = 0;
+    int signedSum = 0;
+    for (unsigned int i = 0 ; i < blockSize ; ++i)
+    {
+        unsigned char c = (i >= 148 && i < 156) ? ' ' : header[i];
+        sum += c;
+        signedSum += static_cast<signed char>(c);
+    }
+    return ok && (checksum == sum || checksum == static_cast<unsigned int>(signedSum));
+}
+
+uint64_t TarReader::number(const unsigned char* field, unsigned int length, bool& ok)
+{
+    ok = true;
+    uint64_t result = 0;
+
+    if (field[0] & 0x80)
+    {
+        // negative numbers are not meaningful here
+        if (field[0] & 0x40)
+        {
+            ok = false;
+            return 0;
+        }
+
+        result = field[0] & 0x3F;
+        for (unsigned int i = 1 ; i < length ; ++i)
+        {
+            if (result >> 56)
+                ok = false;
+            result = (result << 8) | field[i];
+        }
+        return result;
+    }
+
+    unsigned int i = 0;
+    for ( ; i < length && (field[i] == ' ' || field[i] == 0) ; ++i) ;
+
+    unsigned int digits = 0;
+    for ( ; i < length && field[i] >= '0' && field[i] <= '7' ; ++i, ++digits)
+        result = (result << 3) | (field[i] - '0');
+
+    for ( ; i < length ; ++i)
+        if (field[i] != ' ' && field[i] != 0)
+            ok = false;
+
+    if (digits > 21)
+        ok = false;
+    return result;
+}
+
+// Decimal, a fractional part (of PAX times) is ignored.
+uint64_t TarReader::decimal(const std::string& str, bool& ok)
+{
+    uint64_t result = 0;
+    std::size_t i = 0;
+
+    for ( ; i < str.size() && str[i] >= '0' && str[i] <= '9' ; ++i)
+    {
+        if (i >= 19)
+        {
+            ok = false;
+            return 0;
+        }
+        result = 10 * result + (str[i] - '0');
+    }
+
+    if (i == 0)
+        ok = false;
+    else if (i < str.size() && str[i] == '.')
+    {
+        for (++i ; i < str.size() && str[i] >= '0' && str[i] <= '9' ; ++i) ;
+    }
+
+    if (i != str.size())
+        ok = false;
+    return result;
+}
+
+QString TarReader::string(const unsigned char* field, unsigned int length)
+{
+    const char* begin = reinterpret_cast<const char*>(field);
+    const char* end = std::find(begin, begin + length, '\0');
+    return QString::fromUtf8(begin, end - begin);
+}
+
+}
+}
@@ -0,0 +1,122 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PARSE_TARREADER_HPP
+#define TYREX_PARSE_TARREADER_HPP
+
+#include "misc/memchunk.hpp"
+#include <QString>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tyrex {
+namespace parse {
+
+// Walks the members of a tar archive, one header at a time and only forwards.
+// Understands ustar prefixes, GNU long names ('L', 'K'), GNU base-256 numbers, PAX extended headers ('x', 'g')
+// and sparse files (old GNU 'S' headers and PAX formats 0.0, 0.1 and 1.0).
+// Errors are reported with Except::reportError.
+class TarReader
+{
+public:
+    class Entry
+    {
+    public:
+        Entry();
+
+        // first header of the member, including extension headers
+        unsigned int mHeaderOffset;
+        unsigned int mDataOffset;
+        // Sizes are decoded on 64 bits, but offsets and chunks are on 32 bits :
+        // members over 4 GiB (expanded, for sparse files) are reported as too large.
+        // bytes stored in the archive
+        uint64_t mSize;
+        // size of the file ; larger than mSize for sparse files
+        uint64_t mRealSize;
+
+        char mType;
+        QString mName;
+        QString mLinkName;
+        QString mUserName;
+        QString mGroupName;
+        unsigned int mMode;
+        unsigned int mUserId;
+        unsigned int mGroupId;
+        unsigned int mDevMajor;
+        unsigned int mDevMinor;
+        uint64_t mModTime;
+
+        // (offset in the file, size) of the segments stored back to back for sparse files
+        bool mSparse;
+        std::vector<std::pair<uint64_t, uint64_t> > mSparseMap;
+    };
+
+    TarReader(const MemChunk& chunk);
+    // replays the entries of a saved index (see TarIndex) instead of reading headers
+    TarReader(const MemChunk& chunk, const std::vector<Entry>& entries);
+
+    // whether a saved entry still matches the archive : a valid header at its offset,
+    // with the same type, size and name unless extension headers come first
+    static bool matches(const MemChunk& chunk, const Entry& entry);
+
+    // true after the end-of-archive marker, or when no header is left
+    bool atEnd() const;
+    inline unsigned int position() const;
+
+    void next(Entry& entry);
+    // data of the member, with holes of sparse files filled with zeros
+    MemChunk contents(const Entry& entry) const;
+
+private:
+    typedef std::map<std::string, std::string> PaxRecords;
+
+    void checkHeader(unsigned int pos) const;
+    void checkData(unsigned int pos, uint64_t size) const;
+    // position after data padded to a block
+    unsigned int skip(unsigned int pos, uint64_t size) const;
+
+    void readPax(unsigned int pos, uint64_t size, PaxRecords& records) const;
+    void applyPax(const PaxRecords& records, Entry& entry, bool& sparseMapInData) const;
+    unsigned int readGnuSparse(unsigned int pos, Entry& entry) const;
+    void readSparseEntries(unsigned int pos, unsigned int count, Entry& entry) const;
+    void readSparseMap(Entry& entry) const;
+    uint64_t readSparseNumber(const Entry& entry, uint64_t& pos) const;
+
+    static bool validChecksum(const unsigned char* header);
+    static uint64_t number(const unsigned char* field, unsigned int length, bool& ok);
+    static uint64_t decimal(const std::string& str, bool& ok);
+    static QString string(const unsigned char* field, unsigned int length);
+
+    MemChunk mChunk;
+    unsigned int mPos;
+    PaxRecords mGlobalRecords;
+
+    bool mReplaying;
+    std::vector<Entry> mReplay;
+    unsigned int mReplayed;
+};
+
+inline unsigned int TarReader::position() const
+    {return mPos;}
+
+}
+}
+
+#endif // TYREX_PARSE_TARREADER_HPP
@@ -23,9 +23,14 @@
 namespace tyrex {
 namespace parse {
 
+Zip::Zip() :
+    mIndex(data::ArchiveIndex::dosTime)
+{
+}
+
 void Zip::onError(const MemChunk& chunk, std::shared_ptr<data::Archive>& data)
 {
-    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mZipFilter, mExtractedFiles);
+    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mZipFilter, mIndex, mExtractedFiles);
 }
 
 void Zip::doParse(const MemChunk& chunk, std::shared_ptr<data::Archive>& data)
@@ -64,9 +69,10 @@ void Zip::doParse(const MemChunk& chunk, std::shared_ptr<data::Archive>& data)
             Except::reportWarning(i, "zip file extraction", "end of central directory");
 
         MemChunk centralDir = chunk.subChunk(centralDirStart + processed, centralDirSize - processed);
-        ZipFile zipFile(mSrcColorizer, centralDir, centralDirStart + processed, centralDirSize - processed);
+        ZipFile zipFile(mSrcColorizer, mIndex, centralDir, centralDirStart + processed, centralDirSize - processed);
 
         data::File file;
+        file.mRow = mIndex.appendRow();
         if (!zipFile.parse(chunk, file))
             Except::reportWarning(i, "zip file extraction", "error decoding file");
 
@@ -74,7 +80,7 @@ void Zip::doParse(const MemChunk& chunk, std::shared_ptr<data::Archive>& data)
         mExtractedFiles.push_back(file);
     }
 
-    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mZipFilter, mExtractedFiles);
+    data = std::make_shared<data::Archive>(chunk, mSrcColorizer, data::FileInfoFilter::mZipFilter, mIndex, mExtractedFiles);
 }
 
 unsigned int Zip::findCentralDirectory(const MemChunk& chunk)
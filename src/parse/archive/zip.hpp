@@ -28,7 +28,7 @@ namespace parse {
 class Zip : public DataParser<data::Archive>
 {
 public:
-    Zip() = default;
+    Zip();
 
 private:
     void doParse(const MemChunk& chunk, std::shared_ptr<data::Archive>& data);
@@ -37,6 +37,7 @@ private:
     unsigned int findCentralDirectory(const MemChunk& chunk);
 
     data::Colorizer mSrcColorizer;
+    data::ArchiveIndex mIndex;
     std::vector<data::File> mExtractedFiles;
 };
 
@@ -21,13 +21,12 @@
 #include "parse/compress/deflate/deflate.hpp"
 #include "misc/util.hpp"
 
-#include <QDateTime>
-
 namespace tyrex {
 namespace parse {
 
-ZipFile::ZipFile(data::Colorizer& srcColorizer, const MemChunk& centralDir, unsigned int centralDirStart, unsigned int centralDirSize) :
+ZipFile::ZipFile(data::Colorizer& srcColorizer, data::ArchiveIndex& index, const MemChunk& centralDir, unsigned int centralDirStart, unsigned int centralDirSize) :
     mSrcColorizer(srcColorizer),
+    mIndex(index),
     mCentralDir(centralDir),
     mCentralDirStart(centralDirStart),
     mCentralDirSize(centralDirSize),
@@ -158,20 +157,21 @@ void ZipFile::doParse(const MemChunk& chunk, data::File& file)
     mSrcColorizer.addHighlight(localHeaderOffset + extraLength, compressedSize, QColor(128, 128, 255, 64));
 
 
-    data::FileInfo fileInfo;
-    fileInfo.mInfos[data::FileInfo::fileName] = Util::chunkToUtf8(chunk.subChunk(localHeaderOffset, fileNameLength));
-    QDateTime dateTime = QDateTime(QDate(1980 + (modDate >> 9), (modDate >> 5) & 0xF, modDate & 0x1F), QTime(modTime >> 11, (modTime >> 5) & 0x3F, (modTime & 0x1F) << 1));
-    fileInfo.mInfos[data::FileInfo::modDateTime] = dateTime.toString("dd MMM yyyy  hh:mm:ss");
-    fileInfo.mInfos[data::FileInfo::size] = QString::number(uncompressedSize);
-    fileInfo.mInfos[data::FileInfo::compressedSize] = QString::number(compressedSize);
-    fileInfo.mInfos[data::FileInfo::crc32] = QString::fromStdString(Util::hexToString(crc32, 8));
+    unsigned int row = file.mRow;
+    mIndex.setString(row, data::FileInfo::fileName, Util::chunkToUtf8(chunk.subChunk(localHeaderOffset, fileNameLength)));
+    mIndex.setNumber(row, data::FileInfo::modDateTime, (modDate << 16) | modTime);
+    mIndex.setNumber(row, data::FileInfo::size, uncompressedSize);
+    mIndex.setNumber(row, data::FileInfo::compressedSize, compressedSize);
+    mIndex.setNumber(row, data::FileInfo::crc32, crc32);
+    mIndex.setNumber(row, data::FileInfo::compressionMethod, compressionMethod);
+    mIndex.setNumber(row, data::FileInfo::offset, localHeaderOffset - 30);
 
-    fileInfo.mInfos[data::FileInfo::fileComment] = Util::chunkToUtf8(chunk.subChunk(localHeaderOffset + fileNameLength + extraFieldLength, fileCommentLength));
-    fileInfo.mInfos[data::FileInfo::diskNumber] = QString::number(diskNumber);
-    fileInfo.mInfos[data::FileInfo::versionMadeBy] = QString::number(versionMadeBy);
-    fileInfo.mInfos[data::FileInfo::versionNeeded] = QString::number(versionNeeded);
-    fileInfo.mInfos[data::FileInfo::internalAttributes] = QString::number(internalAttributes);
-    fileInfo.mInfos[data::FileInfo::externalAttributes] = QString::number(externalAttributes);
+    mIndex.setString(row, data::FileInfo::fileComment, Util::chunkToUtf8(chunk.subChunk(localHeaderOffset + fileNameLength + extraFieldLength, fileCommentLength)));
+    mIndex.setNumber(row, data::FileInfo::diskNumber, diskNumber);
+    mIndex.setNumber(row, data::FileInfo::versionMadeBy, versionMadeBy);
+    mIndex.setNumber(row, data::FileInfo::versionNeeded, versionNeeded);
+    mIndex.setNumber(row, data::FileInfo::internalAttributes, internalAttributes);
+    mIndex.setNumber(row, data::FileInfo::externalAttributes, externalAttributes);
 
     localHeaderOffset += extraLength;
     if (!Util::checkRange(localHeaderOffset, compressedSize, size))
@@ -181,11 +181,9 @@ void ZipFile::doParse(const MemChunk& chunk, data::File& file)
     switch (compressionMethod)
     {
     case 0:
-        fileInfo.mInfos[data::FileInfo::compressionMethod] = "Uncompressed";
         file.mChunk = compressedChunk;
         break;
     case 8:
-        fileInfo.mInfos[data::FileInfo::compressionMethod] = "Deflate";
         {
             Deflate deflate(0x8000);
             std::shared_ptr<data::Compress> deflateData;
@@ -196,12 +194,9 @@ void ZipFile::doParse(const MemChunk& chunk, data::File& file)
         }
         break;
     default:
-        fileInfo.mInfos[data::FileInfo::compressionMethod] = "Unsupported";
         file.mChunk = compressedChunk;
         Except::reportWarning(size, "zip file", "unsupported compression method");
     }
-
-    file.mInfo = fileInfo;
 }
 
 }
@@ -20,6 +20,7 @@
 #define TYREX_PARSE_ZIPFILE_HPP
 
 #include "parse/parser.tpl"
+#include "data/archiveindex.hpp"
 #include "data/file.hpp"
 #include "data/colorizer.hpp"
 
@@ -29,7 +30,7 @@ namespace parse {
 class ZipFile : public MemchunkParser<data::File>
 {
 public:
-    ZipFile(data::Colorizer& srcColorizer, const MemChunk& centralDir, unsigned int centralDirStart, unsigned int centralDirSize);
+    ZipFile(data::Colorizer& srcColorizer, data::ArchiveIndex& index, const MemChunk& centralDir, unsigned int centralDirStart, unsigned int centralDirSize);
 
     inline unsigned int processed() const;
 
@@ -37,6 +38,7 @@ private:
     void doParse(const MemChunk& chunk, data::File& file);
 
     data::Colorizer& mSrcColorizer;
+    data::ArchiveIndex& mIndex;
     MemChunk mCentralDir;
     unsigned int mCentralDirStart;
     unsigned int mCentralDirSize;
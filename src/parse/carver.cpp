@@ -0,0 +1,248 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "carver.hpp"
+
+#include "misc/hash/hash.hpp"
+#include "misc/profiler.hpp"
+#include "misc/util.hpp"
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <map>
+
+namespace tyrex {
+namespace parse {
+
+// below this size per thread, starting threads costs more than it saves
+static const unsigned int minSegmentSize = 64 << 20;
+
+
+Carver::Carver() :
+    mMaxLength(0)
+{
+}
+
+
+void Carver::onError(const MemChunk& chunk, std::shared_ptr<data::Carving>& data)
+{
+    data = std::make_shared<data::Carving>(chunk, mSrcColorizer, std::vector<data::Carving::Found>());
+}
+
+void Carver::doParse(const MemChunk& chunk, std::shared_ptr<data::Carving>& data)
+{
+    for (unsigned int i = 0 ; i < Document::formatCount() ; ++i)
+    {
+        const Document::Format& format = Document::format(i);
+        if (!format.mMagicSize)
+            continue;
+
+        mMatcher.addPattern(std::vector<unsigned char>(format.mMagic, format.mMagic + format.mMagicSize));
+        mFormats.push_back(&format);
+        mValidators.push_back(Carver::validator(format.mName));
+        mMaxLength = std::max(mMaxLength, format.mMagicSize);
+    }
+    mMatcher.build();
+
+    unsigned int size = chunk.size();
+    unsigned int segments = std::max(1, std::min<int>(QThread::idealThreadCount(), size / minSegmentSize));
+    unsigned int segmentSize = (size + segments - 1) / segments;
+
+    std::vector<std::vector<data::Carving::Found> > segmentFound(segments);
+    if (segments == 1)
+        this->scan(chunk, 0, size, segmentFound[0]);
+    else
+    {
+        QThreadPool pool;
+        for (unsigned int i = 0 ; i < segments ; ++i)
+        {
+            unsigned int start = i * segmentSize;
+            pool.start(new ScanTask(*this, chunk, start, std::min(segmentSize, size - start), segmentFound[i]));
+        }
+        pool.waitForDone();
+    }
+
+    // segments are in order, but several patterns may end in any order within a segment
+    std::vector<data::Carving::Found> found;
+    for (auto& files : segmentFound)
+    {
+        std::stable_sort(files.begin(), files.end(), [](const data::Carving::Found& a, const data::Carving::Found& b) {return a.mOffset < b.mOffset;});
+        found.insert(found.end(), files.begin(), files.end());
+    }
+
+    unsigned int end = 0;
+    for (const data::Carving::Found& file : found)
+    {
+        unsigned int length = 0;
+        for (const Document::Format* format : mFormats)
+            if (file.mType == format->mName && !chunk.uncompare(format->mMagic, format->mMagicSize, file.mOffset))
+                length = std::max(length, format->mMagicSize);
+
+        if (file.mOffset >= end)
+        {
+            mSrcColorizer.addHighlight(file.mOffset, length, QColor(255, 128, 0, 64));
+            end = file.mOffset + length;
+        }
+        mSrcColorizer.addSeparation(file.mOffset, 2);
+    }
+
+    data = std::make_shared<data::Carving>(chunk, mSrcColorizer, found);
+}
+
+
+void Carver::scan(const MemChunk& chunk, unsigned int start, unsigned int size, std::vector<data::Carving::Found>& found) const
+{
+    Profiler::Scope scope("carving scan");
+
+    // a signature starting in the segment may end in the next one
+    unsigned int overlap = std::min(mMaxLength - 1, chunk.size() - start - size);
+    MemChunk segment = chunk.subChunk(start, size + overlap);
+
+    mMatcher.find(segment, [&](unsigned int offset, unsigned int pattern) {
+        if (offset >= size)
+            return;
+        if (mValidators[pattern] && !mValidators[pattern](chunk, start + offset))
+            return;
+        found.push_back({start + offset, mFormats[pattern]->mName});
+    });
+}
+
+
+Carver::ScanTask::ScanTask(const Carver& carver, const MemChunk& chunk, unsigned int start, unsigned int size, std::vector<data::Carving::Found>& found) :
+    mCarver(carver),
+    mChunk(chunk),
+    mStart(start),
+    mSize(size),
+    mFound(found)
+{
+}
+
+void Carver::ScanTask::run()
+{
+    mCarver.scan(mChunk, mStart, mSize, mFound);
+}
+
+
+Carver::Validator Carver::validator(const QString& type)
+{
+    static const std::map<QString, Validator> validators {
+        {"archive/zip", &Carver::checkZip},
+        {"compress/bzip2", &Carver::checkBzip2},
+        {"compress/gzip", &Carver::checkGzip},
+        {"compress/xz", &Carver::checkXz},
+        {"font/truetype", &Carver::checkTruetype},
+        {"image/png", &Carver::checkPng},
+        {"program/elf32", &Carver::checkElf},
+        {"program/elf64", &Carver::checkElf},
+        {"program/java", &Carver::checkJava}
+    };
+
+    auto it = validators.find(type);
+    return it == validators.end() ? nullptr : it->second;
+}
+
+bool Carver::checkGzip(const MemChunk& chunk, unsigned int offset)
+{
+    // deflate method, no reserved flag
+    return Util::checkRange(offset, 10, chunk.size())
+        && chunk[offset + 2] == 8
+        && !(chunk[offset + 3] >> 5);
+}
+
+bool Carver::checkBzip2(const MemChunk& chunk, unsigned int offset)
+{
+    static const std::vector<unsigned char> blockMagic {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+    static const std::vector<unsigned char> endMagic {0x17, 0x72, 0x45, 0x38, 0x50, 0x90};
+
+    // block size, then a block or the end of stream
+    if (!Util::checkRange(offset, 10, chunk.size()))
+        return false;
+    unsigned char level = chunk[offset + 3];
+    return level >= '1' && level <= '9'
+        && (!chunk.uncompare(blockMagic, offset + 4) || !chunk.uncompare(endMagic, offset + 4));
+}
+
+bool Carver::checkPng(const MemChunk& chunk, unsigned int offset)
+{
+    // the first chunk is IHDR
+    return Util::checkRange(offset, 16, chunk.size())
+        && chunk.getUint32BE(offset + 8) == 13
+        && !chunk.uncompare("IHDR", offset + 12);
+}
+
+bool Carver::checkElf(const MemChunk& chunk, unsigned int offset)
+{
+    // endianness, version, and a known object type
+    if (!Util::checkRange(offset, 18, chunk.size()))
+        return false;
+    unsigned char endianness = chunk[offset + 5];
+    if ((endianness != 1 && endianness != 2) || chunk[offset + 6] != 1)
+        return false;
+    unsigned int type = endianness == 1 ? chunk.getUint16LE(offset + 16) : chunk.getUint16BE(offset + 16);
+    return type >= 1 && type <= 4;
+}
+
+bool Carver::checkJava(const MemChunk& chunk, unsigned int offset)
+{
+    // major version, from JDK 1.1 ; Mach-O universal binaries share the magic, with a small count of architectures instead
+    if (!Util::checkRange(offset, 8, chunk.size()))
+        return false;
+    unsigned int major = chunk.getUint16BE(offset + 6);
+    return major >= 45 && major <= 100;
+}
+
+bool Carver::checkTruetype(const MemChunk& chunk, unsigned int offset)
+{
+    // table count, and the search range derived from it
+    if (!Util::checkRange(offset, 12, chunk.size()))
+        return false;
+    unsigned int numTables = chunk.getUint16BE(offset + 4);
+    if (numTables < 1 || numTables > 64)
+        return false;
+
+    unsigned int searchRange = 16;
+    while (searchRange * 2 <= numTables * 16)
+        searchRange *= 2;
+    return chunk.getUint16BE(offset + 6) == searchRange;
+}
+
+bool Carver::checkZip(const MemChunk& chunk, unsigned int offset)
+{
+    static const std::vector<unsigned int> methods {0, 1, 6, 8, 9, 12, 14, 93, 95, 98};
+
+    // version needed, a known method, a file name
+    if (!Util::checkRange(offset, 30, chunk.size()))
+        return false;
+    unsigned int nameLength = chunk.getUint16LE(offset + 26);
+    return chunk.getUint16LE(offset + 4) < 100
+        && std::find(methods.begin(), methods.end(), chunk.getUint16LE(offset + 8)) != methods.end()
+        && nameLength >= 1 && nameLength <= 4096;
+}
+
+bool Carver::checkXz(const MemChunk& chunk, unsigned int offset)
+{
+    // stream flags, with their CRC32
+    if (!Util::checkRange(offset, 12, chunk.size()))
+        return false;
+    if (chunk[offset + 6] || (chunk[offset + 7] & 0xF0))
+        return false;
+    return Hasher::getCRC32(chunk.subChunk(offset + 6, 2)) == chunk.getUint32LE(offset + 8);
+}
+
+}
+}
@@ -0,0 +1,84 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PARSE_CARVER_HPP
+#define TYREX_PARSE_CARVER_HPP
+
+#include "parser.hpp"
+#include "data/carving.hpp"
+#include "misc/multimatcher.hpp"
+#include "parsedocument.hpp"
+#include <QRunnable>
+
+namespace tyrex {
+namespace parse {
+
+// Looks for the signatures of all known types at every offset of a chunk.
+// Candidates are validated against a few fields of their header, since most signatures are short.
+// Large chunks are split into segments scanned in parallel.
+class Carver : public DataParser<data::Carving>
+{
+public:
+    Carver();
+
+private:
+    typedef bool (*Validator)(const MemChunk& chunk, unsigned int offset);
+
+    class ScanTask : public QRunnable
+    {
+    public:
+        ScanTask(const Carver& carver, const MemChunk& chunk, unsigned int start, unsigned int size, std::vector<data::Carving::Found>& found);
+
+        void run();
+
+    private:
+        const Carver& mCarver;
+        MemChunk mChunk;
+        unsigned int mStart;
+        unsigned int mSize;
+        std::vector<data::Carving::Found>& mFound;
+    };
+
+    void doParse(const MemChunk& chunk, std::shared_ptr<data::Carving>& data);
+    void onError(const MemChunk& chunk, std::shared_ptr<data::Carving>& data);
+
+    // finds the files starting in [start, start + size)
+    void scan(const MemChunk& chunk, unsigned int start, unsigned int size, std::vector<data::Carving::Found>& found) const;
+
+    static Validator validator(const QString& type);
+    static bool checkGzip(const MemChunk& chunk, unsigned int offset);
+    static bool checkBzip2(const MemChunk& chunk, unsigned int offset);
+    static bool checkPng(const MemChunk& chunk, unsigned int offset);
+    static bool checkElf(const MemChunk& chunk, unsigned int offset);
+    static bool checkJava(const MemChunk& chunk, unsigned int offset);
+    static bool checkTruetype(const MemChunk& chunk, unsigned int offset);
+    static bool checkZip(const MemChunk& chunk, unsigned int offset);
+    static bool checkXz(const MemChunk& chunk, unsigned int offset);
+
+    MultiMatcher mMatcher;
+    std::vector<const Document::Format*> mFormats;
+    std::vector<Validator> mValidators;
+    unsigned int mMaxLength;
+
+    data::Colorizer mSrcColorizer;
+};
+
+}
+}
+
+#endif // TYREX_PARSE_CARVER_HPP
@@ -40,7 +40,18 @@ void Deflate::onError(const MemChunk& chunk, std::shared_ptr<data::Compress>& da
 void Deflate::doParse(const MemChunk& chunk, std::shared_ptr<data::Compress>& data)
 {
     mChunk = chunk;
-    DeflateStream stream(mChunk);
+    this->inflate(mChunk);
+
+    mSrcColorizer.addHighlight(0, mEnd, QColor(128, 128, 255, 64));
+    mSrcColorizer.addSeparation(mEnd, 2);
+
+    data = std::make_shared<data::Compress>(mChunk, mDecompChunk, mSrcColorizer, mDecompColorizer);
+}
+
+void Deflate::inflate(const MemRope& input)
+{
+    mInput = input;
+    DeflateStream stream(mInput);
 
     unsigned int bfinal = 0;
     while (!bfinal)
@@ -68,11 +79,7 @@ void Deflate::doParse(const MemChunk& chunk, std::shared_ptr<data::Compress>& da
 
     stream.flushByte();
     mEnd = stream.pos();
-
-    mSrcColorizer.addHighlight(0, mEnd, QColor(128, 128, 255, 64));
-    mSrcColorizer.addSeparation(mEnd, 2);
-
-    data = std::make_shared<data::Compress>(mChunk, mDecompChunk, mSrcColorizer, mDecompColorizer);
+    this->flushSink();
 }
 
 
@@ -80,20 +87,20 @@ void Deflate::parseUncompressed(DeflateStream& stream)
 {
     stream.flushByte();
     unsigned int pos = stream.pos();
-    if (!Util::checkRange(pos, 4, mChunk.size()))
-        Except::reportError(mChunk.size(), "deflate, uncompressed bloc, size", "unexpected end of data");
+    if (!Util::checkRange(pos, 4, mInput.size()))
+        Except::reportError(mInput.size(), "deflate, uncompressed bloc, size", "unexpected end of data");
 
-    unsigned int len = mChunk[pos] + (mChunk[pos + 1] << 8);
-    unsigned int nlen = mChunk[pos + 2] + (mChunk[pos + 3] << 8);
+    unsigned int len = mInput[pos] + (mInput[pos + 1] << 8);
+    unsigned int nlen = mInput[pos + 2] + (mInput[pos + 3] << 8);
 
     if ((len ^ nlen) != 0xFFFF)
         Except::reportError(pos, "deflate, uncompressed bloc, size", "invalid size check");
     pos += 4;
 
-    if (!Util::checkRange(pos, len, mChunk.size()))
-        Except::reportError(mChunk.size(), "deflate, uncompressed bloc", "unexpected end of data");
+    if (!Util::checkRange(pos, len, mInput.size()))
+        Except::reportError(mInput.size(), "deflate, uncompressed bloc", "unexpected end of data");
 
-    this->appendUncompressed(mChunk.subChunk(pos, len));
+    this->appendUncompressed(mInput.subRope(pos, len));
     pos += len;
     stream.skipBytes(len + 4);
 }
@@ -137,7 +144,7 @@ void Deflate::parseDynamicHuffman(DeflateStream& stream)
     bool ok = true;
     HuffmanTree lenTree(lens, ok);
     if (!ok)
-        Except::reportError(mChunk.size(), "deflate, dynamic huffman tree", "invalid lengths tree", std::make_shared<data::DataTree>("Length tree", lenTree.toTree()));
+        Except::reportError(mInput.size(), "deflate, dynamic huffman tree", "invalid lengths tree", std::make_shared<data::DataTree>("Length tree", lenTree.toTree()));
 
     std::vector<unsigned int> lensLitDist(hlit + hdist, 0);
     this->getLensCompressed(lensLitDist, hlit + hdist, stream, lenTree);
@@ -147,14 +154,14 @@ void Deflate::parseDynamicHuffman(DeflateStream& stream)
         lensLit[i] = lensLitDist[i];
     HuffmanTree litTree(lensLit, ok);
     if (!ok)
-        Except::reportError(mChunk.size(), "deflate, dynamic huffman tree", "invalid literal tree", std::make_shared<data::DataTree>("Literal tree", litTree.toTree()));
+        Except::reportError(mInput.size(), "deflate, dynamic huffman tree", "invalid literal tree", std::make_shared<data::DataTree>("Literal tree", litTree.toTree()));
 
     std::vector<unsigned int> lensDist(hdist, 0);
     for (unsigned int i = 0 ; i < hdist ; ++i)
         lensDist[i] = lensLitDist[hlit + i];
     HuffmanTree distTree(lensDist, ok);
     if (!ok)
-        Except::reportError(mChunk.size(), "deflate, dynamic huffman tree", "invalid distance tree", std::make_shared<data::DataTree>("Distance tree", distTree.toTree()));
+        Except::reportError(mInput.size(), "deflate, dynamic huffman tree", "invalid distance tree", std::make_shared<data::DataTree>("Distance tree", distTree.toTree()));
 
     this->startHighlight();
     this->parseBlock(stream, litTree, distTree);
@@ -30,8 +30,12 @@ class HuffmanTree;
 class Deflate : public Lz
 {
 public:
+    using Lz::setSink;
+
     Deflate(unsigned int windowSize);
 
+    // Decompresses input without building the data of the parser (errors are thrown), usually into a sink.
+    void inflate(const MemRope& input);
     inline unsigned int end() const;
 
 private:
@@ -48,6 +52,7 @@ private:
     void getLensCompressed(std::vector<unsigned int>& lens, unsigned int count, DeflateStream& stream, const HuffmanTree& lenTree);
 
     MemChunk mChunk;
+    MemRope mInput;
     data::Colorizer mSrcColorizer;
     unsigned int mEnd;
 };
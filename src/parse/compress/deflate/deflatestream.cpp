@@ -23,8 +23,12 @@
 namespace tyrex {
 namespace parse {
 
-DeflateStream::DeflateStream(const MemChunk& chunk) :
-    mChunk(chunk),
+DeflateStream::DeflateStream(const MemRope& rope) :
+    mRope(rope),
+    mExtent(0),
+    mExtentData(nullptr),
+    mExtentStart(0),
+    mExtentEnd(0),
     mPos(0),
     mOffset(0)
 {
@@ -50,9 +54,9 @@ unsigned int DeflateStream::get()
 {
     if (mOffset == 0)
     {
-        if (mPos >= mChunk.size())
-            Except::reportError(mChunk.size(), "deflate stream", "unexpected end of data");
-        mBuffer = mChunk[mPos];
+        if (mPos >= mExtentEnd)
+            this->nextExtent();
+        mBuffer = mExtentData[mPos - mExtentStart];
     }
 
     unsigned int result = (mBuffer >> mOffset) & 0x01;
@@ -74,5 +78,22 @@ unsigned int DeflateStream::get(unsigned int count)
     return result;
 }
 
+
+// Positions only move forward, possibly over several extents when skipping bytes.
+void DeflateStream::nextExtent()
+{
+    if (mPos >= mRope.size())
+        Except::reportError(mRope.size(), "deflate stream", "unexpected end of data");
+
+    if (mExtentData)
+        ++mExtent;
+    while (mPos >= mRope.extentOffset(mExtent) + mRope.extent(mExtent).size())
+        ++mExtent;
+
+    mExtentData = mRope.extent(mExtent).data();
+    mExtentStart = mRope.extentOffset(mExtent);
+    mExtentEnd = mExtentStart + mRope.extent(mExtent).size();
+}
+
 }
 }
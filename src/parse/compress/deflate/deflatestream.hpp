@@ -19,16 +19,17 @@
 #ifndef TYREX_PARSE_DEFLATESTREAM_HPP
 #define TYREX_PARSE_DEFLATESTREAM_HPP
 
-#include "misc/memchunk.hpp"
+#include "misc/memrope.hpp"
 #include "parse/compress/bitstream.hpp"
 
 namespace tyrex {
 namespace parse {
 
+// Reads the bits of a deflate stream, possibly split across several chunks (e.g. png IDAT chunks).
 class DeflateStream : public BitStream
 {
 public:
-    DeflateStream(const MemChunk& chunk);
+    DeflateStream(const MemRope& rope);
 
     void flushByte();
     void skipBytes(unsigned int count);
@@ -38,7 +39,15 @@ public:
     inline unsigned int pos() const;
 
 private:
-    MemChunk mChunk;
+    void nextExtent();
+
+    MemRope mRope;
+    // current extent, covering [mExtentStart, mExtentEnd) of the rope
+    unsigned int mExtent;
+    const unsigned char* mExtentData;
+    unsigned int mExtentStart;
+    unsigned int mExtentEnd;
+
     unsigned int mBuffer;
     unsigned int mPos;
     unsigned int mOffset;
@@ -37,26 +37,11 @@ void Zlib::doParse(const MemChunk& chunk, std::shared_ptr<data::Compress>& data)
     if (size < 2)
         Except::reportError(size, "zlib header", "unexpected end of data");
 
-    unsigned int header = chunk.getUint16BE(0);
-    if (header % 31 != 0)
-        Except::reportError(0, "zlib header", "invalid header check");
+    unsigned int windowSize = Zlib::checkHeader(chunk.getUint16BE(0));
 
     mSrcColorizer.addHighlight(0, 2, QColor(255, 128, 0, 64));
     mSrcColorizer.addSeparation(2, 2);
 
-    unsigned int method = (header >> 8) & 0x0F;
-    unsigned int info = (header >> 12) & 0x0F;
-    unsigned int fdict = (header >> 5) & 0x01;
-    unsigned int flags = (header >> 6) & 0x03;
-
-    if (method != 8)
-        Except::reportError(0, "zlib header, method", "invalid method");
-    if (info > 7)
-        Except::reportError(0, "zlib header, window size", "invalid window size");
-    if (fdict)
-        Except::reportError(1, "zlib header, preset dictionary", "preset dictionaries are not supported");
-
-    unsigned int windowSize = 1 << (info + 8);
     Deflate deflate(windowSize);
     std::shared_ptr<data::Compress> deflateData;
 
@@ -85,5 +70,61 @@ void Zlib::doParse(const MemChunk& chunk, std::shared_ptr<data::Compress>& data)
     data = std::make_shared<data::Compress>(chunk, mDecompChunk, mSrcColorizer, mDecompColorizer);
 }
 
+
+void Zlib::inflate(const MemRope& input, Lz::Sink& sink)
+{
+    uint64_t size = input.size();
+
+    // check initial size
+    if (size < 2)
+        Except::reportError(size, "zlib header", "unexpected end of data");
+
+    Checksum checksum(sink);
+    Deflate deflate(Zlib::checkHeader((input[0] << 8) | input[1]));
+    deflate.setSink(&checksum);
+    deflate.inflate(input.subRope(2, size - 2));
+
+    unsigned int processed = 2 + deflate.end();
+    if (!Util::checkRange(processed, 4, size))
+        Except::reportError(size, "zlib adler32", "unexpected end of data");
+
+    unsigned char adler[4];
+    input.read(processed, adler, 4);
+    if (checksum.adler() != ((unsigned int)adler[0] << 24 | adler[1] << 16 | adler[2] << 8 | adler[3]))
+        Except::reportError(processed, "zlib adler32", "invalid adler32");
+
+    processed += 4;
+    if (size != processed)
+        Except::reportError(processed, "zlib", "expected end of data");
+}
+
+
+// Returns the window size.
+unsigned int Zlib::checkHeader(unsigned int header)
+{
+    if (header % 31 != 0)
+        Except::reportError(0, "zlib header", "invalid header check");
+
+    unsigned int method = (header >> 8) & 0x0F;
+    unsigned int info = (header >> 12) & 0x0F;
+    unsigned int fdict = (header >> 5) & 0x01;
+
+    if (method != 8)
+        Except::reportError(0, "zlib header, method", "invalid method");
+    if (info > 7)
+        Except::reportError(0, "zlib header, window size", "invalid window size");
+    if (fdict)
+        Except::reportError(1, "zlib header, preset dictionary", "preset dictionaries are not supported");
+
+    return 1 << (info + 8);
+}
+
+
+void Zlib::Checksum::write(const unsigned char* data, unsigned int size)
+{
+    mAdler = Hasher::updateAdler32(mAdler, data, size);
+    mSink.write(data, size);
+}
+
 }
 }
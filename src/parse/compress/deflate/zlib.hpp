@@ -19,7 +19,7 @@
 #ifndef TYREX_PARSE_ZLIB_HPP
 #define TYREX_PARSE_ZLIB_HPP
 
-#include "parse/compress/parsecompress.hpp"
+#include "parse/compress/lz.hpp"
 
 namespace tyrex {
 namespace parse {
@@ -29,13 +29,38 @@ class Zlib : public Compress
 public:
     Zlib() = default;
 
+    // Streams the decompressed data of input to sink, checking it on the way ; errors are reported as exceptions.
+    // Nothing is kept : this is for callers which consume the data themselves (e.g. png).
+    static void inflate(const MemRope& input, Lz::Sink& sink);
+
 private:
+    // Forwards the data to another sink, computing its Adler32.
+    class Checksum : public Lz::Sink
+    {
+    public:
+        inline Checksum(Lz::Sink& sink);
+
+        void write(const unsigned char* data, unsigned int size);
+        inline unsigned int adler() const;
+
+    private:
+        Lz::Sink& mSink;
+        unsigned int mAdler;
+    };
+
     void doParse(const MemChunk& chunk, std::shared_ptr<data::Compress>& data);
     void onError(const MemChunk& chunk, std::shared_ptr<data::Compress>& data);
 
+    static unsigned int checkHeader(unsigned int header);
+
     data::Colorizer mSrcColorizer;
 };
 
+inline Zlib::Checksum::Checksum(Lz::Sink& sink) :
+    mSink(sink), mAdler(1) {}
+inline unsigned int Zlib::Checksum::adler() const
+    {return mAdler;}
+
 }
 }
 
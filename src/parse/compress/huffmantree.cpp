@@ -18,6 +18,7 @@
 
 #include "huffmantree.hpp"
 
+#include "misc/arena.hpp"
 #include "misc/tree.tpl"
 
 namespace tyrex {
@@ -89,7 +90,7 @@ Tree<void> HuffmanTree::toTree() const
 {
     Tree<void> result = Tree<void>(QString());
 
-    std::shared_ptr<Tree<void> > root = std::make_shared<Tree<void> >(QString());
+    std::shared_ptr<Tree<void> > root = std::allocate_shared<Tree<void> >(ArenaAllocator<Tree<void> >(), QString());
     this->toTree(*root, 0, QString());
     result.appendTree(root);
 
@@ -102,14 +103,14 @@ bool HuffmanTree::toTree(Tree<void>& tree, unsigned int pos, QString sequence) c
     {
         bool result = false;
 
-        std::shared_ptr<Tree<void> > left = std::make_shared<Tree<void> >(QString());
+        std::shared_ptr<Tree<void> > left = std::allocate_shared<Tree<void> >(ArenaAllocator<Tree<void> >(), QString());
         if (this->toTree(*left, 2 * pos + 1, sequence + "0"))
         {
             tree.appendTree(left);
             result = true;
         }
 
-        std::shared_ptr<Tree<void> > right = std::make_shared<Tree<void> >(QString());
+        std::shared_ptr<Tree<void> > right = std::allocate_shared<Tree<void> >(ArenaAllocator<Tree<void> >(), QString());
         if (this->toTree(*right, 2 * pos + 2, sequence + "1"))
         {
             tree.appendTree(right);
@@ -21,15 +21,63 @@
 namespace tyrex {
 namespace parse {
 
+Lz::Sink::~Sink()
+{
+}
+
+
+// Bytes written to a sink at once ; the window is copied to a new buffer each time.
+static const unsigned int sinkBlockSize = 1 << 20;
+
 Lz::Lz(unsigned int windowSize) :
     mWindowSize(windowSize),
-    mStartHighlight(0)
+    mStartHighlight(0),
+    mSink(nullptr),
+    mFlushed(0)
+{
+}
+
+
+void Lz::setSink(Sink* sink)
 {
+    mSink = sink;
+}
+
+void Lz::flushSink()
+{
+    if (!mSink || !mDecompChunk.size())
+        return;
+
+    mSink->write(mDecompChunk.data(), mDecompChunk.size());
+    mFlushed += mDecompChunk.size();
+    mDecompChunk.clear();
+}
+
+// Once a block is available besides the window, hands it to the sink.
+void Lz::checkSink()
+{
+    if (mSink && mDecompChunk.size() > mWindowSize && mDecompChunk.size() - mWindowSize >= sinkBlockSize)
+        this->writeSink(mDecompChunk.size() - mWindowSize);
+}
+
+// Writes the first bytes of mDecompChunk to the sink, keeping the rest.
+void Lz::writeSink(unsigned int size)
+{
+    mSink->write(mDecompChunk.data(), size);
+    mFlushed += size;
+
+    MemChunk window;
+    window.reserve(mDecompChunk.size() - size + sinkBlockSize);
+    window.append(mDecompChunk.data() + size, mDecompChunk.size() - size);
+    mDecompChunk = window;
 }
 
 
 void Lz::startHighlight()
 {
+    if (mSink)
+        return;
+
     if (mDecompChunk.size())
         mDecompColorizer.addSeparation(mDecompChunk.size(), 2);
     mStartHighlight = mDecompChunk.size();
@@ -37,33 +85,44 @@ void Lz::startHighlight()
 
 void Lz::endHighlight(const QColor& color)
 {
+    if (mSink)
+        return;
+
     mDecompColorizer.addHighlight(mStartHighlight, mDecompChunk.size() - mStartHighlight, color);
 }
 
 
-void Lz::appendUncompressed(const MemChunk& chunk)
+void Lz::appendUncompressed(const MemRope& rope)
 {
-    if (mDecompChunk.size())
-        mDecompColorizer.addSeparation(mDecompChunk.size(), 2);
-    mDecompColorizer.addHighlight(mDecompChunk.size(), chunk.size(), QColor(255, 64, 64, 64));
+    if (!mSink)
+    {
+        if (mDecompChunk.size())
+            mDecompColorizer.addSeparation(mDecompChunk.size(), 2);
+        mDecompColorizer.addHighlight(mDecompChunk.size(), rope.size(), QColor(255, 64, 64, 64));
+    }
 
-    mDecompChunk.append(chunk);
+    for (unsigned int i = 0 ; i < rope.extentCount() ; ++i)
+        mDecompChunk.append(rope.extent(i));
+
+    this->checkSink();
 }
 
 void Lz::appendLiteral(bool addSeparation, unsigned char literal)
 {
-    if (addSeparation)
+    if (addSeparation && !mSink)
         mDecompColorizer.addSeparation(mDecompChunk.size(), 1);
 
     mDecompChunk.appendChar(literal);
+
+    this->checkSink();
 }
 
 void Lz::appendLz(bool addSeparation, unsigned int length, unsigned int distance, unsigned int pos)
 {
-    if (addSeparation)
+    if (addSeparation && !mSink)
         mDecompColorizer.addSeparation(mDecompChunk.size(), 1);
 
-    if (mDecompChunk.size() < distance)
+    if (mFlushed + mDecompChunk.size() < distance)
         Except::reportError(pos, "lz sequence", "distance is before start");
     if (distance > mWindowSize)
         Except::reportError(pos, "lz sequence", "distance is too big for window size");
@@ -71,6 +130,8 @@ void Lz::appendLz(bool addSeparation, unsigned int length, unsigned int distance
     unsigned int k = mDecompChunk.size() - distance;
     for (unsigned int i = 0 ; i < length ; ++i)
         mDecompChunk.appendChar(mDecompChunk[k + i]);
+
+    this->checkSink();
 }
 
 }
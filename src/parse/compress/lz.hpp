@@ -19,7 +19,9 @@
 #ifndef TYREX_PARSE_LZ_HPP
 #define TYREX_PARSE_LZ_HPP
 
+#include <cstdint>
 #include "parsecompress.hpp"
+#include "misc/memrope.hpp"
 
 namespace tyrex {
 namespace parse {
@@ -29,18 +31,39 @@ class Lz : public Compress
     friend class LzmaDecoder;
 
 public:
+    // Receives the decompressed data as it is produced.
+    class Sink
+    {
+    public:
+        virtual ~Sink();
+        virtual void write(const unsigned char* data, unsigned int size) = 0;
+    };
+
     Lz(unsigned int windowSize = 0xFFFFFFFF);
 
 protected:
+    // With a sink, only the window is kept in mDecompChunk and the decompressed data is not colorized.
+    // The decoder must call flushSink() once done.
+    void setSink(Sink* sink);
+    void flushSink();
+
     void startHighlight();
     void endHighlight(const QColor& color);
 
-    void appendUncompressed(const MemChunk& chunk);
+    void appendUncompressed(const MemRope& rope);
     void appendLiteral(bool addSeparation, unsigned char literal);
     void appendLz(bool addSeparation, unsigned int length, unsigned int distance, unsigned int pos);
 
     unsigned int mWindowSize;
     unsigned int mStartHighlight;
+
+private:
+    void checkSink();
+    void writeSink(unsigned int size);
+
+    Sink* mSink;
+    // decompressed bytes already written to the sink
+    uint64_t mFlushed;
 };
 
 }
@@ -17,17 +17,31 @@
 */
 
 #include "png.hpp"
-
+#include "pngfilter.hpp"
+
+#include <QThreadPool>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include "parse/compress/deflate/zlib.hpp"
 #include "misc/hash/hash.hpp"
+#include "misc/profiler.hpp"
 
 namespace tyrex {
 namespace parse {
 
 unsigned char Png::mMagic[8] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
 
-Png::Png() :
-    mProperties("Properties", QStringList() << "Property" << "Value")
+// larger previews are skipped : the next rows are not far
+static const uint64_t maxPreviewPixels = 4 * 1024 * 1024;
+// pixels, as decoded or converted to 32 bits, must stay addressable by int (as in QImage)
+static const uint64_t maxImageBytes = INT_MAX;
+
+Png::Png(bool progressive) :
+    mProperties("Properties", QStringList() << "Property" << "Value"),
+    mProgressive(progressive)
 {
 }
 
@@ -88,7 +102,7 @@ void Png::doParse(const MemChunk& chunk, std::shared_ptr<data::Image>& data)
 
     // TODO: check chunks titles/order
     // parse data
-    MemChunk idat;
+    MemRope idat;
     mWidth = 0;
     mHeight = 0;
     mDepth = 0;
@@ -125,16 +139,9 @@ void Png::doParse(const MemChunk& chunk, std::shared_ptr<data::Image>& data)
             Except::reportError(mChunks[i].mStart, "png chunk", "last chunk must be IEND");
     }
 
-    Zlib zlib;
-    std::shared_ptr<data::Compress> zlibData;
-
-    if (!zlib.parse(idat, zlibData))
-        Except::reportError(0, "png idat", "error decompressing idat", zlibData);
-    MemChunk decompChunk = zlibData->decomp().chunk();
+    this->parseIDAT(idat);
 
-    this->parseIDAT(decompChunk);
-
-    data = std::make_shared<data::Image>(chunk, mSrcColorizer, mPixmap, mProperties);
+    data = std::make_shared<data::Image>(chunk, mSrcColorizer, mPixmap, mProperties, mProgress);
 }
 
 
@@ -216,10 +223,9 @@ void Png::parseIHDR()
     }
 }
 
-void Png::parseIDAT(const MemChunk& src)
+void Png::parseIDAT(const MemRope& idat)
 {
     data::Pixmap::Type type;
-    data::Pixmap::Type indexedtype;
     unsigned int bitsPerPixel;
 
     switch (mColor)
@@ -252,21 +258,24 @@ void Png::parseIDAT(const MemChunk& src)
             type = data::Pixmap::rgb48;
         break;
     case 3: // indexed
+        if (!mPalette)
+            Except::reportError(mChunks[0].mStart, "png chunk", "PLTE chunk is missing");
+
+        // the pixels are indices
         bitsPerPixel = mDepth;
-        type = data::Pixmap::rgb24;
         switch (mDepth)
         {
         case 1:
-            indexedtype = data::Pixmap::grey1;
+            type = data::Pixmap::grey1;
             break;
         case 2:
-            indexedtype = data::Pixmap::grey2;
+            type = data::Pixmap::grey2;
             break;
         case 4:
-            indexedtype = data::Pixmap::grey4;
+            type = data::Pixmap::grey4;
             break;
         case 8:
-            indexedtype = data::Pixmap::grey8;
+            type = data::Pixmap::grey8;
         }
         break;
     case 4: // greyscale with alpha
@@ -290,274 +299,327 @@ void Png::parseIDAT(const MemChunk& src)
         ++bytesPerPixel;
     mProperties.push("Bytes per pixel", QString::number(bytesPerPixel));
 
-    MemChunk unfiltered;
-    unsigned int srcPos = 0;
+    std::shared_ptr<data::Pixmap> palette;
+    if (mColor == 3)
+        palette = mPalette;
 
-    if (mInterlace == 0)
-        unfiltered = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel, mWidth, mHeight);
-    else if (mInterlace == 1)
+    if (!mProgressive)
     {
-        MemChunk img1 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                          (mWidth + 7) >> 3, (mHeight + 7) >> 3);
-        MemChunk img2 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                          (mWidth + 3) >> 3, (mHeight + 7) >> 3);
-        MemChunk img3 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                          (mWidth + 3) >> 2, (mHeight + 3) >> 3);
-        MemChunk img4 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                          (mWidth + 1) >> 2, (mHeight + 3) >> 2);
-        MemChunk img5 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                          (mWidth + 1) >> 1, (mHeight + 1) >> 2);
-        MemChunk img6 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                           mWidth      >> 1, (mHeight + 1) >> 1);
-        MemChunk img7 = this->decodeImage(src, srcPos, bitsPerPixel, bytesPerPixel,
-                                           mWidth,            mHeight      >> 1);
-        unfiltered = this->deinterlace(bitsPerPixel, bytesPerPixel, img1, img2, img3, img4, img5, img6, img7);
+        Decoder decoder(idat, mWidth, mHeight, mInterlace == 1, bitsPerPixel, bytesPerPixel, type, palette, nullptr, mChunks[0].mStart);
+        decoder.decode();
+        mPixmap = decoder.pixmap();
+        return;
     }
 
-    switch (mColor)
+    mProgress = std::make_shared<data::PixmapProgress>();
+    Decoder* decoder = new Decoder(idat, mWidth, mHeight, mInterlace == 1, bitsPerPixel, bytesPerPixel, type, palette, mProgress, mChunks[0].mStart);
+    mPixmap = decoder->pixmap();
+    // the pool deletes the decoder once done
+    QThreadPool::globalInstance()->start(decoder);
+}
+
+
+// Pixels of a pass row to their columns in the image row, or the other way round.
+template <unsigned int bytesPerPixel>
+static void copyBytes(const unsigned char* src, unsigned int srcStep, unsigned char* dst, unsigned int x0, unsigned int dstStep, unsigned int count)
+{
+    dst += x0 * bytesPerPixel;
+    for (unsigned int i = 0 ; i < count ; ++i, src += srcStep * bytesPerPixel, dst += dstStep * bytesPerPixel)
+        std::memcpy(dst, src, bytesPerPixel);
+}
+
+// Pixels of less than a byte, most significant bits first ; the destination row starts zeroed.
+template <unsigned int depth>
+static void copyBits(const unsigned char* src, unsigned int srcStep, unsigned char* dst, unsigned int x0, unsigned int dstStep, unsigned int count)
+{
+    const unsigned int mask = (1 << depth) - 1;
+    for (unsigned int i = 0, from = 0, to = x0 * depth ; i < count ; ++i, from += srcStep * depth, to += dstStep * depth)
     {
-    case 0: // greyscale
-    case 2: // truecolour
-    case 4: // greyscale with alpha
-    case 6: // truecolour with alpha
-        mPixmap = std::make_shared<data::Pixmap>(type, mWidth, mHeight, unfiltered);
-        break;
-    case 3: // indexed
-        bool ok;
-        mPixmap = std::make_shared<data::Pixmap>(data::Pixmap(indexedtype, mWidth, mHeight, unfiltered).unindex(*mPalette, ok));
-        if (!ok)
-            Except::reportError(mChunks[0].mStart, "png IDAT chunk", "invalid index in PLTE");
+        unsigned int value = (src[from >> 3] >> (8 - depth - (from & 7))) & mask;
+        dst[to >> 3] |= value << (8 - depth - (to & 7));
     }
 }
 
 
-MemChunk Png::decodeImage(const MemChunk& src, unsigned int& posSrc, unsigned int bitsPerPixel, unsigned int bytesPerPixel, unsigned int width, unsigned int height)
+Png::Rows::Rows(unsigned int width, unsigned int height, bool interlaced, unsigned int bitsPerPixel, unsigned int bytesPerPixel, unsigned int errorPos) :
+    mWidth(width),
+    mHeight(height),
+    mLinesize((uint64_t(bitsPerPixel) * width + 7) >> 3),
+    mBitsPerPixel(bitsPerPixel),
+    mBytesPerPixel(bytesPerPixel),
+    mErrorPos(errorPos),
+    mPass(0),
+    mRow(0),
+    mFilled(0),
+    mFilter(0),
+    mReady(0)
 {
-    unsigned int xpredict = bytesPerPixel;
-    unsigned int ypredict = width * bytesPerPixel;
+    // checked before allocating : the sizes come straight from IHDR
+    uint64_t rowBits = uint64_t(bitsPerPixel) * width;
+    if (rowBits > UINT_MAX || uint64_t(mLinesize) * height > maxImageBytes || uint64_t(width) * height * 4 > maxImageBytes)
+        Except::reportError(errorPos, "png size", "image too large");
+    mPixels = MemChunk(mLinesize * height);
+
+    if (!interlaced)
+        this->addPass(0, 0, 1, 1);
+    else
+    {
+        this->addPass(0, 0, 8, 8);
+        this->addPass(4, 0, 8, 8);
+        this->addPass(0, 4, 4, 8);
+        this->addPass(2, 0, 4, 4);
+        this->addPass(0, 2, 2, 4);
+        this->addPass(1, 0, 2, 2);
+        this->addPass(0, 1, 1, 2);
+    }
 
-    unsigned int linesize = (bitsPerPixel * width + 7) >> 3;
-    MemChunk dst(linesize * height);
+    mZeros.resize(mLinesize, 0);
+    this->skipEmptyPasses();
+}
 
-    for (unsigned int y = 0 ; y < height ; ++y)
+void Png::Rows::addPass(unsigned int x0, unsigned int y0, unsigned int dx, unsigned int dy)
+{
+    Pass pass;
+    pass.mX0 = x0;
+    pass.mY0 = y0;
+    pass.mDx = dx;
+    pass.mDy = dy;
+    pass.mWidth = mWidth > x0 ? (mWidth - x0 + dx - 1) / dx : 0;
+    pass.mLinesize = (mBitsPerPixel * pass.mWidth + 7) >> 3;
+    pass.mHeight = mHeight > y0 && pass.mLinesize ? (mHeight - y0 + dy - 1) / dy : 0;
+    mPasses.push_back(pass);
+
+    if (dx > 1 && mCurrent.size() < pass.mLinesize)
     {
-        unsigned int filter = src[posSrc];
+        mCurrent.resize(pass.mLinesize);
+        mPrevious.resize(pass.mLinesize);
+    }
+}
 
-        ++posSrc;
-        unsigned int posDst = y * linesize;
+// Each row is a filter byte followed by the filtered bytes, which are unfiltered in place once complete.
+void Png::Rows::write(const unsigned char* data, unsigned int size)
+{
+    // data after the last pass is ignored
+    while (size && mPass < mPasses.size())
+    {
+        const Pass& pass = mPasses[mPass];
 
-        switch (filter)
+        if (!mFilled)
         {
-        case 0:
-            for (unsigned int byte = 0 ; byte < linesize ; ++byte)
-                dst[posDst++] = src[posSrc++];
-            break;
-        case 1:
-            for (unsigned int x = 0 ; x < width ; ++x)
-            {
-                for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                {
-                    dst[posDst] = src[posSrc++] + (x > 0 ? dst[posDst - xpredict] : 0);
-                    ++posDst;
-                }
-            }
-            break;
-        case 2:
-            for (unsigned int x = 0 ; x < width ; ++x)
-            {
-                for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                {
-                    dst[posDst] = src[posSrc++] + (y > 0 ? dst[posDst - ypredict] : 0);
-                    ++posDst;
-                }
-            }
-            break;
-        case 3:
-            for (unsigned int x = 0 ; x < width ; ++x)
+            mFilter = *data++;
+            --size;
+            if (mFilter > PngFilter::paeth)
+                Except::reportError(mErrorPos, "png IDAT chunk", "invalid filter method");
+            mFilled = 1;
+            continue;
+        }
+
+        // rows of passes without column skips are rows of the image
+        bool direct = pass.mDx == 1;
+        unsigned int y = pass.mY0 + mRow * pass.mDy;
+        unsigned char* row = direct ? &mPixels[y * mLinesize] : mCurrent.data();
+
+        unsigned int count = std::min(size, pass.mLinesize + 1 - mFilled);
+        std::memcpy(row + mFilled - 1, data, count);
+        data += count;
+        size -= count;
+        mFilled += count;
+
+        if (mFilled == pass.mLinesize + 1)
+        {
+            const unsigned char* prev = mZeros.data();
+            if (mRow)
+                prev = direct ? row - pass.mDy * mLinesize : mPrevious.data();
+            PngFilter::unfilter(mFilter, row, prev, pass.mLinesize, mBytesPerPixel);
+
+            // only the last pass is direct : its rows complete the rows above them
+            if (direct)
+                mReady = std::min(y + pass.mDy, mHeight);
+            else
             {
-                for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                {
-                    unsigned int a = x > 0 ? dst[posDst - xpredict] : 0;
-                    unsigned int b = y > 0 ? dst[posDst - ypredict] : 0;
-                    dst[posDst++] = src[posSrc++] + (a + b) / 2;
-                }
+                this->copyPixels(row, 1, &mPixels[y * mLinesize], pass.mX0, pass.mDx, pass.mWidth);
+                mCurrent.swap(mPrevious);
             }
-            break;
-        case 4:
-            for (unsigned int x = 0 ; x < width ; ++x)
+
+            mFilled = 0;
+            if (++mRow == pass.mHeight)
             {
-                for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                {
-                    int a = x > 0 ? dst[posDst - xpredict] : 0;
-                    int b = y > 0 ? dst[posDst - ypredict] : 0;
-                    int c = x > 0 && y > 0 ? dst[posDst - ypredict - xpredict] : 0;
-
-                    int p = a + b - c;
-                    int pa = abs(p - a);
-                    int pb = abs(p - b);
-                    int pc = abs(p - c);
-
-                    int r = c;
-                    if (pa <= pb && pa <= pc)
-                        r = a;
-                    else if (pb <= pc)
-                        r = b;
-
-                    dst[posDst++] = src[posSrc++] + r;
-                }
+                mRow = 0;
+                ++mPass;
+                this->skipEmptyPasses();
+                if (this->complete())
+                    mReady = mHeight;
             }
-            break;
-        default:
-            Except::reportError(mChunks[0].mStart, "png IDAT chunk", "invalid filter method");
         }
     }
-
-    return dst;
 }
 
-
-MemChunk Png::deinterlace(unsigned int bitsPerPixel, unsigned int bytesPerPixel, const MemChunk& img1, const MemChunk& img2, const MemChunk& img3, const MemChunk& img4, const MemChunk& img5, const MemChunk& img6, const MemChunk& img7)
+// Passes without pixels have no data at all, not even filter bytes.
+void Png::Rows::skipEmptyPasses()
 {
-    if (bitsPerPixel & 7)
-        return this->deinterlaceBits(bitsPerPixel, img1, img2, img3, img4, img5, img6, img7);
-    else
-        return this->deinterlaceBytes(bytesPerPixel, img1, img2, img3, img4, img5, img6, img7);
+    while (mPass < mPasses.size() && !mPasses[mPass].mHeight)
+        ++mPass;
 }
 
-MemChunk Png::deinterlaceBytes(unsigned int bytesPerPixel, const MemChunk& img1, const MemChunk& img2, const MemChunk& img3, const MemChunk& img4, const MemChunk& img5, const MemChunk& img6, const MemChunk& img7)
+MemChunk Png::Rows::sample(unsigned int step) const
 {
-    unsigned int linesize = bytesPerPixel * mWidth;
-    MemChunk result(linesize * mHeight);
-
-    // pass 1
-    unsigned int pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 8)
-        for (unsigned int x = 0 ; x < mWidth ; x += 8)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img1[pos++];
-
-    // pass 2
-    pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 8)
-        for (unsigned int x = 4 ; x < mWidth ; x += 8)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img2[pos++];
-
-    // pass 3
-    pos = 0;
-    for (unsigned int y = 4 ; y < mHeight ; y += 8)
-        for (unsigned int x = 0 ; x < mWidth ; x += 4)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img3[pos++];
-
-    // pass 4
-    pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 4)
-        for (unsigned int x = 2 ; x < mWidth ; x += 4)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img4[pos++];
-
-    // pass 5
-    pos = 0;
-    for (unsigned int y = 2 ; y < mHeight ; y += 4)
-        for (unsigned int x = 0 ; x < mWidth ; x += 2)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img5[pos++];
-
-    // pass 6
-    pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 2)
-        for (unsigned int x = 1 ; x < mWidth ; x += 2)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img6[pos++];
-
-    // pass 7
-    pos = 0;
-    for (unsigned int y = 1 ; y < mHeight ; y += 2)
-        for (unsigned int x = 0 ; x < mWidth ; ++x)
-            for (unsigned int byte = 0 ; byte < bytesPerPixel ; ++byte)
-                result[(y * mWidth + x) * bytesPerPixel + byte] = img7[pos++];
+    unsigned int width = (mWidth + step - 1) / step;
+    unsigned int height = (mHeight + step - 1) / step;
+    unsigned int linesize = (mBitsPerPixel * width + 7) >> 3;
 
+    MemChunk result(linesize * height);
+    for (unsigned int y = 0 ; y < height ; ++y)
+        this->copyPixels(mPixels.data() + y * step * mLinesize, step, &result[y * linesize], 0, 1, width);
     return result;
 }
 
-MemChunk Png::deinterlaceBits(unsigned int bitsPerPixel, const MemChunk& img1, const MemChunk& img2, const MemChunk& img3, const MemChunk& img4, const MemChunk& img5, const MemChunk& img6, const MemChunk& img7)
+void Png::Rows::copyPixels(const unsigned char* src, unsigned int srcStep, unsigned char* dst, unsigned int x0, unsigned int dstStep, unsigned int count) const
 {
-    unsigned int linesize = (bitsPerPixel * mWidth + 7) >> 3;
-    MemChunk result(linesize * mHeight);
-    linesize <<= 3;
-
-    // pass 1
-    unsigned int pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 8)
+    switch (mBitsPerPixel)
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 0 ; x < mWidth ; x += 8)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img1.getBitBE(pos++));
+    case 1:
+        copyBits<1>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 2:
+        copyBits<2>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 4:
+        copyBits<4>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 8:
+        copyBytes<1>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 16:
+        copyBytes<2>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 24:
+        copyBytes<3>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 32:
+        copyBytes<4>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 48:
+        copyBytes<6>(src, srcStep, dst, x0, dstStep, count);
+        break;
+    case 64:
+        copyBytes<8>(src, srcStep, dst, x0, dstStep, count);
+        break;
     }
+}
+
+
+
+Png::Decoder::Decoder(const MemRope& idat, unsigned int width, unsigned int height, bool interlaced, unsigned int bitsPerPixel, unsigned int bytesPerPixel,
+                      data::Pixmap::Type type, const std::shared_ptr<data::Pixmap>& palette, const std::shared_ptr<data::PixmapProgress>& progress, unsigned int errorPos) :
+    mIdat(idat),
+    mInterlaced(interlaced),
+    mErrorPos(errorPos),
+    mRows(width, height, interlaced, bitsPerPixel, bytesPerPixel, errorPos),
+    mDecoded(type, width, height, mRows.pixels()),
+    mPalette(palette),
+    mPixmap(palette ? std::make_shared<data::Pixmap>(palette->type(), width, height) : std::make_shared<data::Pixmap>(mDecoded)),
+    mProgress(progress),
+    mReady(0),
+    mIndicesOk(true),
+    mPreviewShift(4)
+{
+}
+
 
-    // pass 2
-    pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 8)
+void Png::Decoder::decode()
+{
+    try
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 4 ; x < mWidth ; x += 8)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img2.getBitBE(pos++));
+        Zlib::inflate(mIdat, *this);
     }
-
-    // pass 3
-    pos = 0;
-    for (unsigned int y = 4 ; y < mHeight ; y += 8)
+    catch (const ParseException&)
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 0 ; x < mWidth ; x += 4)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img3.getBitBE(pos++));
+        // in the background, the document is already shown : there is nowhere to put the output
+        if (mProgress)
+            throw;
+
+        // decompress again, keeping the output, to show how far it went
+        std::shared_ptr<data::Compress> zlibData;
+        if (Zlib().parse(mIdat.flatten(), zlibData))
+            throw;
+        Except::reportError(0, "png idat", "error decompressing idat", zlibData);
     }
 
-    // pass 4
-    pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 4)
+    if (!mRows.complete())
+        Except::reportError(mErrorPos, "png IDAT chunk", "not enough image data");
+    if (!mIndicesOk)
+        Except::reportError(mErrorPos, "png IDAT chunk", "invalid index in PLTE");
+}
+
+// Errors are reported like those of a parser ; the pixels decoded before remain.
+void Png::Decoder::run()
+{
+    Profiler::Scope scope("png image data");
+    Profiler::count(Profiler::bytesIn, mIdat.size());
+
+    Except::push();
+    try
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 2 ; x < mWidth ; x += 4)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img4.getBitBE(pos++));
+        this->decode();
     }
-
-    // pass 5
-    pos = 0;
-    for (unsigned int y = 2 ; y < mHeight ; y += 4)
+    catch (const ParseException& e)
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 0 ; x < mWidth ; x += 2)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img5.getBitBE(pos++));
+        std::cerr << "ERROR:   " << e.what() << std::endl;
+        graphic::MainWindow::reportError(e.what());
     }
-
-    // pass 6
-    pos = 0;
-    for (unsigned int y = 0 ; y < mHeight ; y += 2)
+    catch (const Cancelled&)
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 1 ; x < mWidth ; x += 2)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img6.getBitBE(pos++));
     }
+    Except::pop();
+
+    mProgress->finish();
+}
 
-    // pass 7
-    pos = 0;
-    for (unsigned int y = 1 ; y < mHeight ; y += 2)
+void Png::Decoder::write(const unsigned char* data, unsigned int size)
+{
+    if (mProgress && mProgress->cancelled())
+        throw Cancelled();
+
+    mRows.write(data, size);
+    this->publish();
+}
+
+// The first passes of an interlaced image complete grids of 8, 4 then 2 pixels : they make previews until the last pass delivers rows.
+void Png::Decoder::publish()
+{
+    unsigned int ready = mRows.ready();
+    if (ready > mReady)
     {
-        pos = ((pos + 7) >> 3) << 3;
-        for (unsigned int x = 0 ; x < mWidth ; ++x)
-            for (unsigned int bit = 0 ; bit < bitsPerPixel ; ++bit)
-                result.setBitBE(y * linesize + x * bitsPerPixel + bit, img7.getBitBE(pos++));
+        if (mPalette)
+            mIndicesOk &= mDecoded.unindex(*mPalette, *mPixmap, mReady, ready - mReady);
+        mReady = ready;
+        if (mProgress)
+            mProgress->setRows(ready);
     }
 
-    return result;
+    if (!mProgress || !mInterlaced || mRows.complete())
+        return;
+
+    unsigned int passes = mRows.passesDone();
+    unsigned int shift = passes >= 5 ? 1 : passes >= 3 ? 2 : passes >= 1 ? 3 : 0;
+    if (!shift || shift >= mPreviewShift)
+        return;
+    mPreviewShift = shift;
+
+    unsigned int step = 1 << shift;
+    unsigned int width = (mDecoded.width() + step - 1) >> shift;
+    unsigned int height = (mDecoded.height() + step - 1) >> shift;
+    if (uint64_t(width) * height > maxPreviewPixels)
+        return;
+
+    data::Pixmap preview(mDecoded.type(), width, height, mRows.sample(step));
+    if (mPalette)
+    {
+        // invalid indices are reported with the image
+        bool ok;
+        preview = preview.unindex(*mPalette, ok);
+    }
+    mProgress->setPreview(std::make_shared<data::Pixmap>(preview), shift);
 }
 
 }
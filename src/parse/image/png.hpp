@@ -20,7 +20,10 @@
 #define TYREX_PARSE_PNG_HPP
 
 #include "parse/parser.tpl"
+#include "parse/compress/lz.hpp"
 #include "data/image.hpp"
+#include "data/image/pixmapprogress.hpp"
+#include <QRunnable>
 
 namespace tyrex {
 namespace parse {
@@ -28,19 +31,111 @@ namespace parse {
 class Png : public DataParser<data::Image>
 {
 public:
-    Png();
+    // A progressive parser returns as soon as the chunks are checked, and decodes the image data in the background :
+    // the pixmap is filled while it is shown (see data::PixmapProgress), and decoding errors are only reported.
+    explicit Png(bool progressive = false);
 
 private:
     void doParse(const MemChunk& chunk, std::shared_ptr<data::Image>& data);
     void onError(const MemChunk& chunk, std::shared_ptr<data::Image>& data);
 
     void parseIHDR();
-    void parseIDAT(const MemChunk& src);
-    MemChunk decodeImage(const MemChunk& src, unsigned int& posSrc, unsigned int bitsPerPixel, unsigned int bytesPerPixel, unsigned int width, unsigned int height);
+    void parseIDAT(const MemRope& idat);
 
-    MemChunk deinterlace(unsigned int bitsPerPixel, unsigned int bytesPerPixel, const MemChunk& img1, const MemChunk& img2, const MemChunk& img3, const MemChunk& img4, const MemChunk& img5, const MemChunk& img6, const MemChunk& img7);
-    MemChunk deinterlaceBits(unsigned int bitsPerPixel, const MemChunk& img1, const MemChunk& img2, const MemChunk& img3, const MemChunk& img4, const MemChunk& img5, const MemChunk& img6, const MemChunk& img7);
-    MemChunk deinterlaceBytes(unsigned int bytesPerPixel, const MemChunk& img1, const MemChunk& img2, const MemChunk& img3, const MemChunk& img4, const MemChunk& img5, const MemChunk& img6, const MemChunk& img7);
+    // Receives the decompressed image data, and unfilters it row by row straight into the pixels of the image.
+    // Rows of the Adam7 passes which skip columns are unfiltered aside, then scattered to their columns.
+    class Rows : public Lz::Sink
+    {
+    public:
+        Rows(unsigned int width, unsigned int height, bool interlaced, unsigned int bitsPerPixel, unsigned int bytesPerPixel, unsigned int errorPos);
+
+        void write(const unsigned char* data, unsigned int size);
+
+        inline bool complete() const;
+        inline const MemChunk& pixels() const;
+        // rows of the image which are final, and passes which are complete
+        inline unsigned int ready() const;
+        inline unsigned int passesDone() const;
+        // every step-th pixel of every step-th row, packed as an image of their own
+        MemChunk sample(unsigned int step) const;
+
+    private:
+        // pixels mX0 + i * mDx of rows mY0 + j * mDy
+        struct Pass
+        {
+            unsigned int mX0;
+            unsigned int mY0;
+            unsigned int mDx;
+            unsigned int mDy;
+            unsigned int mWidth;
+            unsigned int mHeight;
+            unsigned int mLinesize;
+        };
+
+        void addPass(unsigned int x0, unsigned int y0, unsigned int dx, unsigned int dy);
+        void skipEmptyPasses();
+        // count pixels from every srcStep-th pixel of src to every dstStep-th pixel of dst from column x0 ; dst is zeroed
+        void copyPixels(const unsigned char* src, unsigned int srcStep, unsigned char* dst, unsigned int x0, unsigned int dstStep, unsigned int count) const;
+
+        unsigned int mWidth;
+        unsigned int mHeight;
+        unsigned int mLinesize;
+        unsigned int mBitsPerPixel;
+        unsigned int mBytesPerPixel;
+        unsigned int mErrorPos;
+        MemChunk mPixels;
+
+        std::vector<Pass> mPasses;
+        // row being received and previous row of the pass, for passes which skip columns
+        std::vector<unsigned char> mCurrent;
+        std::vector<unsigned char> mPrevious;
+        // previous row of the first row of a pass
+        std::vector<unsigned char> mZeros;
+
+        // position in the data : row of a pass, and bytes received for this row (filter byte included)
+        unsigned int mPass;
+        unsigned int mRow;
+        unsigned int mFilled;
+        unsigned char mFilter;
+        unsigned int mReady;
+    };
+
+    // Decodes the image data into the pixmap, right away (decode) or in the background (run).
+    // As rows of the image become final, indexed rows are unindexed, and the progress is published.
+    class Decoder : public QRunnable, public Lz::Sink
+    {
+    public:
+        // Pixels are decoded as type ; with a palette, they are indices into it. The progress is null unless decoding in the background.
+        Decoder(const MemRope& idat, unsigned int width, unsigned int height, bool interlaced, unsigned int bitsPerPixel, unsigned int bytesPerPixel,
+                data::Pixmap::Type type, const std::shared_ptr<data::Pixmap>& palette, const std::shared_ptr<data::PixmapProgress>& progress, unsigned int errorPos);
+
+        inline const std::shared_ptr<data::Pixmap>& pixmap() const;
+
+        void decode();
+        void run();
+        void write(const unsigned char* data, unsigned int size);
+
+    private:
+        // thrown through the inflater to stop decoding
+        struct Cancelled {};
+
+        void publish();
+
+        MemRope mIdat;
+        bool mInterlaced;
+        unsigned int mErrorPos;
+        Rows mRows;
+        // the pixels as decoded, indices if there is a palette
+        data::Pixmap mDecoded;
+        std::shared_ptr<data::Pixmap> mPalette;
+        std::shared_ptr<data::Pixmap> mPixmap;
+        std::shared_ptr<data::PixmapProgress> mProgress;
+
+        unsigned int mReady;
+        bool mIndicesOk;
+        // shift of the last preview published
+        unsigned int mPreviewShift;
+    };
 
     struct Element
     {
@@ -57,6 +152,7 @@ private:
     std::vector<Element> mChunks;
     std::shared_ptr<data::Pixmap> mPixmap;
     std::shared_ptr<data::Pixmap> mPalette;
+    std::shared_ptr<data::PixmapProgress> mProgress;
     unsigned int mWidth;
     unsigned int mHeight;
     unsigned char mDepth;
@@ -64,8 +160,21 @@ private:
     unsigned char mCompression;
     unsigned char mFilter;
     unsigned char mInterlace;
+    bool mProgressive;
 };
 
+inline bool Png::Rows::complete() const
+    {return mPass == mPasses.size();}
+inline const MemChunk& Png::Rows::pixels() const
+    {return mPixels;}
+inline unsigned int Png::Rows::ready() const
+    {return mReady;}
+inline unsigned int Png::Rows::passesDone() const
+    {return mPass;}
+
+inline const std::shared_ptr<data::Pixmap>& Png::Decoder::pixmap() const
+    {return mPixmap;}
+
 }
 }
 
@@ -0,0 +1,300 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "pngfilter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TYREX_PNGFILTER_SSE2
+#endif
+
+namespace tyrex {
+namespace parse {
+
+// Predictions use the byte of the previous pixel (a), the byte above (b) and the byte above the previous pixel (c).
+// Bytes before the first pixel count as zeros.
+
+static inline unsigned char paethPredictor(int a, int b, int c)
+{
+    int pa = std::abs(b - c);
+    int pb = std::abs(a - c);
+    int pc = std::abs(a + b - 2 * c);
+
+    if (pa <= pb && pa <= pc)
+        return a;
+    else if (pb <= pc)
+        return b;
+    return c;
+}
+
+#ifdef TYREX_PNGFILTER_SSE2
+// Pixels of 3 and 6 bytes are read and written as 4 and 8 bytes, with the first byte of the next pixel.
+// Predictors are masked to the pixel, so that this byte is written back unchanged.
+// The last pixel of a row is moved exactly, not to go past the row.
+template <unsigned int bpp>
+struct Pixel
+{
+    static const unsigned int wide = bpp == 3 ? 4 : bpp == 6 ? 8 : bpp;
+
+    static inline __m128i mask()
+        {const uint64_t mask = bpp == 8 ? ~0ull : (1ull << (8 * (bpp & 7))) - 1; return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&mask));}
+    static inline __m128i load(const unsigned char* src)
+        {uint64_t pixel = 0; std::memcpy(&pixel, src, wide); return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&pixel));}
+    static inline void store(unsigned char* dst, __m128i x)
+        {uint64_t pixel; _mm_storel_epi64(reinterpret_cast<__m128i*>(&pixel), x); std::memcpy(dst, &pixel, wide);}
+    static inline __m128i loadLast(const unsigned char* src)
+        {uint64_t pixel = 0; std::memcpy(&pixel, src, bpp); return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&pixel));}
+    static inline void storeLast(unsigned char* dst, __m128i x)
+        {uint64_t pixel; _mm_storel_epi64(reinterpret_cast<__m128i*>(&pixel), x); std::memcpy(dst, &pixel, bpp);}
+};
+
+// Last pixel of x, repeated over the whole vector.
+template <unsigned int bpp>
+static inline __m128i repeatLastPixel(__m128i x)
+{
+    if (bpp == 1)
+    {
+        x = _mm_unpackhi_epi8(x, x);
+        x = _mm_unpackhi_epi16(x, x);
+        return _mm_shuffle_epi32(x, 0xFF);
+    }
+    if (bpp == 2)
+        return _mm_shuffle_epi32(_mm_shufflehi_epi16(x, 0xFF), 0xFF);
+    if (bpp == 4)
+        return _mm_shuffle_epi32(x, 0xFF);
+    return _mm_unpackhi_epi64(x, x);
+}
+
+// 16 bytes at a time, as prefix sums of the pixels inside a vector, plus the last pixel of the previous vector.
+// Only for pixel sizes which divide 16.
+template <unsigned int bpp>
+static inline unsigned int subVector(unsigned char* row, unsigned int linesize)
+{
+    __m128i last = _mm_setzero_si128();
+    unsigned int i = 0;
+    for ( ; i + 16 <= linesize ; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        x = _mm_add_epi8(x, _mm_slli_si128(x, bpp));
+        if (bpp < 8)
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 2 * bpp));
+        if (bpp < 4)
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 4 * bpp));
+        if (bpp < 2)
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 8 * bpp));
+        x = _mm_add_epi8(x, last);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), x);
+        last = repeatLastPixel<bpp>(x);
+    }
+    return i;
+}
+
+// _mm_avg_epu8 rounds up, the filter rounds down.
+static inline __m128i averageDown(__m128i a, __m128i b)
+{
+    return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+}
+
+template <unsigned int bpp>
+static inline void averagePixels(unsigned char* row, const unsigned char* prev, unsigned int linesize)
+{
+    const __m128i mask = Pixel<bpp>::mask();
+    __m128i a = _mm_setzero_si128();
+
+    unsigned int i = 0;
+    for ( ; i + Pixel<bpp>::wide <= linesize ; i += bpp)
+    {
+        __m128i average = _mm_and_si128(averageDown(a, Pixel<bpp>::load(prev + i)), mask);
+        a = _mm_add_epi8(Pixel<bpp>::load(row + i), average);
+        Pixel<bpp>::store(row + i, a);
+    }
+    if (i < linesize)
+    {
+        __m128i average = averageDown(_mm_and_si128(a, mask), Pixel<bpp>::loadLast(prev + i));
+        Pixel<bpp>::storeLast(row + i, _mm_add_epi8(Pixel<bpp>::loadLast(row + i), average));
+    }
+}
+
+static inline __m128i abs16(__m128i x)
+{
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+// Predictors are computed on 16-bit lanes, and selected with masks rather than branches.
+static inline __m128i paethPredictor(__m128i a, __m128i b, __m128i c)
+{
+    __m128i pa = _mm_sub_epi16(b, c);
+    __m128i pb = _mm_sub_epi16(a, c);
+    __m128i pc = abs16(_mm_add_epi16(pa, pb));
+    pa = abs16(pa);
+    pb = abs16(pb);
+
+    // b if pb <= pc, else c
+    __m128i cNearer = _mm_cmpgt_epi16(pb, pc);
+    __m128i nearest = _mm_or_si128(_mm_and_si128(cNearer, c), _mm_andnot_si128(cNearer, b));
+    // a if pa <= pb and pa <= pc
+    __m128i aFarther = _mm_cmpgt_epi16(pa, _mm_min_epi16(pb, pc));
+    __m128i predictor = _mm_or_si128(_mm_and_si128(aFarther, nearest), _mm_andnot_si128(aFarther, a));
+
+    return _mm_packus_epi16(predictor, predictor);
+}
+
+template <unsigned int bpp>
+static inline void paethPixels(unsigned char* row, const unsigned char* prev, unsigned int linesize)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = Pixel<bpp>::mask();
+    __m128i a = zero;
+    __m128i c = zero;
+
+    unsigned int i = 0;
+    for ( ; i + Pixel<bpp>::wide <= linesize ; i += bpp)
+    {
+        __m128i b = _mm_unpacklo_epi8(_mm_and_si128(Pixel<bpp>::load(prev + i), mask), zero);
+        __m128i x = _mm_add_epi8(Pixel<bpp>::load(row + i), _mm_and_si128(paethPredictor(a, b, c), mask));
+        Pixel<bpp>::store(row + i, x);
+
+        a = _mm_unpacklo_epi8(_mm_and_si128(x, mask), zero);
+        c = b;
+    }
+    if (i < linesize)
+    {
+        __m128i b = _mm_unpacklo_epi8(Pixel<bpp>::loadLast(prev + i), zero);
+        Pixel<bpp>::storeLast(row + i, _mm_add_epi8(Pixel<bpp>::loadLast(row + i), paethPredictor(a, b, c)));
+    }
+}
+#endif
+
+
+void PngFilter::unfilter(unsigned int filter, unsigned char* row, const unsigned char* prev, unsigned int linesize, unsigned int bytesPerPixel)
+{
+    switch (filter)
+    {
+    case sub:
+        PngFilter::unfilterSub(row, linesize, bytesPerPixel);
+        break;
+    case up:
+        PngFilter::unfilterUp(row, prev, linesize);
+        break;
+    case average:
+        PngFilter::unfilterAverage(row, prev, linesize, bytesPerPixel);
+        break;
+    case paeth:
+        PngFilter::unfilterPaeth(row, prev, linesize, bytesPerPixel);
+        break;
+    }
+}
+
+
+void PngFilter::unfilterSub(unsigned char* row, unsigned int linesize, unsigned int bytesPerPixel)
+{
+    unsigned int i = bytesPerPixel;
+
+#ifdef TYREX_PNGFILTER_SSE2
+    switch (bytesPerPixel)
+    {
+    case 1:
+        i = std::max(i, subVector<1>(row, linesize));
+        break;
+    case 2:
+        i = std::max(i, subVector<2>(row, linesize));
+        break;
+    case 4:
+        i = std::max(i, subVector<4>(row, linesize));
+        break;
+    case 8:
+        i = std::max(i, subVector<8>(row, linesize));
+        break;
+    }
+#endif
+
+    for ( ; i < linesize ; ++i)
+        row[i] += row[i - bytesPerPixel];
+}
+
+void PngFilter::unfilterUp(unsigned char* row, const unsigned char* prev, unsigned int linesize)
+{
+    unsigned int i = 0;
+
+#ifdef TYREX_PNGFILTER_SSE2
+    for ( ; i + 16 <= linesize ; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(x, b));
+    }
+#endif
+
+    for ( ; i < linesize ; ++i)
+        row[i] += prev[i];
+}
+
+void PngFilter::unfilterAverage(unsigned char* row, const unsigned char* prev, unsigned int linesize, unsigned int bytesPerPixel)
+{
+#ifdef TYREX_PNGFILTER_SSE2
+    switch (bytesPerPixel)
+    {
+    case 4:
+        averagePixels<4>(row, prev, linesize);
+        return;
+    case 8:
+        averagePixels<8>(row, prev, linesize);
+        return;
+    }
+#endif
+
+    unsigned int first = std::min(bytesPerPixel, linesize);
+    for (unsigned int i = 0 ; i < first ; ++i)
+        row[i] += prev[i] >> 1;
+    for (unsigned int i = first ; i < linesize ; ++i)
+        row[i] += (row[i - bytesPerPixel] + prev[i]) >> 1;
+}
+
+void PngFilter::unfilterPaeth(unsigned char* row, const unsigned char* prev, unsigned int linesize, unsigned int bytesPerPixel)
+{
+#ifdef TYREX_PNGFILTER_SSE2
+    switch (bytesPerPixel)
+    {
+    case 3:
+        paethPixels<3>(row, prev, linesize);
+        return;
+    case 4:
+        paethPixels<4>(row, prev, linesize);
+        return;
+    case 6:
+        paethPixels<6>(row, prev, linesize);
+        return;
+    case 8:
+        paethPixels<8>(row, prev, linesize);
+        return;
+    }
+#endif
+
+    unsigned int first = std::min(bytesPerPixel, linesize);
+    for (unsigned int i = 0 ; i < first ; ++i)
+        row[i] += prev[i];
+    for (unsigned int i = first ; i < linesize ; ++i)
+        row[i] += paethPredictor(row[i - bytesPerPixel], prev[i], prev[i - bytesPerPixel]);
+}
+
+}
+}
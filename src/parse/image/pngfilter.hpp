@@ -0,0 +1,51 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PARSE_PNGFILTER_HPP
+#define TYREX_PARSE_PNGFILTER_HPP
+
+namespace tyrex {
+namespace parse {
+
+// Reverts the filters applied to each row of png image data.
+// Kernels are specialized by bytes per pixel, and vectorized with SSE2 when available.
+class PngFilter
+{
+public:
+    enum Type {
+        none,
+        sub,
+        up,
+        average,
+        paeth
+    };
+
+    // Unfilters a row in place ; prev is the previous row, already unfiltered (zeros for the first row of a pass).
+    static void unfilter(unsigned int filter, unsigned char* row, const unsigned char* prev, unsigned int linesize, unsigned int bytesPerPixel);
+
+private:
+    static void unfilterSub(unsigned char* row, unsigned int linesize, unsigned int bytesPerPixel);
+    static void unfilterUp(unsigned char* row, const unsigned char* prev, unsigned int linesize);
+    static void unfilterAverage(unsigned char* row, const unsigned char* prev, unsigned int linesize, unsigned int bytesPerPixel);
+    static void unfilterPaeth(unsigned char* row, const unsigned char* prev, unsigned int linesize, unsigned int bytesPerPixel);
+};
+
+}
+}
+
+#endif // TYREX_PARSE_PNGFILTER_HPP
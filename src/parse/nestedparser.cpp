@@ -0,0 +1,92 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "nestedparser.hpp"
+
+#include "misc/arena.hpp"
+#include "misc/profiler.hpp"
+#include "parsedocument.hpp"
+
+namespace tyrex {
+namespace parse {
+
+static const unsigned int maxDepth = 8;
+static const unsigned int maxOutputSize = 256 << 20;
+static const uint64_t maxScheduledSize = uint64_t(4) << 30;
+
+
+NestedParser::NestedParser() :
+    mScheduledSize(0)
+{
+}
+
+
+void NestedParser::run(const std::shared_ptr<data::Data>& data)
+{
+    this->schedule(data, 1);
+    mPool.waitForDone();
+}
+
+void NestedParser::schedule(const std::shared_ptr<data::Data>& data, unsigned int depth)
+{
+    if (depth > maxDepth)
+        return;
+
+    std::vector<data::Data::Output> outputs = data->outputs();
+    data->resizeNested(outputs.size());
+
+    for (unsigned int i = 0 ; i < outputs.size() ; ++i)
+    {
+        const MemChunk& chunk = outputs[i].mChunk;
+        if (!chunk.size() || chunk.size() > maxOutputSize)
+            continue;
+        if (mScheduledSize.fetch_add(chunk.size()) + chunk.size() > maxScheduledSize)
+            continue;
+
+        mPool.start(new Task(*this, data, i, chunk, depth));
+    }
+}
+
+
+NestedParser::Task::Task(NestedParser& parser, const std::shared_ptr<data::Data>& parent, unsigned int index, const MemChunk& chunk, unsigned int depth) :
+    mParser(parser),
+    mParent(parent),
+    mIndex(index),
+    mChunk(chunk),
+    mDepth(depth)
+{
+}
+
+void NestedParser::Task::run()
+{
+    std::shared_ptr<data::Data> data;
+    {
+        Profiler::Scope scope("nested document");
+        Arena::Scope arenaScope(std::make_shared<Arena>());
+        data = Document::parseNested(mChunk);
+    }
+
+    if (data)
+    {
+        mParent->setNested(mIndex, data);
+        mParser.schedule(data, mDepth + 1);
+    }
+}
+
+}
+}
@@ -0,0 +1,66 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PARSE_NESTEDPARSER_HPP
+#define TYREX_PARSE_NESTEDPARSER_HPP
+
+#include "data/data.hpp"
+#include <QRunnable>
+#include <QThreadPool>
+#include <atomic>
+
+namespace tyrex {
+namespace parse {
+
+// Decodes the outputs of a document (archive members, unpacked streams) whose type is recognized, then their own outputs,
+// on a pool of threads. Each nested parse runs with its own arena.
+// The nesting depth, the size of each output and the total size handed to parsers are bounded, against decompression bombs.
+class NestedParser
+{
+public:
+    NestedParser();
+
+    // returns when all nested documents are parsed
+    void run(const std::shared_ptr<data::Data>& data);
+
+private:
+    class Task : public QRunnable
+    {
+    public:
+        Task(NestedParser& parser, const std::shared_ptr<data::Data>& parent, unsigned int index, const MemChunk& chunk, unsigned int depth);
+
+        void run();
+
+    private:
+        NestedParser& mParser;
+        std::shared_ptr<data::Data> mParent;
+        unsigned int mIndex;
+        MemChunk mChunk;
+        unsigned int mDepth;
+    };
+
+    void schedule(const std::shared_ptr<data::Data>& data, unsigned int depth);
+
+    QThreadPool mPool;
+    std::atomic<uint64_t> mScheduledSize;
+};
+
+}
+}
+
+#endif // TYREX_PARSE_NESTEDPARSER_HPP
@@ -20,8 +20,10 @@
 
 #include "graphic/dialog/typeselector.hpp"
 #include "graphic/dialog/inputdialog.hpp"
+#include "misc/profiler.hpp"
 #include "parse/archive/tar.hpp"
 #include "parse/archive/zip.hpp"
+#include "parse/carver.hpp"
 #include "parse/compress/bzip2.hpp"
 #include "parse/compress/deflate/deflate.hpp"
 #include "parse/compress/deflate/gzip.hpp"
@@ -33,21 +35,44 @@
 #include "parse/image/png.hpp"
 #include "parse/program/parseelf.tpl"
 #include "parse/program/parsejavaclass.hpp"
+#include "parse/nestedparser.hpp"
+#include "parse/resultcache.hpp"
+#include <cstring>
 
 namespace tyrex {
 namespace parse {
 
-Document::Document(QWidget* parent) :
-    mParent(parent)
+bool Document::mNestedParsing = false;
+
+
+Document::Document(QWidget* parent, bool interactive) :
+    mParent(parent),
+    mInteractive(interactive)
 {
 }
 
 
 std::shared_ptr<data::Data> Document::parse(MemChunk source, QWidget* parent)
 {
-    Document p(parent);
+    Document p(parent, true);
     std::shared_ptr<data::Data> data;
     p.parse(source, data);
+
+    if (data && mNestedParsing)
+    {
+        Profiler::Scope scope("nested parsing");
+        NestedParser().run(data);
+    }
+
+    return data;
+}
+
+std::shared_ptr<data::Data> Document::parseNested(const MemChunk& source)
+{
+    Document p(nullptr, false);
+    std::shared_ptr<data::Data> data;
+    if (!Document::findFormats(source).empty())
+        p.parse(source, data);
     return data;
 }
 
@@ -59,68 +84,148 @@ void Document::onError(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 
 void Document::doParse(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
-    static const TypeToParser typeToParser {
-        {"archive/tar", &Document::parseArchiveTar},
-        {"archive/zip", &Document::parseArchiveZip},
-        {"compress/bzip2", &Document::parseCompressBzip2},
-        {"compress/deflate", &Document::parseCompressDeflate},
-        {"compress/gzip", &Document::parseCompressGzip},
-        {"compress/lzma", &Document::parseCompressLzma},
-        {"compress/lzma2", &Document::parseCompressLzma2},
-        {"compress/xz", &Document::parseCompressXz},
-        {"compress/zlib", &Document::parseCompressZlib},
-        {"font/truetype", &Document::parseFontTruetype},
-        {"image/png", &Document::parseImagePng},
-        {"program/elf32", &Document::parseProgramElf32},
-        {"program/elf64", &Document::parseProgramElf64},
-        {"program/java", &Document::parseProgramJava}
-    };
-
-    QStringList types = Document::findTypes(chunk);
-    bool cancelled;
-    QString type = graphic::TypeSelector::select(mParent, types, cancelled);
-    if (cancelled)
-        return;
-
-    auto found = typeToParser.find(type);
-    if (found != typeToParser.end())
-        (this->*found->second)(chunk, data);
+    std::vector<const Format*> formats;
+    {
+        Profiler::Scope scope("find types");
+        formats = Document::findFormats(chunk);
+    }
+
+    const Format* format = nullptr;
+    if (mInteractive)
+    {
+        QStringList types;
+        for (const Format* found : formats)
+            types.append(found->mName);
+
+        bool cancelled;
+        QString type;
+        {
+            // user interaction, reported apart from parsing time
+            Profiler::Scope scope("select type");
+            type = graphic::TypeSelector::select(mParent, types, cancelled);
+        }
+        if (cancelled)
+            return;
+        format = Document::findFormat(type);
+    }
+    else if (!formats.empty())
+        format = formats.front();
+
+    if (format)
+        (this->*format->mParse)(chunk, data);
 
     if (!data)
         data = std::make_shared<data::ByteSequence>(chunk);
 }
 
 
-QStringList Document::findTypes(const MemChunk& chunk)
-{
-    static const std::vector<std::pair<std::vector<unsigned char>, QString> > magics {
-        {{0x1F, 0x8B}, "compress/gzip"},
-        {{0x42, 0x5A, 0x68}, "compress/bzip2"},
-        {{0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}, "image/png"},
-        {{0x7F, 0x45, 0x4C, 0x46, 0x01}, "program/elf32"},
-        {{0x7F, 0x45, 0x4C, 0x46, 0x02}, "program/elf64"},
-        {{0xCA, 0xFE, 0xBA, 0xBE}, "program/java"},
-        {{0x00, 0x01, 0x00, 0x00}, "font/truetype"},
-        {{0x74, 0x72, 0x75, 0x65}, "font/truetype"},
-        //{{0x4D, 0x54, 0x68, 0x64}, "audio/midi"},
-        {{0x50, 0x4B, 0x03, 0x04}, "archive/zip"},
-        //{{0x3C, 0x3F, 0x78, 0x6D, 0x6C}, "document/xml"},
-        //{{0x25, 0x50, 0x44, 0x46, 0x2D}, "document/pdf"},
-        {{0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00}, "compress/xz"}//,
-        //{{0x46, 0x57, 0x53}, "animation/flash"},
-        //{{0x43, 0x57, 0x53}, "animation/flash"},
-        //{{0x5A, 0x57, 0x53}, "animation/flash"}
-    };
-
-    QStringList result;
-    for (auto& magic : magics)
-        if (!chunk.uncompare(magic.first))
-            result.append(magic.second);
+constexpr Document::Format Document::mFormats[] = {
+    {"compress/gzip", {0x1F, 0x8B}, 2, &Document::parseCompressGzip},
+    {"compress/bzip2", {0x42, 0x5A, 0x68}, 3, &Document::parseCompressBzip2},
+    {"image/png", {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}, 8, &Document::parseImagePng},
+    {"program/elf32", {0x7F, 0x45, 0x4C, 0x46, 0x01}, 5, &Document::parseProgramElf32},
+    {"program/elf64", {0x7F, 0x45, 0x4C, 0x46, 0x02}, 5, &Document::parseProgramElf64},
+    {"program/java", {0xCA, 0xFE, 0xBA, 0xBE}, 4, &Document::parseProgramJava},
+    {"font/truetype", {0x00, 0x01, 0x00, 0x00}, 4, &Document::parseFontTruetype},
+    {"font/truetype", {0x74, 0x72, 0x75, 0x65}, 4, &Document::parseFontTruetype},
+    //{"audio/midi", {0x4D, 0x54, 0x68, 0x64}, 4, nullptr},
+    {"archive/zip", {0x50, 0x4B, 0x03, 0x04}, 4, &Document::parseArchiveZip},
+    //{"document/xml", {0x3C, 0x3F, 0x78, 0x6D, 0x6C}, 5, nullptr},
+    //{"document/pdf", {0x25, 0x50, 0x44, 0x46, 0x2D}, 5, nullptr},
+    {"compress/xz", {0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00}, 6, &Document::parseCompressXz},
+    //{"animation/flash", {0x46, 0x57, 0x53}, 3, nullptr},
+    //{"animation/flash", {0x43, 0x57, 0x53}, 3, nullptr},
+    //{"animation/flash", {0x5A, 0x57, 0x53}, 3, nullptr},
+    {"archive/tar", {}, 0, &Document::parseArchiveTar},
+    {"carve", {}, 0, &Document::parseCarve},
+    {"compress/deflate", {}, 0, &Document::parseCompressDeflate},
+    {"compress/lzma", {}, 0, &Document::parseCompressLzma},
+    {"compress/lzma2", {}, 0, &Document::parseCompressLzma2},
+    {"compress/zlib", {}, 0, &Document::parseCompressZlib}
+};
+
+// candidate masks of the 256 byte values, expanded at compile time
+template <unsigned int... bytes>
+struct Indices {};
+template <unsigned int count, unsigned int... bytes>
+struct MakeIndices : MakeIndices<count - 1, count - 1, bytes...> {};
+template <unsigned int... bytes>
+struct MakeIndices<0, bytes...>
+{
+    typedef Indices<bytes...> type;
+};
+
+static constexpr uint32_t candidates(const Document::Format* formats, unsigned int count, unsigned int byte)
+{
+    return !count ? 0 : candidates(formats, count - 1, byte)
+        | (formats[count - 1].mMagicSize && formats[count - 1].mMagic[0] == byte ? uint32_t(1) << (count - 1) : 0);
+}
+
+template <unsigned int... bytes>
+static constexpr std::array<uint32_t, 256> candidateTable(const Document::Format* formats, unsigned int count, Indices<bytes...>)
+{
+    return std::array<uint32_t, 256> {{candidates(formats, count, bytes)...}};
+}
+
+constexpr std::array<uint32_t, 256> Document::mCandidates = candidateTable(mFormats, sizeof(mFormats) / sizeof(Format), MakeIndices<256>::type());
+
+
+unsigned int Document::formatCount()
+{
+    static_assert(sizeof(mFormats) / sizeof(Format) <= 32, "candidate masks have 32 bits");
+    return sizeof(mFormats) / sizeof(Format);
+}
+
+const Document::Format& Document::format(unsigned int index)
+{
+    return mFormats[index];
+}
+
+std::vector<const Document::Format*> Document::findFormats(const MemChunk& chunk)
+{
+    std::vector<const Format*> result;
+    unsigned int size = chunk.size();
+    if (!size)
+        return result;
+
+    const unsigned char* data = chunk.data();
+    for (uint32_t mask = mCandidates[data[0]], i = 0 ; mask ; mask >>= 1, ++i)
+        if ((mask & 1) && mFormats[i].mMagicSize <= size && !std::memcmp(data, mFormats[i].mMagic, mFormats[i].mMagicSize))
+            result.push_back(&mFormats[i]);
 
     return result;
 }
 
+const Document::Format* Document::findFormat(const QString& name)
+{
+    for (const Format& format : mFormats)
+        if (name == format.mName)
+            return &format;
+    return nullptr;
+}
+
 
+template <typename ParserT, typename DataT>
+void Document::parseCached(ParserT& parser, const QString& parameters, const MemChunk& chunk, std::shared_ptr<data::Data>& data)
+{
+    ResultCache cache(chunk, parameters);
+    std::shared_ptr<DataT> parsedData;
+
+    bool cached;
+    {
+        Profiler::Scope scope("load cached result");
+        cached = cache.load(parsedData);
+    }
+
+    // results of failed parses are partial, they are not saved
+    if (!cached && parser.parse(chunk, parsedData))
+        cache.store(*parsedData);
+
+    data = parsedData;
+}
+
+
+// tar members are slices of the input, and the header scan has its own cache (see TarIndex)
 void Document::parseArchiveTar(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Tar tar;
@@ -133,77 +238,62 @@ void Document::parseArchiveTar(const MemChunk& chunk, std::shared_ptr<data::Data
 void Document::parseArchiveZip(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Zip zip;
-    std::shared_ptr<data::Archive> parsedData;
+    this->parseCached<Zip, data::Archive>(zip, "archive/zip", chunk, data);
+}
 
-    zip.parse(chunk, parsedData);
+void Document::parseCarve(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
+{
+    Carver carver;
+    std::shared_ptr<data::Carving> parsedData;
+
+    carver.parse(chunk, parsedData);
     data = parsedData;
 }
 
 void Document::parseCompressBzip2(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Bzip2 bzip2;
-    std::shared_ptr<data::Compress> parsedData;
-
-    bzip2.parse(chunk, parsedData);
-    data = parsedData;
+    this->parseCached<Bzip2, data::Compress>(bzip2, "compress/bzip2", chunk, data);
 }
 
 void Document::parseCompressDeflate(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     unsigned int window;
-    if (graphic::InputDialog::getUint(window, "Size of decompression window", mParent))
+    if (mInteractive && graphic::InputDialog::getUint(window, "Size of decompression window", mParent))
     {
         Deflate deflate(window);
-        std::shared_ptr<data::Compress> parsedData;
-
-        deflate.parse(chunk, parsedData);
-        data = parsedData;
+        this->parseCached<Deflate, data::Compress>(deflate, "compress/deflate " + QString::number(window), chunk, data);
     }
 }
 
 void Document::parseCompressGzip(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Gzip gzip;
-    std::shared_ptr<data::Compress> parsedData;
-
-    gzip.parse(chunk, parsedData);
-    data = parsedData;
+    this->parseCached<Gzip, data::Compress>(gzip, "compress/gzip", chunk, data);
 }
 
 void Document::parseCompressLzma(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Lzma lzma;
-    std::shared_ptr<data::Compress> parsedData;
-
-    lzma.parse(chunk, parsedData);
-    data = parsedData;
+    this->parseCached<Lzma, data::Compress>(lzma, "compress/lzma", chunk, data);
 }
 
 void Document::parseCompressLzma2(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Lzma2 lzma2;
-    std::shared_ptr<data::Compress> parsedData;
-
-    lzma2.parse(chunk, parsedData);
-    data = parsedData;
+    this->parseCached<Lzma2, data::Compress>(lzma2, "compress/lzma2", chunk, data);
 }
 
 void Document::parseCompressXz(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Xz xz;
-    std::shared_ptr<data::Compress> parsedData;
-
-    xz.parse(chunk, parsedData);
-    data = parsedData;
+    this->parseCached<Xz, data::Compress>(xz, "compress/xz", chunk, data);
 }
 
 void Document::parseCompressZlib(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
     Zlib zlib;
-    std::shared_ptr<data::Compress> parsedData;
-
-    zlib.parse(chunk, parsedData);
-    data = parsedData;
+    this->parseCached<Zlib, data::Compress>(zlib, "compress/zlib", chunk, data);
 }
 
 void Document::parseFontTruetype(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
@@ -215,9 +305,10 @@ void Document::parseFontTruetype(const MemChunk& chunk, std::shared_ptr<data::Da
     data = parsedData;
 }
 
+// the image shown is decoded in the background, nested ones right away
 void Document::parseImagePng(const MemChunk& chunk, std::shared_ptr<data::Data>& data)
 {
-    Png png;
+    Png png(mInteractive);
     std::shared_ptr<data::Image> parsedData;
 
     if (png.parse(chunk, parsedData))
@@ -21,6 +21,7 @@
 
 #include "parser.tpl"
 #include "data/data.hpp"
+#include <array>
 
 namespace tyrex {
 namespace parse {
@@ -31,19 +32,46 @@ public:
     using DataParser<data::Data>::parse;
 
     static std::shared_ptr<data::Data> parse(MemChunk source, QWidget* parent);
+    // without asking the user : the first type found is used, and the result is null if there is none
+    // May be called from any thread.
+    static std::shared_ptr<data::Data> parseNested(const MemChunk& source);
+
+    // whether parse() also decodes the documents found inside the result (see NestedParser)
+    static inline bool nestedParsing();
+    static inline void setNestedParsing(bool enabled);
+
+    typedef void (Document::*ParseFunction)(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
+    static const unsigned int maxMagicSize = 8;
+
+    // A supported type : its name, the signature found at the start of its files (if any) and its parser.
+    struct Format
+    {
+        const char* mName;
+        unsigned char mMagic[maxMagicSize];
+        unsigned int mMagicSize;
+        ParseFunction mParse;
+    };
+
+    static unsigned int formatCount();
+    static const Format& format(unsigned int index);
 
 private:
-    Document(QWidget* parent);
+    Document(QWidget* parent, bool interactive);
 
     void doParse(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
     void onError(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
 
-    QStringList findTypes(const MemChunk& chunk);
+    // formats whose signature matches, in the order of mFormats
+    static std::vector<const Format*> findFormats(const MemChunk& chunk);
+    static const Format* findFormat(const QString& name);
 
-    typedef std::map<QString, void (Document::*)(const MemChunk& chunk, std::shared_ptr<data::Data>& data)> TypeToParser;
+    // parses through the result cache (see ResultCache)
+    template <typename ParserT, typename DataT>
+    void parseCached(ParserT& parser, const QString& parameters, const MemChunk& chunk, std::shared_ptr<data::Data>& data);
 
     void parseArchiveTar(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
     void parseArchiveZip(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
+    void parseCarve(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
     void parseCompressBzip2(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
     void parseCompressDeflate(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
     void parseCompressGzip(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
@@ -58,8 +86,21 @@ private:
     void parseProgramJava(const MemChunk& chunk, std::shared_ptr<data::Data>& data);
 
     QWidget* mParent;
+    bool mInteractive;
+
+    // formats with a signature first
+    static const Format mFormats[];
+    // bit i is set at each byte value that starts the signature of mFormats[i] (computed at compile time)
+    static const std::array<uint32_t, 256> mCandidates;
+
+    static bool mNestedParsing;
 };
 
+inline bool Document::nestedParsing()
+    {return mNestedParsing;}
+inline void Document::setNestedParsing(bool enabled)
+    {mNestedParsing = enabled;}
+
 }
 }
 
@@ -45,8 +45,8 @@ const char* ParseException::what() const throw()
 }
 
 
-std::vector<std::shared_ptr<Except> > Except::mHandlerStack;
-std::shared_ptr<Except> Except::mHandler;
+thread_local std::vector<std::shared_ptr<Except> > Except::mHandlerStack;
+thread_local std::shared_ptr<Except> Except::mHandler;
 
 
 void Except::push()
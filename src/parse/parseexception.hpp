@@ -58,8 +58,9 @@ public:
     static void reportWarning(unsigned int byteOffset, const std::string& who, const std::string& what, const std::shared_ptr<data::Data>& data = nullptr);
 
 private:
-    static std::vector<std::shared_ptr<Except> > mHandlerStack;
-    static std::shared_ptr<Except> mHandler;
+    // one stack per thread, so that nested documents can be parsed in parallel
+    static thread_local std::vector<std::shared_ptr<Except> > mHandlerStack;
+    static thread_local std::shared_ptr<Except> mHandler;
 
     std::vector<ParseException> mErrors;
     std::vector<ParseException> mWarnings;
@@ -23,6 +23,7 @@
 
 #include "graphic/console.hpp"
 #include "graphic/mainwindow.hpp"
+#include "misc/profiler.hpp"
 #include "parseexception.hpp"
 #include <iostream>
 
@@ -39,7 +40,7 @@ bool Parser<inputT, outputT>::parse(const inputT& in, outputT& out)
     catch (const ParseException& e)
     {
         std::cerr << "ERROR:   " << e.what() << std::endl;
-        graphic::MainWindow::console()->error(e.what());
+        graphic::MainWindow::reportError(e.what());
         return false;
     }
     return true;
@@ -51,6 +52,9 @@ bool DataParser<dataT>::parse(const MemChunk& in, std::shared_ptr<dataT>& out)
 {
     bool success = true;
 
+    Profiler::Scope scope(typeid(*this));
+    Profiler::count(Profiler::bytesIn, in.size());
+
     Except::push();
     try
     {
@@ -59,7 +63,7 @@ bool DataParser<dataT>::parse(const MemChunk& in, std::shared_ptr<dataT>& out)
     catch (const ParseException& e)
     {
         std::cerr << "ERROR:   " << e.what() << std::endl;
-        graphic::MainWindow::console()->error(e.what());
+        graphic::MainWindow::reportError(e.what());
         this->onError(in, out);
 
         const std::shared_ptr<data::Data>& errorData = e.data();
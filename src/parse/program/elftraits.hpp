@@ -37,6 +37,8 @@ public:
     typedef Elf32Header header_type;
     typedef Elf32_Phdr phdr_type;
     typedef Elf32_Shdr shdr_type;
+    typedef Elf32_Sym sym_type;
+    typedef Elf32_Dyn dyn_type;
 
     static unsigned char mMagic[5];
     static constexpr unsigned int mHeaderSize = 52;
@@ -50,6 +52,8 @@ public:
     typedef Elf64Header header_type;
     typedef Elf64_Phdr phdr_type;
     typedef Elf64_Shdr shdr_type;
+    typedef Elf64_Sym sym_type;
+    typedef Elf64_Dyn dyn_type;
 
     static unsigned char mMagic[5];
     static constexpr unsigned int mHeaderSize = 64;
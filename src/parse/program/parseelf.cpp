@@ -114,6 +114,112 @@ QString Elf::parseSectionHeaderFlags(const uint32_t& flags)
 }
 
 
+QString Elf::parseDynamicTag(const int64_t& tag)
+{
+    switch (tag)
+    {
+    case DT_NULL:
+        return "DT_NULL";
+    case DT_NEEDED:
+        return "DT_NEEDED";
+    case DT_PLTRELSZ:
+        return "DT_PLTRELSZ";
+    case DT_PLTGOT:
+        return "DT_PLTGOT";
+    case DT_HASH:
+        return "DT_HASH";
+    case DT_STRTAB:
+        return "DT_STRTAB";
+    case DT_SYMTAB:
+        return "DT_SYMTAB";
+    case DT_RELA:
+        return "DT_RELA";
+    case DT_RELASZ:
+        return "DT_RELASZ";
+    case DT_RELAENT:
+        return "DT_RELAENT";
+    case DT_STRSZ:
+        return "DT_STRSZ";
+    case DT_SYMENT:
+        return "DT_SYMENT";
+    case DT_INIT:
+        return "DT_INIT";
+    case DT_FINI:
+        return "DT_FINI";
+    case DT_SONAME:
+        return "DT_SONAME";
+    case DT_RPATH:
+        return "DT_RPATH";
+    case DT_SYMBOLIC:
+        return "DT_SYMBOLIC";
+    case DT_REL:
+        return "DT_REL";
+    case DT_RELSZ:
+        return "DT_RELSZ";
+    case DT_RELENT:
+        return "DT_RELENT";
+    case DT_PLTREL:
+        return "DT_PLTREL";
+    case DT_DEBUG:
+        return "DT_DEBUG";
+    case DT_TEXTREL:
+        return "DT_TEXTREL";
+    case DT_JMPREL:
+        return "DT_JMPREL";
+    case DT_BIND_NOW:
+        return "DT_BIND_NOW";
+    case DT_INIT_ARRAY:
+        return "DT_INIT_ARRAY";
+    case DT_FINI_ARRAY:
+        return "DT_FINI_ARRAY";
+    case DT_INIT_ARRAYSZ:
+        return "DT_INIT_ARRAYSZ";
+    case DT_FINI_ARRAYSZ:
+        return "DT_FINI_ARRAYSZ";
+    case DT_RUNPATH:
+        return "DT_RUNPATH";
+    case DT_FLAGS:
+        return "DT_FLAGS";
+    case DT_PREINIT_ARRAY:
+        return "DT_PREINIT_ARRAY";
+    case DT_PREINIT_ARRAYSZ:
+        return "DT_PREINIT_ARRAYSZ";
+    case DT_GNU_HASH:
+        return "DT_GNU_HASH";
+    case DT_VERSYM:
+        return "DT_VERSYM";
+    case DT_RELACOUNT:
+        return "DT_RELACOUNT";
+    case DT_RELCOUNT:
+        return "DT_RELCOUNT";
+    case DT_FLAGS_1:
+        return "DT_FLAGS_1";
+    case DT_VERDEF:
+        return "DT_VERDEF";
+    case DT_VERDEFNUM:
+        return "DT_VERDEFNUM";
+    case DT_VERNEED:
+        return "DT_VERNEED";
+    case DT_VERNEEDNUM:
+        return "DT_VERNEEDNUM";
+    default:
+        if (tag >= DT_LOOS && tag <= DT_HIOS)
+            return "DT_OS";
+        else if (tag >= DT_LOPROC && tag <= DT_HIPROC)
+            return "DT_PROC";
+        else
+            return QString::fromStdString("DT_INVALID (" + Util::hexToString(tag) + ")");
+    }
+}
+
+QString Elf::parseString(const MemChunk& strings, uint64_t offset)
+{
+    unsigned int length;
+    const char* str = data::ElfSymbols::tableString(strings, offset, length);
+    return QString::fromUtf8(str, length);
+}
+
+
 QString Elf::parseHeaderData(unsigned char& data)
 {
     switch (data)
@@ -20,6 +20,7 @@
 #define TYREX_PARSE_ELF_HPP
 
 #include <QString>
+#include <vector>
 #include "elftraits.hpp"
 #include "parse/parser.tpl"
 #include "data/elf.hpp"
@@ -43,6 +44,10 @@ public:
 
     static QString parseSectionHeaderType(const uint32_t& type);
     static QString parseSectionHeaderFlags(const uint32_t& flags);
+
+    static QString parseDynamicTag(const int64_t& tag);
+    // string at offset in a string table ; empty if out of it
+    static QString parseString(const MemChunk& strings, uint64_t offset);
 };
 
 
@@ -59,6 +64,14 @@ private:
     static QStringList parseSegmentHeader(const typename Traits::phdr_type& phdr);
     static QStringList parseSectionHeader(const typename Traits::shdr_type& shdr);
 
+    // content of a section, or of the section it links to (its string table) ; a warning and false if out of the file
+    static bool sectionChunk(const MemChunk& chunk, const typename Traits::shdr_type& shdr, const char* context, MemChunk& result);
+    static bool linkedChunk(const MemChunk& chunk, const std::vector<typename Traits::shdr_type>& shdrs, const typename Traits::shdr_type& shdr, const char* context, MemChunk& result);
+
+    // a broken table is skipped with a warning (null symbols), the rest of the file is still decoded
+    std::shared_ptr<data::ElfSymbols> parseSymbols(const MemChunk& chunk, const std::vector<typename Traits::shdr_type>& shdrs, const typename Traits::shdr_type& shdr);
+    void parseDynamic(const MemChunk& chunk, const std::vector<typename Traits::shdr_type>& shdrs, const typename Traits::shdr_type& shdr, data::Table& dynamic);
+
     data::Colorizer mSrcColorizer;
 };
 
@@ -36,7 +36,7 @@ ParseElf<Traits>::ParseElf()
 template <typename Traits>
 void ParseElf<Traits>::onError(const MemChunk& chunk, std::shared_ptr<data::Elf>& data)
 {
-    data = std::make_shared<data::Elf>(chunk, mSrcColorizer, QList<QStringList>(), QList<QStringList>(), data::Table());
+    data = std::make_shared<data::Elf>(chunk, mSrcColorizer, QList<QStringList>(), QList<QStringList>(), data::Table(), data::Table(), std::vector<std::shared_ptr<data::ElfSymbols> >());
 }
 
 template <typename Traits>
@@ -116,6 +116,7 @@ void ParseElf<Traits>::doParse(const MemChunk& chunk, std::shared_ptr<data::Elf>
 
     // sections
     QList<QStringList> sectionsHeader;
+    std::vector<typename Traits::shdr_type> shdrs;
     for (unsigned int i = 0 ; i < header.header().e_shnum ; ++i)
     {
         typename Traits::shdr_type shdr;
@@ -125,9 +126,127 @@ void ParseElf<Traits>::doParse(const MemChunk& chunk, std::shared_ptr<data::Elf>
 
         std::memcpy(static_cast<void*>(&shdr), subchunk.data(), shentsize);
         sectionsHeader.append(parseSectionHeader(shdr));
+        shdrs.push_back(shdr);
     }
 
-    data = std::make_shared<data::Elf>(chunk, mSrcColorizer, segmentsHeader, sectionsHeader, properties);
+    // symbol tables and dynamic section
+    data::Table dynamic("Dynamic", QStringList() << "Tag" << "Value");
+    std::vector<std::shared_ptr<data::ElfSymbols> > symbols;
+    for (const typename Traits::shdr_type& shdr : shdrs)
+    {
+        if (shdr.sh_type == SHT_SYMTAB || shdr.sh_type == SHT_DYNSYM)
+        {
+            std::shared_ptr<data::ElfSymbols> table = this->parseSymbols(chunk, shdrs, shdr);
+            if (table)
+                symbols.push_back(table);
+        }
+        else if (shdr.sh_type == SHT_DYNAMIC)
+            this->parseDynamic(chunk, shdrs, shdr, dynamic);
+    }
+
+    data = std::make_shared<data::Elf>(chunk, mSrcColorizer, segmentsHeader, sectionsHeader, properties, dynamic, symbols);
+}
+
+
+template <typename Traits>
+bool ParseElf<Traits>::sectionChunk(const MemChunk& chunk, const typename Traits::shdr_type& shdr, const char* context, MemChunk& result)
+{
+    uint64_t size = chunk.size();
+    if (shdr.sh_offset > size || shdr.sh_size > size - shdr.sh_offset)
+    {
+        Except::reportWarning(size, context, "unexpected end of data, table skipped");
+        return false;
+    }
+    result = chunk.subChunk(shdr.sh_offset, shdr.sh_size);
+    return true;
+}
+
+template <typename Traits>
+bool ParseElf<Traits>::linkedChunk(const MemChunk& chunk, const std::vector<typename Traits::shdr_type>& shdrs, const typename Traits::shdr_type& shdr, const char* context, MemChunk& result)
+{
+    if (shdr.sh_link >= shdrs.size())
+    {
+        Except::reportWarning(shdr.sh_offset, context, "invalid string table index, table skipped");
+        return false;
+    }
+    return sectionChunk(chunk, shdrs[shdr.sh_link], context, result);
+}
+
+template <typename Traits>
+std::shared_ptr<data::ElfSymbols> ParseElf<Traits>::parseSymbols(const MemChunk& chunk, const std::vector<typename Traits::shdr_type>& shdrs, const typename Traits::shdr_type& shdr)
+{
+    MemChunk table;
+    MemChunk strings;
+    if (!sectionChunk(chunk, shdr, "elf, symbol table", table) || !linkedChunk(chunk, shdrs, shdr, "elf, symbol table, strings", strings))
+        return nullptr;
+
+    // compared on 64 bits : a larger entry size must not be truncated into a valid one
+    uint64_t entsize = shdr.sh_entsize;
+    if (entsize < sizeof(typename Traits::sym_type) || (table.size() && entsize > table.size()))
+    {
+        Except::reportWarning(shdr.sh_offset, "elf, symbol table", "invalid entry size, table skipped");
+        return nullptr;
+    }
+
+    mSrcColorizer.addHighlight(shdr.sh_offset, table.size(), QColor(0, 128, 255, 64));
+
+    unsigned int count = table.size() / entsize;
+    std::shared_ptr<data::ElfSymbols> symbols = std::make_shared<data::ElfSymbols>(shdr.sh_type == SHT_DYNSYM ? "Dynamic symbols" : "Symbols", strings, Traits::mBits / 4);
+    symbols->reserve(count);
+
+    const unsigned char* entries = table.data();
+    for (unsigned int i = 0 ; i < count ; ++i)
+    {
+        typename Traits::sym_type sym;
+        std::memcpy(static_cast<void*>(&sym), entries + i * entsize, sizeof(sym));
+        symbols->appendRow(sym.st_name, sym.st_value, sym.st_size, sym.st_info, sym.st_shndx);
+    }
+
+    symbols->buildIndexes();
+    return symbols;
+}
+
+template <typename Traits>
+void ParseElf<Traits>::parseDynamic(const MemChunk& chunk, const std::vector<typename Traits::shdr_type>& shdrs, const typename Traits::shdr_type& shdr, data::Table& dynamic)
+{
+    MemChunk table;
+    MemChunk strings;
+    if (!sectionChunk(chunk, shdr, "elf, dynamic section", table) || !linkedChunk(chunk, shdrs, shdr, "elf, dynamic section, strings", strings))
+        return;
+
+    // compared on 64 bits : a larger entry size must not be truncated into a valid one
+    uint64_t entsize = shdr.sh_entsize;
+    if (entsize < sizeof(typename Traits::dyn_type) || (table.size() && entsize > table.size()))
+    {
+        Except::reportWarning(shdr.sh_offset, "elf, dynamic section", "invalid entry size, table skipped");
+        return;
+    }
+
+    mSrcColorizer.addHighlight(shdr.sh_offset, table.size(), QColor(0, 255, 128, 64));
+
+    unsigned int count = table.size() / entsize;
+    const unsigned char* entries = table.data();
+    for (unsigned int i = 0 ; i < count ; ++i)
+    {
+        typename Traits::dyn_type dyn;
+        std::memcpy(static_cast<void*>(&dyn), entries + i * entsize, sizeof(dyn));
+        if (dyn.d_tag == DT_NULL)
+            break;
+
+        QString value;
+        switch (dyn.d_tag)
+        {
+        case DT_NEEDED:
+        case DT_SONAME:
+        case DT_RPATH:
+        case DT_RUNPATH:
+            value = Elf::parseString(strings, dyn.d_un.d_val);
+            break;
+        default:
+            value = "0x" + QString::number(dyn.d_un.d_val, 16);
+        }
+        dynamic.push(Elf::parseDynamicTag(dyn.d_tag), value);
+    }
 }
 
 
@@ -0,0 +1,238 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "resultcache.hpp"
+
+#include "misc/diskcache.hpp"
+#include "misc/hash/hash.hpp"
+#include "misc/util.hpp"
+
+#include <algorithm>
+
+namespace tyrex {
+namespace parse {
+
+// smaller inputs decode faster than the cache is read
+static const unsigned int minSize = 1 << 20;
+static const qint64 maxCacheSize = Q_INT64_C(4) << 30;
+static const quint32 magic = 0x54595243;
+// bump when the format of entries changes
+static const quint32 formatVersion = 1;
+// QDataStream reads and writes at most 2 GiB at a time
+static const unsigned int rawBlockSize = 1 << 30;
+
+
+ResultCache::ResultCache(const MemChunk& chunk, const QString& parameters) :
+    mChunk(chunk)
+{
+    // without a key, every load misses and stores are dropped : nothing is hashed while the cache is disabled
+    if (!DiskCache::enabled() || chunk.size() < minSize)
+        return;
+
+    QString name = parameters;
+    for (QChar& c : name)
+        if (!c.isLetterOrNumber())
+            c = QChar('_');
+
+    uint64_t hash = Hasher::getXXH64(chunk);
+    mKey = name + "-" + QString::fromStdString(Util::hexToString(static_cast<unsigned int>(hash >> 32), 8) + Util::hexToString(static_cast<unsigned int>(hash), 8) + Util::hexToString(chunk.size(), 8));
+}
+
+
+bool ResultCache::load(std::shared_ptr<data::Compress>& data) const
+{
+    QFile file;
+    QDataStream stream;
+    if (!this->open(file, stream))
+        return false;
+
+    data::Colorizer srcColorizer;
+    data::Colorizer decompColorizer;
+    MemChunk decomp;
+
+    srcColorizer.read(stream);
+    if (!ResultCache::readChunk(stream, decomp))
+        return false;
+    decompColorizer.read(stream);
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    data = std::make_shared<data::Compress>(mChunk, decomp, srcColorizer, decompColorizer);
+    return true;
+}
+
+bool ResultCache::load(std::shared_ptr<data::Archive>& data) const
+{
+    QFile file;
+    QDataStream stream;
+    if (!this->open(file, stream))
+        return false;
+
+    data::Colorizer srcColorizer;
+    data::FileInfoFilter filter;
+    data::ArchiveIndex index(data::ArchiveIndex::dosTime);
+
+    srcColorizer.read(stream);
+
+    quint32 infoCount;
+    stream >> infoCount;
+    for (quint32 i = 0 ; i < infoCount && stream.status() == QDataStream::Ok ; ++i)
+    {
+        quint32 info;
+        bool shown;
+        stream >> info >> shown;
+        if (info >= data::FileInfo::infoCount)
+            return false;
+        filter.mInfos.push_back(std::make_pair(static_cast<data::FileInfo::Info>(info), shown));
+    }
+
+    if (!index.read(stream))
+        return false;
+
+    quint32 fileCount;
+    stream >> fileCount;
+    if (stream.status() != QDataStream::Ok || fileCount > index.rowCount())
+        return false;
+
+    std::vector<data::File> files(fileCount);
+    for (data::File& file : files)
+    {
+        stream >> file.mRow;
+        if (file.mRow >= index.rowCount() || !ResultCache::readChunk(stream, file.mChunk))
+            return false;
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    data = std::make_shared<data::Archive>(mChunk, srcColorizer, filter, index, files);
+    return true;
+}
+
+
+void ResultCache::store(const data::Compress& data) const
+{
+    QFile file;
+    QDataStream stream;
+    if (!this->create(file, stream))
+        return;
+
+    data.source().colorizer().write(stream);
+    ResultCache::writeChunk(stream, data.decomp().chunk());
+    data.decomp().colorizer().write(stream);
+
+    this->commit(file, stream);
+}
+
+void ResultCache::store(const data::Archive& data) const
+{
+    QFile file;
+    QDataStream stream;
+    if (!this->create(file, stream))
+        return;
+
+    data.source().colorizer().write(stream);
+
+    const data::FileInfoFilter& filter = data.fileInfoFilter();
+    stream << static_cast<quint32>(filter.mInfos.size());
+    for (auto& info : filter.mInfos)
+        stream << static_cast<quint32>(info.first) << info.second;
+
+    data.index().write(stream);
+
+    stream << static_cast<quint32>(data.files().size());
+    for (const data::File& file : data.files())
+    {
+        stream << file.mRow;
+        ResultCache::writeChunk(stream, file.mChunk);
+    }
+
+    this->commit(file, stream);
+}
+
+
+bool ResultCache::open(QFile& file, QDataStream& stream) const
+{
+    if (mKey.isEmpty() || !DiskCache("results").open(mKey, file))
+        return false;
+
+    stream.setDevice(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+
+    quint32 fileMagic;
+    quint32 version;
+    quint32 size;
+    stream >> fileMagic >> version >> size;
+
+    // a hash collision is unlikely, a different size even less
+    return stream.status() == QDataStream::Ok && fileMagic == magic && version == formatVersion && size == mChunk.size();
+}
+
+bool ResultCache::create(QFile& file, QDataStream& stream) const
+{
+    if (mKey.isEmpty() || !DiskCache("results").create(mKey, file))
+        return false;
+
+    stream.setDevice(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << magic << formatVersion << mChunk.size();
+    return true;
+}
+
+void ResultCache::commit(QFile& file, QDataStream& stream) const
+{
+    DiskCache cache("results");
+    cache.commit(mKey, file, stream.status() == QDataStream::Ok);
+    cache.trim(maxCacheSize);
+}
+
+
+void ResultCache::writeChunk(QDataStream& stream, const MemChunk& chunk)
+{
+    unsigned int size = chunk.size();
+    stream << size;
+
+    for (unsigned int pos = 0 ; pos < size ; pos += rawBlockSize)
+    {
+        int length = std::min(size - pos, rawBlockSize);
+        if (stream.writeRawData(reinterpret_cast<const char*>(chunk.data()) + pos, length) != length)
+            stream.setStatus(QDataStream::WriteFailed);
+    }
+}
+
+bool ResultCache::readChunk(QDataStream& stream, MemChunk& chunk)
+{
+    unsigned int size;
+    stream >> size;
+    if (stream.status() != QDataStream::Ok || size > stream.device()->bytesAvailable())
+        return false;
+
+    chunk = MemChunk(size);
+    for (unsigned int pos = 0 ; pos < size ; pos += rawBlockSize)
+    {
+        int length = std::min(size - pos, rawBlockSize);
+        if (stream.readRawData(reinterpret_cast<char*>(&chunk[pos]), length) != length)
+            return false;
+    }
+
+    return true;
+}
+
+}
+}
@@ -0,0 +1,59 @@
+/*
+    Tyrex - the versatile file decoder.
+    Copyright (C) 2014 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TYREX_PARSE_RESULTCACHE_HPP
+#define TYREX_PARSE_RESULTCACHE_HPP
+
+#include "data/archive.hpp"
+#include "data/compress.hpp"
+#include <QDataStream>
+
+namespace tyrex {
+namespace parse {
+
+// Results of slow parsers (decompressed data, archive members) saved in the disk cache,
+// so that reopening the same input skips decoding (only while DiskCache is enabled).
+// The key is a hash of the input and of the parser parameters, e.g. "compress/deflate 32768".
+// Entries are not compressed : chunks are read back in a single pass, straight into their buffer.
+class ResultCache
+{
+public:
+    ResultCache(const MemChunk& chunk, const QString& parameters);
+
+    bool load(std::shared_ptr<data::Compress>& data) const;
+    bool load(std::shared_ptr<data::Archive>& data) const;
+
+    void store(const data::Compress& data) const;
+    void store(const data::Archive& data) const;
+
+private:
+    bool open(QFile& file, QDataStream& stream) const;
+    bool create(QFile& file, QDataStream& stream) const;
+    void commit(QFile& file, QDataStream& stream) const;
+
+    static void writeChunk(QDataStream& stream, const MemChunk& chunk);
+    static bool readChunk(QDataStream& stream, MemChunk& chunk);
+
+    MemChunk mChunk;
+    QString mKey;
+};
+
+}
+}
+
+#endif // TYREX_PARSE_RESULTCACHE_HPP
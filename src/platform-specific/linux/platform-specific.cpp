@@ -18,6 +18,8 @@
 
 #include "platform-specific/platform-specific.hpp"
 
+#include <QDir>
+
 namespace tyrex {
 
 const QString PlatformSpecific::fontName("monospace");
@@ -29,4 +31,12 @@ QFont PlatformSpecific::font()
     return result;
 }
 
+QString PlatformSpecific::cacheDirectory()
+{
+    QString base = QString::fromLocal8Bit(qgetenv("XDG_CACHE_HOME"));
+    if (base.isEmpty())
+        base = QDir::homePath() + "/.cache";
+    return base + "/tyrex";
+}
+
 }
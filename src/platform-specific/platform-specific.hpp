@@ -29,6 +29,8 @@ class PlatformSpecific
 {
 public:
     static QFont font();
+    // where files kept between sessions go (see DiskCache)
+    static QString cacheDirectory();
 
 private:
     static const QString fontName;
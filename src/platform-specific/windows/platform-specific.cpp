@@ -18,6 +18,8 @@
 
 #include "platform-specific/platform-specific.hpp"
 
+#include <QDir>
+
 namespace tyrex {
 
 const QString PlatformSpecific::fontName("Courier");
@@ -29,4 +31,12 @@ QFont PlatformSpecific::font()
     return result;
 }
 
+QString PlatformSpecific::cacheDirectory()
+{
+    QString base = QDir::fromNativeSeparators(QString::fromLocal8Bit(qgetenv("LOCALAPPDATA")));
+    if (base.isEmpty())
+        base = QDir::homePath() + "/AppData/Local";
+    return base + "/tyrex/cache";
+}
+
 }
@@ -0,0 +1,240 @@
+#   Tyrex - the versatile file decoder.
+#   Copyright (C) 2014 - 2015  G. Endignoux
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+
+
+# Sources shared by the application and the benchmark target.
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/data/archive.hpp \
+    $$PWD/data/archiveindex.hpp \
+    $$PWD/data/bytesequence.hpp \
+    $$PWD/data/carving.hpp \
+    $$PWD/data/colorizer.hpp \
+    $$PWD/data/compress.hpp \
+    $$PWD/data/data.hpp \
+    $$PWD/data/datatree.hpp \
+    $$PWD/data/elf.hpp \
+    $$PWD/data/elfsymbols.hpp \
+    $$PWD/data/file.hpp \
+    $$PWD/data/fileinfo.hpp \
+    $$PWD/data/font/font.hpp \
+    $$PWD/data/font/path.hpp \
+    $$PWD/data/image.hpp \
+    $$PWD/data/image/color.hpp \
+    $$PWD/data/image/pixmap.hpp \
+    $$PWD/data/image/pixmapprogress.hpp \
+    $$PWD/data/javaclass.hpp \
+    $$PWD/data/table.hpp \
+    $$PWD/external/elf.h \
+    $$PWD/graphic/actionset.hpp \
+    $$PWD/graphic/area/area.hpp \
+    $$PWD/graphic/area/hexarea.hpp \
+    $$PWD/graphic/area/treearea.hpp \
+    $$PWD/graphic/console.hpp \
+    $$PWD/graphic/dialog/consoledialog.hpp \
+    $$PWD/graphic/dialog/hexfinddialog.hpp \
+    $$PWD/graphic/dialog/inputdialog.hpp \
+    $$PWD/graphic/dialog/typeselector.hpp \
+    $$PWD/graphic/document.hpp \
+    $$PWD/graphic/mainwindow.hpp \
+    $$PWD/graphic/sidetree.hpp \
+    $$PWD/graphic/treeitemmodel.hpp \
+    $$PWD/graphic/treeitemmodel.tpl \
+    $$PWD/graphic/treemodel.hpp \
+    $$PWD/graphic/util/entropystrip.hpp \
+    $$PWD/graphic/util/glyphatlas.hpp \
+    $$PWD/graphic/util/imagetiles.hpp \
+    $$PWD/graphic/util/listwidget.hpp \
+    $$PWD/graphic/util/treewidget.hpp \
+    $$PWD/graphic/view/archivemodel.hpp \
+    $$PWD/graphic/view/archiveview.hpp \
+    $$PWD/graphic/view/elfsymbolmodel.hpp \
+    $$PWD/graphic/view/elfsymbolview.hpp \
+    $$PWD/graphic/view/fontview.hpp \
+    $$PWD/graphic/view/hexview.hpp \
+    $$PWD/graphic/view/imageview.hpp \
+    $$PWD/graphic/view/pathview.hpp \
+    $$PWD/graphic/view/scrollview.hpp \
+    $$PWD/graphic/view/tableview.hpp \
+    $$PWD/graphic/view/treeview.hpp \
+    $$PWD/graphic/view/view.hpp \
+    $$PWD/graphic/viewfactory.hpp \
+    $$PWD/misc/arena.hpp \
+    $$PWD/misc/bytestats.hpp \
+    $$PWD/misc/chunk.hpp \
+    $$PWD/misc/chunk.tpl \
+    $$PWD/misc/chunkbuffer.hpp \
+    $$PWD/misc/diskcache.hpp \
+    $$PWD/misc/hash/hash.hpp \
+    $$PWD/misc/hash/sha256.hpp \
+    $$PWD/misc/memchunk.hpp \
+    $$PWD/misc/memrope.hpp \
+    $$PWD/misc/multimatcher.hpp \
+    $$PWD/misc/profiler.hpp \
+    $$PWD/misc/tree.hpp \
+    $$PWD/misc/tree.tpl \
+    $$PWD/misc/util.hpp \
+    $$PWD/parse/archive/tar.hpp \
+    $$PWD/parse/archive/tarfile.hpp \
+    $$PWD/parse/archive/tarindex.hpp \
+    $$PWD/parse/archive/tarreader.hpp \
+    $$PWD/parse/archive/zip.hpp \
+    $$PWD/parse/archive/zipfile.hpp \
+    $$PWD/parse/carver.hpp \
+    $$PWD/parse/compress/bitstream.hpp \
+    $$PWD/parse/compress/bzip2.hpp \
+    $$PWD/parse/compress/deflate/deflate.hpp \
+    $$PWD/parse/compress/deflate/deflatestream.hpp \
+    $$PWD/parse/compress/deflate/gzip.hpp \
+    $$PWD/parse/compress/deflate/zlib.hpp \
+    $$PWD/parse/compress/forwardstream.hpp \
+    $$PWD/parse/compress/huffmantree.hpp \
+    $$PWD/parse/compress/lz.hpp \
+    $$PWD/parse/compress/lzma/lzma.hpp \
+    $$PWD/parse/compress/lzma/lzmabittree.hpp \
+    $$PWD/parse/compress/lzma/lzmadecoder.hpp \
+    $$PWD/parse/compress/lzma/lzmalendecoder.hpp \
+    $$PWD/parse/compress/lzma/lzmastream.hpp \
+    $$PWD/parse/compress/lzma/lzma2.hpp \
+    $$PWD/parse/compress/lzma/xz.hpp \
+    $$PWD/parse/compress/lzw.hpp \
+    $$PWD/parse/compress/movetofront.hpp \
+    $$PWD/parse/compress/parsecompress.hpp \
+    $$PWD/parse/font/truetype.hpp \
+    $$PWD/parse/image/png.hpp \
+    $$PWD/parse/image/pngfilter.hpp \
+    $$PWD/parse/nestedparser.hpp \
+    $$PWD/parse/parsedocument.hpp \
+    $$PWD/parse/parseexception.hpp \
+    $$PWD/parse/parser.hpp \
+    $$PWD/parse/parser.tpl \
+    $$PWD/parse/program/elfheader.hpp \
+    $$PWD/parse/program/elftraits.hpp \
+    $$PWD/parse/program/elftraits.tpl \
+    $$PWD/parse/program/parseelf.hpp \
+    $$PWD/parse/program/parseelf.tpl \
+    $$PWD/parse/program/parsejavaclass.hpp \
+    $$PWD/parse/resultcache.hpp \
+    $$PWD/platform-specific/platform-specific.hpp \
+
+SOURCES += \
+    $$PWD/data/archive.cpp \
+    $$PWD/data/archiveindex.cpp \
+    $$PWD/data/bytesequence.cpp \
+    $$PWD/data/carving.cpp \
+    $$PWD/data/colorizer.cpp \
+    $$PWD/data/compress.cpp \
+    $$PWD/data/data.cpp \
+    $$PWD/data/datatree.cpp \
+    $$PWD/data/elf.cpp \
+    $$PWD/data/elfsymbols.cpp \
+    $$PWD/data/file.cpp \
+    $$PWD/data/fileinfo.cpp \
+    $$PWD/data/font/font.cpp \
+    $$PWD/data/font/path.cpp \
+    $$PWD/data/image.cpp \
+    $$PWD/data/image/pixmap.cpp \
+    $$PWD/data/image/pixmapprogress.cpp \
+    $$PWD/data/javaclass.cpp \
+    $$PWD/data/table.cpp \
+    $$PWD/graphic/area/area.cpp \
+    $$PWD/graphic/area/hexarea.cpp \
+    $$PWD/graphic/area/treearea.cpp \
+    $$PWD/graphic/console.cpp \
+    $$PWD/graphic/dialog/consoledialog.cpp \
+    $$PWD/graphic/dialog/hexfinddialog.cpp \
+    $$PWD/graphic/dialog/inputdialog.cpp \
+    $$PWD/graphic/dialog/typeselector.cpp \
+    $$PWD/graphic/document.cpp \
+    $$PWD/graphic/mainwindow.cpp \
+    $$PWD/graphic/sidetree.cpp \
+    $$PWD/graphic/treemodel.cpp \
+    $$PWD/graphic/util/entropystrip.cpp \
+    $$PWD/graphic/util/glyphatlas.cpp \
+    $$PWD/graphic/util/imagetiles.cpp \
+    $$PWD/graphic/util/listwidget.cpp \
+    $$PWD/graphic/util/treewidget.cpp \
+    $$PWD/graphic/view/archivemodel.cpp \
+    $$PWD/graphic/view/archiveview.cpp \
+    $$PWD/graphic/view/elfsymbolmodel.cpp \
+    $$PWD/graphic/view/elfsymbolview.cpp \
+    $$PWD/graphic/view/fontview.cpp \
+    $$PWD/graphic/view/hexview.cpp \
+    $$PWD/graphic/view/imageview.cpp \
+    $$PWD/graphic/view/pathview.cpp \
+    $$PWD/graphic/view/scrollview.cpp \
+    $$PWD/graphic/view/tableview.cpp \
+    $$PWD/graphic/view/treeview.cpp \
+    $$PWD/graphic/view/view.cpp \
+    $$PWD/graphic/viewfactory.cpp \
+    $$PWD/misc/arena.cpp \
+    $$PWD/misc/bytestats.cpp \
+    $$PWD/misc/diskcache.cpp \
+    $$PWD/misc/hash/hash.cpp \
+    $$PWD/misc/hash/sha256.cpp \
+    $$PWD/misc/memchunk.cpp \
+    $$PWD/misc/memrope.cpp \
+    $$PWD/misc/multimatcher.cpp \
+    $$PWD/misc/profiler.cpp \
+    $$PWD/misc/util.cpp \
+    $$PWD/parse/archive/tar.cpp \
+    $$PWD/parse/archive/tarfile.cpp \
+    $$PWD/parse/archive/tarindex.cpp \
+    $$PWD/parse/archive/tarreader.cpp \
+    $$PWD/parse/archive/zip.cpp \
+    $$PWD/parse/archive/zipfile.cpp \
+    $$PWD/parse/carver.cpp \
+    $$PWD/parse/compress/bzip2.cpp \
+    $$PWD/parse/compress/deflate/deflate.cpp \
+    $$PWD/parse/compress/deflate/deflatestream.cpp \
+    $$PWD/parse/compress/deflate/gzip.cpp \
+    $$PWD/parse/compress/deflate/zlib.cpp \
+    $$PWD/parse/compress/forwardstream.cpp \
+    $$PWD/parse/compress/huffmantree.cpp \
+    $$PWD/parse/compress/lz.cpp \
+    $$PWD/parse/compress/lzma/lzma.cpp \
+    $$PWD/parse/compress/lzma/lzmabittree.cpp \
+    $$PWD/parse/compress/lzma/lzmadecoder.cpp \
+    $$PWD/parse/compress/lzma/lzmalendecoder.cpp \
+    $$PWD/parse/compress/lzma/lzmastream.cpp \
+    $$PWD/parse/compress/lzma/lzma2.cpp \
+    $$PWD/parse/compress/lzma/xz.cpp \
+    $$PWD/parse/compress/lzw.cpp \
+    $$PWD/parse/compress/movetofront.cpp \
+    $$PWD/parse/compress/parsecompress.cpp \
+    $$PWD/parse/font/truetype.cpp \
+    $$PWD/parse/image/png.cpp \
+    $$PWD/parse/image/pngfilter.cpp \
+    $$PWD/parse/nestedparser.cpp \
+    $$PWD/parse/parsedocument.cpp \
+    $$PWD/parse/parseexception.cpp \
+    $$PWD/parse/program/elfheader.cpp \
+    $$PWD/parse/program/parseelf.cpp \
+    $$PWD/parse/program/parsejavaclass.cpp \
+    $$PWD/parse/resultcache.cpp \
+
+unix:{
+SOURCES += $$PWD/platform-specific/linux/platform-specific.cpp
+}
+
+win32:{
+SOURCES += $$PWD/platform-specific/windows/platform-specific.cpp
+}
+
+RESOURCES += \
+    $$PWD/ressources.qrc